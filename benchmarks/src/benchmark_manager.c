@@ -0,0 +1,63 @@
+#include "benchmark_manager.h"
+
+#include <containers/darray.h>
+#include <core/logger.h>
+#include <core/clock.h>
+
+#include "memory/linear_allocator.h"
+
+typedef struct benchmark_entry {
+    PFN_benchmark func;
+    char* desc;
+} benchmark_entry;
+
+static benchmark_entry* benchmarks;
+
+static linear_allocator systems_allocator;
+static u64 logging_system_memory_requirement;
+static void* logging_system_state;
+
+void benchmark_manager_init() {
+    linear_allocator_create(1024 * 1024, 0, &systems_allocator);
+
+    initialize_logging(&logging_system_memory_requirement, 0);
+    logging_system_state = linear_allocator_allocate(&systems_allocator, logging_system_memory_requirement);
+    if (!initialize_logging(&logging_system_memory_requirement, logging_system_state)) {
+        LOG_FATAL("Failed to initialize logging system! Shutting down.");
+        return;
+    }
+    benchmarks = darray_create(benchmark_entry);
+}
+
+void benchmark_manager_register(PFN_benchmark func, char* desc) {
+    benchmark_entry e;
+    e.func = func;
+    e.desc = desc;
+    darray_push(benchmarks, e);
+}
+
+void benchmark_manager_run() {
+    u32 count = darray_length(benchmarks);
+
+    clock total_time;
+    clock_start(&total_time);
+
+    for (u32 i = 0; i < count; ++i) {
+        LOG_INFO("--- %s ---", benchmarks[i].desc);
+
+        clock bench_time;
+        clock_start(&bench_time);
+        benchmarks[i].func();
+        clock_update(&bench_time);
+
+        LOG_INFO("Finished %d of %d in %.6f sec", i + 1, count, bench_time.elasped_time);
+    }
+
+    clock_update(&total_time);
+    LOG_INFO("Ran %d benchmarks in %.6f sec", count, total_time.elasped_time);
+}
+
+void benchmark_report(const char* label, u64 iterations, f64 elapsed_seconds) {
+    f64 ns_per_op = iterations ? (elapsed_seconds * 1e9) / (f64)iterations : 0.0;
+    LOG_INFO("  %-40s %12llu ops  %10.3f ns/op", label, iterations, ns_per_op);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <define.h>
+
+typedef void (*PFN_benchmark)();
+
+void benchmark_manager_init();
+
+void benchmark_manager_register(PFN_benchmark, char* desc);
+
+void benchmark_manager_run();
+
+/**
+ * Log the result of a measured loop
+ * @param label what was measured
+ * @param iterations number of operations executed during the measure
+ * @param elapsed_seconds total time spent executing the operations
+ */
+void benchmark_report(const char* label, u64 iterations, f64 elapsed_seconds);
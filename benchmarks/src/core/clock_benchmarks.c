@@ -0,0 +1,43 @@
+#include "clock_benchmarks.h"
+
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+
+#define CLOCK_BENCHMARK_READ_COUNT 1000000
+
+void benchmark_clock_read_cost() {
+    // keep the reads alive
+    volatile u64 sink = 0;
+    // the benchmarks don't initialize the platform, which calibrates the ticks
+    platform_ticks_calibrate();
+
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < CLOCK_BENCHMARK_READ_COUNT; ++i) {
+        sink += (u64)platform_get_absolute_time();
+    }
+    f64 absolute_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < CLOCK_BENCHMARK_READ_COUNT; ++i) {
+        sink += platform_get_ticks();
+    }
+    f64 ticks_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < CLOCK_BENCHMARK_READ_COUNT; ++i) {
+        sink += platform_get_ticks_ordered();
+    }
+    f64 ordered_time = platform_get_absolute_time() - start;
+
+    printf("tick source: %s, %llu ticks per second\n",
+           platform_ticks_use_tsc() ? "time stamp counter" : "CLOCK_MONOTONIC", platform_get_tick_frequency());
+    benchmark_report("platform_get_absolute_time", CLOCK_BENCHMARK_READ_COUNT, absolute_time);
+    benchmark_report("platform_get_ticks", CLOCK_BENCHMARK_READ_COUNT, ticks_time);
+    benchmark_report("platform_get_ticks_ordered", CLOCK_BENCHMARK_READ_COUNT, ordered_time);
+}
+
+void clock_register_benchmarks() {
+    benchmark_manager_register(benchmark_clock_read_cost, "Clock read cost");
+}
@@ -0,0 +1,55 @@
+#include "event_benchmarks.h"
+
+#include <core/event.h>
+#include <core/cmemory.h>
+#include <core/cstring.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#define EVENT_BENCHMARK_FIRE_COUNT 1000000
+
+static volatile u64 listener_hits;
+
+static b8 on_benchmark_event(u16 code, void* sender, void* listener_inst, event_context data) {
+    listener_hits++;
+    return false;
+}
+
+static void benchmark_fire_with_listeners(u32 listener_count) {
+    u64 state_size = 0;
+    initialize_event(&state_size, 0);
+    void* state = callocate(state_size, MEMORY_TAG_APPLICATION);
+    initialize_event(&state_size, state);
+
+    // the listener pointer only has to be unique
+    u8 listeners[100];
+    for (u32 i = 0; i < listener_count; ++i) {
+        event_register(EVENT_CODE_MOUSE_MOVED, &listeners[i], on_benchmark_event);
+    }
+
+    event_context context = {};
+    listener_hits = 0;
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < EVENT_BENCHMARK_FIRE_COUNT; ++i) {
+        context.data.i16[0] = (i16)i;
+        event_fire(EVENT_CODE_MOUSE_MOVED, 0, context);
+    }
+    f64 elapsed = platform_get_absolute_time() - start;
+
+    char label[64];
+    string_format(label, "event_fire, %u listener(s)", listener_count);
+    benchmark_report(label, EVENT_BENCHMARK_FIRE_COUNT, elapsed);
+
+    event_shutdown();
+    cfree(state, state_size, MEMORY_TAG_APPLICATION);
+}
+
+void benchmark_event_fire() {
+    benchmark_fire_with_listeners(1);
+    benchmark_fire_with_listeners(10);
+    benchmark_fire_with_listeners(100);
+}
+
+void event_register_benchmarks() {
+    benchmark_manager_register(benchmark_event_fire, "Event fire cost with 1, 10 and 100 listeners");
+}
@@ -0,0 +1,49 @@
+#include "logger_benchmarks.h"
+
+#include <core/logger.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+
+#define LOGGER_BENCHMARK_MESSAGE_COUNT 10000
+
+static f64 log_burst() {
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < LOGGER_BENCHMARK_MESSAGE_COUNT; ++i) {
+        LOG_TRACE("benchmark message %u: position (%.3f, %.3f)", i, i * 0.5f, i * 0.25f);
+    }
+    return platform_get_absolute_time() - start;
+}
+
+static f64 log_binary_burst() {
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < LOGGER_BENCHMARK_MESSAGE_COUNT; ++i) {
+        LOG_TRACE_BIN("benchmark message %u: position (%.3f, %.3f)", i, i * 0.5f, i * 0.25f);
+    }
+    return platform_get_absolute_time() - start;
+}
+
+void benchmark_logger_burst() {
+    // time seen by the logging thread only
+    f64 sync_time = log_burst();
+
+    logging_start_async(16384);
+    f64 async_time = log_burst();
+    logging_flush();
+
+    // deferred format: only the arguments go through the ring
+    logging_binary_open("benchmark.clog");
+    f64 binary_time = log_binary_burst();
+    logging_binary_close();
+    logging_stop_async();
+    remove("benchmark.clog");
+
+    benchmark_report("LOG_TRACE burst, synchronous", LOGGER_BENCHMARK_MESSAGE_COUNT, sync_time);
+    benchmark_report("LOG_TRACE burst, async ring", LOGGER_BENCHMARK_MESSAGE_COUNT, async_time);
+    benchmark_report("LOG_TRACE_BIN burst, async ring", LOGGER_BENCHMARK_MESSAGE_COUNT, binary_time);
+}
+
+void logger_register_benchmarks() {
+    benchmark_manager_register(benchmark_logger_burst, "Logger burst cost on the calling thread");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void logger_register_benchmarks();
@@ -0,0 +1,97 @@
+#include "text_reader_benchmarks.h"
+
+#include <core/text_reader.h>
+#include <core/cstring.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+
+#define TEXT_READER_BENCHMARK_PATH "text_reader_benchmark.cmat"
+#define TEXT_READER_BENCHMARK_LINE_COUNT 200000
+
+static b8 write_benchmark_file() {
+    file_handle file;
+    if (!filesystem_open(TEXT_READER_BENCHMARK_PATH, FILE_MODE_WRITE, false, &file)) {
+        return false;
+    }
+    char line[128];
+    for (u32 i = 0; i < TEXT_READER_BENCHMARK_LINE_COUNT; ++i) {
+        string_format(line, "  diffuse_color_%u = %.2f %.2f %.2f 1.0", i, i * 0.5f, i * 0.25f, i * 0.125f);
+        filesystem_write_line(&file, line);
+    }
+    filesystem_close(&file);
+    return true;
+}
+
+// the previous loader pattern: one fgets per line, then trim and copy the key
+static f64 parse_with_read_line(u64* out_key_bytes) {
+    f64 start = platform_get_absolute_time();
+    file_handle file;
+    filesystem_open(TEXT_READER_BENCHMARK_PATH, FILE_MODE_READ, false, &file);
+    char line_buffer[1024] = "";
+    char* p = &line_buffer[0];
+    u64 line_length = 0;
+    u64 key_bytes = 0;
+    while (filesystem_read_line(&file, 1023, &p, &line_length)) {
+        char* trimmed = string_trim(line_buffer);
+        i32 equal_index = string_index_of(trimmed, '=');
+        if (equal_index != -1) {
+            char raw_var_name[64] = "";
+            string_mid(raw_var_name, trimmed, 0, equal_index);
+            key_bytes += string_length(string_trim(raw_var_name));
+        }
+    }
+    filesystem_close(&file);
+    *out_key_bytes = key_bytes;
+    return platform_get_absolute_time() - start;
+}
+
+static f64 parse_with_text_reader(b8 mapped, u64* out_key_bytes) {
+    f64 start = platform_get_absolute_time();
+    text_reader reader;
+    if (mapped) {
+        text_reader_open(TEXT_READER_BENCHMARK_PATH, &reader);
+    } else {
+        text_reader_open_buffered(TEXT_READER_BENCHMARK_PATH, TEXT_READER_DEFAULT_BLOCK_SIZE, &reader);
+    }
+    text_slice line;
+    u64 key_bytes = 0;
+    while (text_reader_next_line(&reader, &line)) {
+        text_slice key;
+        text_slice value;
+        if (text_slice_split(text_slice_trim(line), '=', &key, &value)) {
+            key_bytes += text_slice_trim(key).length;
+        }
+    }
+    text_reader_close(&reader);
+    *out_key_bytes = key_bytes;
+    return platform_get_absolute_time() - start;
+}
+
+void benchmark_text_reader_parse() {
+    if (!write_benchmark_file()) {
+        return;
+    }
+
+    u64 read_line_keys = 0;
+    u64 buffered_keys = 0;
+    u64 mapped_keys = 0;
+    f64 read_line_time = parse_with_read_line(&read_line_keys);
+    f64 buffered_time = parse_with_text_reader(false, &buffered_keys);
+    f64 mapped_time = parse_with_text_reader(true, &mapped_keys);
+    remove(TEXT_READER_BENCHMARK_PATH);
+
+    if (read_line_keys != buffered_keys || read_line_keys != mapped_keys) {
+        printf("text reader benchmark: the parsers disagree (%llu, %llu, %llu key bytes)\n",
+               read_line_keys, buffered_keys, mapped_keys);
+    }
+
+    benchmark_report("key = value lines, filesystem_read_line + trim/mid", TEXT_READER_BENCHMARK_LINE_COUNT, read_line_time);
+    benchmark_report("key = value lines, text reader blocks", TEXT_READER_BENCHMARK_LINE_COUNT, buffered_time);
+    benchmark_report("key = value lines, text reader mapped", TEXT_READER_BENCHMARK_LINE_COUNT, mapped_time);
+}
+
+void text_reader_register_benchmarks() {
+    benchmark_manager_register(benchmark_text_reader_parse, "Text reader line parsing");
+}
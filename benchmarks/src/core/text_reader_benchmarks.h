@@ -0,0 +1,3 @@
+#pragma once
+
+void text_reader_register_benchmarks();
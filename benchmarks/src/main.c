@@ -0,0 +1,36 @@
+#include "benchmark_manager.h"
+#include "core/event_benchmarks.h"
+#include "core/logger_benchmarks.h"
+#include "core/text_reader_benchmarks.h"
+#include "core/clock_benchmarks.h"
+#include "math/cmath_benchmarks.h"
+#include "math/transform_batch_benchmarks.h"
+#include "math/fast_trig_benchmarks.h"
+#include "math/crandom_benchmarks.h"
+#include "math/frustum_benchmarks.h"
+#include "math/bounds_benchmarks.h"
+#include "math/bvh_benchmarks.h"
+
+#include <core/logger.h>
+
+int main() {
+    benchmark_manager_init();
+
+    event_register_benchmarks();
+    logger_register_benchmarks();
+    text_reader_register_benchmarks();
+    clock_register_benchmarks();
+    cmath_register_benchmarks();
+    transform_batch_register_benchmarks();
+    fast_trig_register_benchmarks();
+    crandom_register_benchmarks();
+    frustum_register_benchmarks();
+    bounds_register_benchmarks();
+    bvh_register_benchmarks();
+
+    LOG_INFO("Starting benchmarks...");
+
+    benchmark_manager_run();
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "bounds_benchmarks.h"
+
+#include <math/cmath.h>
+#include <math/bounds.h>
+#include <math/crandom.h>
+#include <core/cmemory.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+
+#define BOUNDS_BENCHMARK_VERTEX_COUNT 1000000
+#define BOUNDS_BENCHMARK_ITERATIONS 10
+
+void benchmark_bounds_from_vertices() {
+    const u32 count = BOUNDS_BENCHMARK_VERTEX_COUNT;
+    vertex_3d* vertices = callocate(sizeof(vertex_3d) * count, MEMORY_TAG_ARRAY);
+    random_state state;
+    random_seed(&state, 1000000);
+    for (u32 i = 0; i < count; ++i) {
+        vertices[i].position.x = random_range_f32(&state, -10.0f, 10.0f);
+        vertices[i].position.y = random_range_f32(&state, -10.0f, 10.0f);
+        vertices[i].position.z = random_range_f32(&state, -10.0f, 10.0f);
+    }
+
+    // a plain loop over the positions, the same work without SIMD
+    extents_3d loop_extents;
+    f64 start = platform_get_absolute_time();
+    for (u32 n = 0; n < BOUNDS_BENCHMARK_ITERATIONS; ++n) {
+        loop_extents.min = vertices[0].position;
+        loop_extents.max = vertices[0].position;
+        for (u32 i = 1; i < count; ++i) {
+            for (u32 k = 0; k < 3; ++k) {
+                f32 v = vertices[i].position.elements[k];
+                loop_extents.min.elements[k] = v < loop_extents.min.elements[k] ? v : loop_extents.min.elements[k];
+                loop_extents.max.elements[k] = v > loop_extents.max.elements[k] ? v : loop_extents.max.elements[k];
+            }
+        }
+    }
+    f64 loop_time = platform_get_absolute_time() - start;
+
+    extents_3d extents;
+    start = platform_get_absolute_time();
+    for (u32 n = 0; n < BOUNDS_BENCHMARK_ITERATIONS; ++n) {
+        bounds_from_vertices(vertices, count, &extents, 0);
+    }
+    f64 extents_time = platform_get_absolute_time() - start;
+
+    sphere_3d sphere;
+    start = platform_get_absolute_time();
+    for (u32 n = 0; n < BOUNDS_BENCHMARK_ITERATIONS; ++n) {
+        bounds_from_vertices(vertices, count, &extents, &sphere);
+    }
+    f64 sphere_time = platform_get_absolute_time() - start;
+
+    printf("%u vertices, box %f %f, sphere radius %f\n", count, loop_extents.min.x, extents.min.x, sphere.radius);
+    u64 operations = (u64)count * BOUNDS_BENCHMARK_ITERATIONS;
+    benchmark_report("min/max loop", operations, loop_time);
+    benchmark_report("bounds_from_vertices, box", operations, extents_time);
+    benchmark_report("bounds_from_vertices, box and sphere", operations, sphere_time);
+
+    cfree(vertices, sizeof(vertex_3d) * count, MEMORY_TAG_ARRAY);
+}
+
+void bounds_register_benchmarks() {
+    benchmark_manager_register(benchmark_bounds_from_vertices, "Bounds of vertices");
+}
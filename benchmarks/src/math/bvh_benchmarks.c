@@ -0,0 +1,119 @@
+#include "bvh_benchmarks.h"
+
+#include <math/cmath.h>
+#include <math/bvh.h>
+#include <math/crandom.h>
+#include <math/frustum.h>
+#include <core/cmemory.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+
+#define BVH_BENCHMARK_OBJECT_COUNT 100000
+#define BVH_BENCHMARK_FRAMES 20
+#define BVH_BENCHMARK_RAY_COUNT 10000
+
+static b8 count_visible(u32 proxy, u64 user_data, void* context) {
+    (*(u32*)context)++;
+    return true;
+}
+
+static f32 count_hits(u32 proxy, u64 user_data, f32 max_distance, void* context) {
+    (*(u32*)context)++;
+    return max_distance;
+}
+
+void benchmark_bvh() {
+    const u32 count = BVH_BENCHMARK_OBJECT_COUNT;
+    // 6 arrays of count floats and the visible indices
+    u64 memory_size = sizeof(f32) * count * 7;
+    f32* memory = callocate(memory_size, MEMORY_TAG_ARRAY);
+    f32* center_x = memory;
+    f32* center_y = center_x + count;
+    f32* center_z = center_y + count;
+    f32* extent_x = center_z + count;
+    f32* extent_y = extent_x + count;
+    f32* extent_z = extent_y + count;
+    u32* visible = (u32*)(extent_z + count);
+
+    // the same scene as the frustum culling benchmark
+    random_state state;
+    random_seed(&state, 100000);
+    random_fill_f32(&state, center_x, count, -500.0f, 500.0f);
+    random_fill_f32(&state, center_y, count, -50.0f, 50.0f);
+    random_fill_f32(&state, center_z, count, -500.0f, 500.0f);
+    random_fill_f32(&state, extent_x, count, 0.5f, 4.0f);
+    random_fill_f32(&state, extent_y, count, 0.5f, 4.0f);
+    random_fill_f32(&state, extent_z, count, 0.5f, 4.0f);
+
+    bvh tree;
+    bvh_create(count, 0.5f, &tree);
+    u32* proxies = callocate(sizeof(u32) * count, MEMORY_TAG_ARRAY);
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < count; ++i) {
+        vec3 center = {{center_x[i], center_y[i], center_z[i]}};
+        vec3 half_extent = {{extent_x[i], extent_y[i], extent_z[i]}};
+        proxies[i] = bvh_insert(&tree, (extents_3d){vec3_subtract(center, half_extent), vec3_add(center, half_extent)}, i);
+    }
+    f64 insert_time = platform_get_absolute_time() - start;
+
+    // a narrow view, as when looking down a street
+    mat4 projection = mat4_perspective(deg_to_rad(30.0f), 1280 / 720.0f, 0.1f, 300.0f);
+    frustum f = frustum_from_matrix(mat4_multiply(mat4_identity(), projection));
+    frustum_cull_boxes boxes = {center_x, center_y, center_z, extent_x, extent_y, extent_z};
+
+    u32 batch_count = 0;
+    start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < BVH_BENCHMARK_FRAMES; ++frame) {
+        batch_count = frustum_cull_boxes_batch(&f, &boxes, count, visible);
+    }
+    f64 batch_time = platform_get_absolute_time() - start;
+
+    u32 tree_count = 0;
+    start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < BVH_BENCHMARK_FRAMES; ++frame) {
+        tree_count = 0;
+        bvh_query_frustum(&tree, &f, count_visible, &tree_count);
+    }
+    f64 tree_time = platform_get_absolute_time() - start;
+
+    u32 hit_count = 0;
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < BVH_BENCHMARK_RAY_COUNT; ++r) {
+        vec3 origin = {{random_range_f32(&state, -500.0f, 500.0f), 0.0f, random_range_f32(&state, -500.0f, 500.0f)}};
+        vec3 direction = vec3_normalized((vec3){{random_range_f32(&state, -1.0f, 1.0f), 0.1f, random_range_f32(&state, -1.0f, 1.0f)}});
+        bvh_raycast(&tree, origin, direction, 100.0f, count_hits, &hit_count);
+    }
+    f64 ray_time = platform_get_absolute_time() - start;
+
+    // every object moves a little each frame, few leave their fat box
+    u32 moved_count = 0;
+    start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < BVH_BENCHMARK_FRAMES; ++frame) {
+        for (u32 i = 0; i < count; ++i) {
+            center_x[i] += random_range_f32(&state, -0.1f, 0.1f);
+            vec3 center = {{center_x[i], center_y[i], center_z[i]}};
+            vec3 half_extent = {{extent_x[i], extent_y[i], extent_z[i]}};
+            moved_count += bvh_move(&tree, proxies[i], (extents_3d){vec3_subtract(center, half_extent), vec3_add(center, half_extent)});
+        }
+    }
+    f64 move_time = platform_get_absolute_time() - start;
+
+    printf("%u objects, height %u, %u visible (%u tested one by one), %u ray hits, %u moved in the tree\n",
+           count, bvh_get_height(&tree), tree_count, batch_count, hit_count, moved_count);
+    u64 frame_operations = (u64)count * BVH_BENCHMARK_FRAMES;
+    benchmark_report("bvh_insert", count, insert_time);
+    benchmark_report("frustum_cull_boxes_batch, per object", frame_operations, batch_time);
+    benchmark_report("bvh_query_frustum, per object in the scene", frame_operations, tree_time);
+    benchmark_report("bvh_raycast", BVH_BENCHMARK_RAY_COUNT, ray_time);
+    benchmark_report("bvh_move", frame_operations, move_time);
+
+    bvh_destroy(&tree);
+    cfree(proxies, sizeof(u32) * count, MEMORY_TAG_ARRAY);
+    cfree(memory, memory_size, MEMORY_TAG_ARRAY);
+}
+
+void bvh_register_benchmarks() {
+    benchmark_manager_register(benchmark_bvh, "Dynamic BVH");
+}
@@ -0,0 +1,108 @@
+#include "cmath_benchmarks.h"
+
+#include <math/cmath.h>
+#include <math/cmath_reference.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+
+#define CMATH_BENCHMARK_ITERATIONS 2000000
+// values cycled through, small enough to stay in L1
+#define CMATH_BENCHMARK_VALUE_COUNT 64
+
+static mat4 matrices[CMATH_BENCHMARK_VALUE_COUNT];
+static quat quaternions[CMATH_BENCHMARK_VALUE_COUNT];
+
+static void fill_values() {
+    for (u32 i = 0; i < CMATH_BENCHMARK_VALUE_COUNT; ++i) {
+        matrices[i] = mat4_multiply(mat4_euler_xyz(0.1f * i, 0.2f * i, 0.3f * i),
+                                    mat4_translation((vec3){{(f32)i, 1.0f, -2.0f}}));
+        quaternions[i] = quat_from_axis_angle((vec3){{1.0f, 0.1f * i, 0.5f}}, 0.05f * i, true);
+    }
+}
+
+void benchmark_cmath_mat4() {
+    fill_values();
+    // the result feeds the next iteration so the work can't be skipped
+    mat4 accumulator = mat4_identity();
+
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < CMATH_BENCHMARK_ITERATIONS; ++i) {
+        accumulator = mat4_multiply(accumulator, matrices[i % CMATH_BENCHMARK_VALUE_COUNT]);
+    }
+    f64 multiply_time = platform_get_absolute_time() - start;
+
+    mat4 reference_accumulator = mat4_identity();
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < CMATH_BENCHMARK_ITERATIONS; ++i) {
+        mat4_multiply_reference(&reference_accumulator, &matrices[i % CMATH_BENCHMARK_VALUE_COUNT], &reference_accumulator);
+    }
+    f64 reference_multiply_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < CMATH_BENCHMARK_ITERATIONS; ++i) {
+        matrices[i % CMATH_BENCHMARK_VALUE_COUNT] = mat4_inverse(matrices[i % CMATH_BENCHMARK_VALUE_COUNT]);
+    }
+    f64 inverse_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < CMATH_BENCHMARK_ITERATIONS; ++i) {
+        mat4_inverse_reference(&matrices[i % CMATH_BENCHMARK_VALUE_COUNT], &matrices[i % CMATH_BENCHMARK_VALUE_COUNT]);
+    }
+    f64 reference_inverse_time = platform_get_absolute_time() - start;
+
+    // the matrices are rotations and translations, every inverse applies
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < CMATH_BENCHMARK_ITERATIONS; ++i) {
+        matrices[i % CMATH_BENCHMARK_VALUE_COUNT] = mat4_inverse_affine(matrices[i % CMATH_BENCHMARK_VALUE_COUNT]);
+    }
+    f64 affine_inverse_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < CMATH_BENCHMARK_ITERATIONS; ++i) {
+        matrices[i % CMATH_BENCHMARK_VALUE_COUNT] = mat4_inverse_rigid(matrices[i % CMATH_BENCHMARK_VALUE_COUNT]);
+    }
+    f64 rigid_inverse_time = platform_get_absolute_time() - start;
+
+#if defined(cUSE_SIMD)
+    printf("implementation: SSE\n");
+#else
+    printf("implementation: scalar (build with cUSE_SIMD for SSE)\n");
+#endif
+    printf("checksum: %f %f\n", accumulator.data[15] + matrices[0].data[0], reference_accumulator.data[15]);
+    benchmark_report("mat4_multiply", CMATH_BENCHMARK_ITERATIONS, multiply_time);
+    benchmark_report("mat4_multiply (scalar reference)", CMATH_BENCHMARK_ITERATIONS, reference_multiply_time);
+    benchmark_report("mat4_inverse", CMATH_BENCHMARK_ITERATIONS, inverse_time);
+    benchmark_report("mat4_inverse (scalar reference)", CMATH_BENCHMARK_ITERATIONS, reference_inverse_time);
+    benchmark_report("mat4_inverse_affine", CMATH_BENCHMARK_ITERATIONS, affine_inverse_time);
+    benchmark_report("mat4_inverse_rigid", CMATH_BENCHMARK_ITERATIONS, rigid_inverse_time);
+}
+
+void benchmark_cmath_quat() {
+    fill_values();
+    quat accumulator = quat_identity();
+
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < CMATH_BENCHMARK_ITERATIONS; ++i) {
+        accumulator = quat_normalize(quat_mul(accumulator, quaternions[i % CMATH_BENCHMARK_VALUE_COUNT]));
+    }
+    f64 mul_time = platform_get_absolute_time() - start;
+
+    quat reference_accumulator = quat_identity();
+    start = platform_get_absolute_time();
+    for (u32 i = 0; i < CMATH_BENCHMARK_ITERATIONS; ++i) {
+        quat_mul_reference(&reference_accumulator, &quaternions[i % CMATH_BENCHMARK_VALUE_COUNT], &reference_accumulator);
+        quat_normalize_reference(&reference_accumulator, &reference_accumulator);
+    }
+    f64 reference_mul_time = platform_get_absolute_time() - start;
+
+    printf("checksum: %f %f\n", accumulator.w, reference_accumulator.w);
+    benchmark_report("quat_mul + quat_normalize", CMATH_BENCHMARK_ITERATIONS, mul_time);
+    benchmark_report("quat_mul + quat_normalize (scalar reference)", CMATH_BENCHMARK_ITERATIONS, reference_mul_time);
+}
+
+void cmath_register_benchmarks() {
+    benchmark_manager_register(benchmark_cmath_mat4, "mat4 multiply and inverse");
+    benchmark_manager_register(benchmark_cmath_quat, "quaternion multiply");
+}
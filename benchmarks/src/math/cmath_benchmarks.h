@@ -0,0 +1,3 @@
+#pragma once
+
+void cmath_register_benchmarks();
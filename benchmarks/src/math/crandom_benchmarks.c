@@ -0,0 +1,61 @@
+#include "crandom_benchmarks.h"
+
+#include <math/crandom.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CRANDOM_BENCHMARK_COUNT 4096
+#define CRANDOM_BENCHMARK_REPEAT 1000
+
+static f32 values[CRANDOM_BENCHMARK_COUNT];
+
+void benchmark_crandom_floats() {
+    u64 operations = (u64)CRANDOM_BENCHMARK_COUNT * CRANDOM_BENCHMARK_REPEAT;
+    random_state state;
+    random_seed(&state, 1);
+
+    // what fcrandom_in_range used to do
+    f64 start = platform_get_absolute_time();
+    for (u32 r = 0; r < CRANDOM_BENCHMARK_REPEAT; ++r) {
+        for (u32 i = 0; i < CRANDOM_BENCHMARK_COUNT; ++i) {
+            values[i] = (f32)rand() / (f32)RAND_MAX * 2.0f - 1.0f;
+        }
+    }
+    f64 libc_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < CRANDOM_BENCHMARK_REPEAT; ++r) {
+        for (u32 i = 0; i < CRANDOM_BENCHMARK_COUNT; ++i) {
+            values[i] = random_range_f32(&state, -1.0f, 1.0f);
+        }
+    }
+    f64 single_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < CRANDOM_BENCHMARK_REPEAT; ++r) {
+        random_fill_f32(&state, values, CRANDOM_BENCHMARK_COUNT, -1.0f, 1.0f);
+    }
+    f64 fill_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < CRANDOM_BENCHMARK_REPEAT; ++r) {
+        random_state* thread_state = random_thread_state();
+        for (u32 i = 0; i < CRANDOM_BENCHMARK_COUNT; ++i) {
+            values[i] = random_range_f32(thread_state, -1.0f, 1.0f);
+        }
+    }
+    f64 thread_time = platform_get_absolute_time() - start;
+
+    printf("checksum: %f\n", values[0] + values[CRANDOM_BENCHMARK_COUNT - 1]);
+    benchmark_report("rand() floats", operations, libc_time);
+    benchmark_report("random_range_f32", operations, single_time);
+    benchmark_report("random_fill_f32", operations, fill_time);
+    benchmark_report("random_range_f32 on the thread state", operations, thread_time);
+}
+
+void crandom_register_benchmarks() {
+    benchmark_manager_register(benchmark_crandom_floats, "Random float generation");
+}
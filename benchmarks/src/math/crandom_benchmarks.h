@@ -0,0 +1,3 @@
+#pragma once
+
+void crandom_register_benchmarks();
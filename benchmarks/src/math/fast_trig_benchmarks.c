@@ -0,0 +1,124 @@
+#include "fast_trig_benchmarks.h"
+
+#include <math/fast_trig.h>
+#include <core/cmemory.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define FAST_TRIG_BENCHMARK_COUNT 4096
+#define FAST_TRIG_BENCHMARK_REPEAT 500
+
+static f32 angles[FAST_TRIG_BENCHMARK_COUNT];
+static f32 sines[FAST_TRIG_BENCHMARK_COUNT];
+static f32 cosines[FAST_TRIG_BENCHMARK_COUNT];
+
+// Largest error of the last results against the double precision libm
+static void report_error(const char* label) {
+    f64 max_error = 0.0;
+    for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+        f64 error = fabs(sines[i] - sin((f64)angles[i]));
+        if (error > max_error) max_error = error;
+        error = fabs(cosines[i] - cos((f64)angles[i]));
+        if (error > max_error) max_error = error;
+    }
+    printf("  %-45s max error %.2e\n", label, max_error);
+}
+
+void benchmark_fast_trig_sincos() {
+    // angles of a typical frame, a few turns either way
+    for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+        angles[i] = -20.0f + 40.0f * (f32)i / FAST_TRIG_BENCHMARK_COUNT;
+    }
+    u64 operations = (u64)FAST_TRIG_BENCHMARK_COUNT * FAST_TRIG_BENCHMARK_REPEAT;
+
+    f64 start = platform_get_absolute_time();
+    for (u32 r = 0; r < FAST_TRIG_BENCHMARK_REPEAT; ++r) {
+        for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+            sines[i] = c_sinf(angles[i]);
+            cosines[i] = c_cosf(angles[i]);
+        }
+    }
+    f64 libm_time = platform_get_absolute_time() - start;
+    report_error("c_sinf + c_cosf (libm)");
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < FAST_TRIG_BENCHMARK_REPEAT; ++r) {
+        for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+            c_sincosf_precise(angles[i], &sines[i], &cosines[i]);
+        }
+    }
+    f64 precise_time = platform_get_absolute_time() - start;
+    report_error("c_sincosf_precise");
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < FAST_TRIG_BENCHMARK_REPEAT; ++r) {
+        for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+            c_sincosf_fast(angles[i], &sines[i], &cosines[i]);
+        }
+    }
+    f64 fast_time = platform_get_absolute_time() - start;
+    report_error("c_sincosf_fast");
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < FAST_TRIG_BENCHMARK_REPEAT; ++r) {
+        c_sincosf_array(angles, FAST_TRIG_BENCHMARK_COUNT, true, sines, cosines);
+    }
+    f64 array_precise_time = platform_get_absolute_time() - start;
+    report_error("c_sincosf_array precise");
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < FAST_TRIG_BENCHMARK_REPEAT; ++r) {
+        c_sincosf_array(angles, FAST_TRIG_BENCHMARK_COUNT, false, sines, cosines);
+    }
+    f64 array_fast_time = platform_get_absolute_time() - start;
+    report_error("c_sincosf_array fast");
+
+    benchmark_report("c_sinf + c_cosf (libm)", operations, libm_time);
+    benchmark_report("c_sincosf_precise", operations, precise_time);
+    benchmark_report("c_sincosf_fast", operations, fast_time);
+    benchmark_report("c_sincosf_array precise", operations, array_precise_time);
+    benchmark_report("c_sincosf_array fast", operations, array_fast_time);
+}
+
+void benchmark_fast_trig_acos() {
+    for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+        angles[i] = -1.0f + 2.0f * (f32)i / FAST_TRIG_BENCHMARK_COUNT;
+    }
+    u64 operations = (u64)FAST_TRIG_BENCHMARK_COUNT * FAST_TRIG_BENCHMARK_REPEAT;
+
+    f64 start = platform_get_absolute_time();
+    for (u32 r = 0; r < FAST_TRIG_BENCHMARK_REPEAT; ++r) {
+        for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+            sines[i] = c_acosf(angles[i]);
+        }
+    }
+    f64 libm_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < FAST_TRIG_BENCHMARK_REPEAT; ++r) {
+        for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+            sines[i] = c_acosf_precise(angles[i]);
+        }
+    }
+    f64 precise_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 r = 0; r < FAST_TRIG_BENCHMARK_REPEAT; ++r) {
+        for (u32 i = 0; i < FAST_TRIG_BENCHMARK_COUNT; ++i) {
+            sines[i] = c_acosf_fast(angles[i]);
+        }
+    }
+    f64 fast_time = platform_get_absolute_time() - start;
+
+    benchmark_report("c_acosf (libm)", operations, libm_time);
+    benchmark_report("c_acosf_precise", operations, precise_time);
+    benchmark_report("c_acosf_fast", operations, fast_time);
+}
+
+void fast_trig_register_benchmarks() {
+    benchmark_manager_register(benchmark_fast_trig_sincos, "sin / cos approximations against libm");
+    benchmark_manager_register(benchmark_fast_trig_acos, "acos approximations against libm");
+}
@@ -0,0 +1,81 @@
+#include "frustum_benchmarks.h"
+
+#include <math/cmath.h>
+#include <math/crandom.h>
+#include <math/frustum.h>
+#include <core/cmemory.h>
+#include <platform/platform.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+
+#define FRUSTUM_BENCHMARK_OBJECT_COUNT 100000
+#define FRUSTUM_BENCHMARK_FRAMES 50
+
+void benchmark_frustum_cull() {
+    const u32 count = FRUSTUM_BENCHMARK_OBJECT_COUNT;
+    // 7 arrays of count floats or indices
+    u64 memory_size = sizeof(f32) * count * 7;
+    f32* memory = callocate(memory_size, MEMORY_TAG_ARRAY);
+    f32* center_x = memory;
+    f32* center_y = center_x + count;
+    f32* center_z = center_y + count;
+    f32* extent_x = center_z + count;
+    f32* extent_y = extent_x + count;
+    f32* extent_z = extent_y + count;
+    u32* visible = (u32*)(extent_z + count);
+
+    // objects all around the camera, about a quarter of them visible
+    random_state state;
+    random_seed(&state, 100000);
+    random_fill_f32(&state, center_x, count, -500.0f, 500.0f);
+    random_fill_f32(&state, center_y, count, -50.0f, 50.0f);
+    random_fill_f32(&state, center_z, count, -500.0f, 500.0f);
+    random_fill_f32(&state, extent_x, count, 0.5f, 4.0f);
+    random_fill_f32(&state, extent_y, count, 0.5f, 4.0f);
+    random_fill_f32(&state, extent_z, count, 0.5f, 4.0f);
+
+    mat4 projection = mat4_perspective(deg_to_rad(45.0f), 1280 / 720.0f, 0.1f, 1000.0f);
+    frustum f = frustum_from_matrix(mat4_multiply(mat4_identity(), projection));
+    frustum_cull_spheres spheres = {center_x, center_y, center_z, extent_x};
+    frustum_cull_boxes boxes = {center_x, center_y, center_z, extent_x, extent_y, extent_z};
+
+    u32 single_count = 0;
+    f64 start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < FRUSTUM_BENCHMARK_FRAMES; ++frame) {
+        single_count = 0;
+        for (u32 i = 0; i < count; ++i) {
+            vec3 center = {{center_x[i], center_y[i], center_z[i]}};
+            if (frustum_intersects_sphere(&f, center, extent_x[i])) {
+                visible[single_count++] = i;
+            }
+        }
+    }
+    f64 single_time = platform_get_absolute_time() - start;
+
+    u32 sphere_count = 0;
+    start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < FRUSTUM_BENCHMARK_FRAMES; ++frame) {
+        sphere_count = frustum_cull_spheres_batch(&f, &spheres, count, visible);
+    }
+    f64 sphere_time = platform_get_absolute_time() - start;
+
+    u32 box_count = 0;
+    start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < FRUSTUM_BENCHMARK_FRAMES; ++frame) {
+        box_count = frustum_cull_boxes_batch(&f, &boxes, count, visible);
+    }
+    f64 box_time = platform_get_absolute_time() - start;
+
+    printf("%u objects, %u visible spheres (%u one at a time), %u visible boxes\n", count, sphere_count, single_count, box_count);
+    u64 operations = (u64)count * FRUSTUM_BENCHMARK_FRAMES;
+    benchmark_report("frustum_intersects_sphere, one at a time", operations, single_time);
+    benchmark_report("frustum_cull_spheres_batch", operations, sphere_time);
+    benchmark_report("frustum_cull_boxes_batch", operations, box_time);
+
+    cfree(memory, memory_size, MEMORY_TAG_ARRAY);
+}
+
+void frustum_register_benchmarks() {
+    benchmark_manager_register(benchmark_frustum_cull, "Frustum culling");
+}
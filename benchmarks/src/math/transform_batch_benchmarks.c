@@ -0,0 +1,72 @@
+#include "transform_batch_benchmarks.h"
+
+#include <math/cmath.h>
+#include <math/transform_batch.h>
+#include <core/cmemory.h>
+#include <platform/platform.h>
+#include <platform/cpu_info.h>
+#include "../benchmark_manager.h"
+
+#include <stdio.h>
+
+#define TRANSFORM_BENCHMARK_OBJECT_COUNT 100000
+#define TRANSFORM_BENCHMARK_FRAMES 20
+
+void benchmark_transform_batch() {
+    const u32 count = TRANSFORM_BENCHMARK_OBJECT_COUNT;
+    u32 worker_count = platform_get_cpu_info()->physical_core_count;
+    worker_count = worker_count > 1 ? worker_count - 1 : 0;
+    if (worker_count > 7) {
+        worker_count = 7;
+    }
+
+    transform_batch batch;
+    transform_batch batch_threaded;
+    transform_batch_create(count, 0, &batch);
+    transform_batch_create(count, worker_count, &batch_threaded);
+    for (u32 i = 0; i < count; ++i) {
+        vec3 position = {{(f32)(i % 100), (f32)(i / 100), 0.0f}};
+        quat rotation = quat_from_axis_angle((vec3){{0.0f, 1.0f, 0.0f}}, 0.001f * i, true);
+        vec3 scale = {{1.0f, 1.0f, 1.0f}};
+        transform_batch_add(&batch, position, rotation, scale);
+        transform_batch_add(&batch_threaded, position, rotation, scale);
+    }
+    mat4* models = callocate(sizeof(mat4) * count, MEMORY_TAG_ARRAY);
+
+    // what the example does for each object
+    f64 start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < TRANSFORM_BENCHMARK_FRAMES; ++frame) {
+        for (u32 i = 0; i < count; ++i) {
+            quat rotation = vec4_create(batch.rotation_x[i], batch.rotation_y[i], batch.rotation_z[i], batch.rotation_w[i]);
+            vec3 position = {{batch.position_x[i], batch.position_y[i], batch.position_z[i]}};
+            models[i] = mat4_multiply(quat_to_mat4(rotation), mat4_translation(position));
+        }
+    }
+    f64 single_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < TRANSFORM_BENCHMARK_FRAMES; ++frame) {
+        transform_batch_compute(&batch, models);
+    }
+    f64 batch_time = platform_get_absolute_time() - start;
+
+    start = platform_get_absolute_time();
+    for (u32 frame = 0; frame < TRANSFORM_BENCHMARK_FRAMES; ++frame) {
+        transform_batch_compute(&batch_threaded, models);
+    }
+    f64 threaded_time = platform_get_absolute_time() - start;
+
+    printf("%u objects, %u workers, checksum %f\n", count, batch_threaded.worker_count, models[count - 1].data[12]);
+    u64 operations = (u64)count * TRANSFORM_BENCHMARK_FRAMES;
+    benchmark_report("quat_to_mat4 * mat4_translation, one at a time", operations, single_time);
+    benchmark_report("transform_batch_compute", operations, batch_time);
+    benchmark_report("transform_batch_compute with workers", operations, threaded_time);
+
+    cfree(models, sizeof(mat4) * count, MEMORY_TAG_ARRAY);
+    transform_batch_destroy(&batch_threaded);
+    transform_batch_destroy(&batch);
+}
+
+void transform_batch_register_benchmarks() {
+    benchmark_manager_register(benchmark_transform_batch, "Batched model matrices");
+}
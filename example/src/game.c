@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_GAME
+
 #include "game.h"
 
 #include <core/logger.h>
@@ -21,7 +23,8 @@ void recalculate_view_matrix(game_state* state) {
         state->camera_euler.z);
 
     state->view = mat4_multiply(rotation, translation);
-    state->view = mat4_inverse(state->view);
+    // a camera only rotates and moves
+    state->view = mat4_inverse_rigid(state->view);
 
     state->camera_updated = false;
 }
@@ -61,7 +64,8 @@ b8 game_update(app* application_inst, f32 delta_time) {
         LOG_DEBUG("Allocations: %llu (%llu this frame)", alloc_count, alloc_count - prev_alloc_count);
     }
 
-    if (input_is_key_down('T') && input_was_key_up('T')) {
+    // counts presses shorter than a frame too
+    if (input_key_press_count('T')) {
         event_context context = {};
         event_fire(EVENT_CODE_DEBUG0, application_inst, context);
     }
@@ -9,6 +9,12 @@ b8 create_application(app* application_inst) {
     application_inst->config.window_width = 1600;
     application_inst->config.window_height = 1000;
     application_inst->config.window_title = "testy";
+    application_inst->config.headless = false;
+    application_inst->config.target_fps = 60;
+    application_inst->config.binary_log_path = "console.clog";
+    application_inst->config.input_record_path = 0;
+    application_inst->config.input_replay_path = 0;
+    application_inst->config.quit_after_replay = false;
 
     application_inst->initialize = game_initialize;
     application_inst->update = game_update;
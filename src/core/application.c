@@ -3,9 +3,12 @@
 #include "core/event.h"
 #include "app.h"
 #include "clock.h"
+#include "frame_pacer.h"
 #include "cmemory.h"
 #include "logger.h"
 #include "platform/platform.h"
+#include "platform/async_io.h"
+#include "platform/cpu_info.h"
 #include "core/input.h"
 #include "memory/linear_allocator.h"
 #include "cstring.h"
@@ -17,6 +20,11 @@
 #include "systems/resource_system.h"
 #include "systems/texture_system.h"
 
+// How often the rate-limited log sites report what they suppressed
+#define LOG_SUPPRESSED_REPORT_SECONDS 5.0
+// How often the frame time statistics are logged
+#define FRAME_PACING_REPORT_SECONDS 10.0
+
 enum application_state_enum {
     APPLICATION_STATE_STARTING = 0,
     APPLICATION_STATE_RUNNING = 1,
@@ -34,7 +42,8 @@ typedef struct application_state {
     i16 width;
     i16 height;
     clock clock;
-    f64 last_frame_time;
+    u64 last_frame_ticks;
+    frame_pacer frame_pacer;
 
     linear_allocator systems_allocator;
 
@@ -53,6 +62,9 @@ typedef struct application_state {
     u64 platform_system_memory_requirement;
     void* platform_system_state;
 
+    u64 async_io_system_memory_requirement;
+    void* async_io_system_state;
+
     u64 renderer_system_memory_requirement;
     void* renderer_system_state;
 
@@ -145,6 +157,12 @@ b8 application_create(app* app_inst) {
         LOG_FATAL("Failed to initialize logging system! Shutting down.");
         return false;
     }
+    if (!logging_start_async(4096)) {
+        LOG_WARN("Failed to start async logging, logging synchronously");
+    }
+    if (app_inst->config.binary_log_path && !logging_binary_open(app_inst->config.binary_log_path)) {
+        LOG_WARN("Failed to open the binary log, deferred-format messages will be logged as text");
+    }
 
     // events
     initialize_event(&app_state->event_system_memory_requirement, 0);
@@ -163,15 +181,39 @@ b8 application_create(app* app_inst) {
         LOG_FATAL("Failed to initialize input system! Shutting down.");
         return false;
     }
+    if (app_inst->config.input_replay_path && !input_replay_start(app_inst->config.input_replay_path)) {
+        LOG_WARN("Failed to start the input replay, using the live input");
+    }
+    if (app_inst->config.input_record_path && !input_recording_start(app_inst->config.input_record_path)) {
+        LOG_WARN("Failed to start the input recording");
+    }
 
     // Platform system
-    initialize_platform(&app_state->platform_system_memory_requirement, 0);
+    platform_system_config platform_sys_config;
+    platform_sys_config.backend = app_inst->config.headless ? PLATFORM_BACKEND_HEADLESS : PLATFORM_BACKEND_XCB;
+    initialize_platform(&app_state->platform_system_memory_requirement, 0, platform_sys_config);
     app_state->platform_system_state = linear_allocator_allocate(
         &app_state->systems_allocator, app_state->platform_system_memory_requirement);
-    if (!initialize_platform(&app_state->platform_system_memory_requirement, app_state->platform_system_state)) {
+    if (!initialize_platform(&app_state->platform_system_memory_requirement, app_state->platform_system_state,
+                             platform_sys_config)) {
         LOG_FATAL("Failed to initialize platform system! Shutting down.");
         return false;
     }
+    platform_cpu_info_log();
+
+    // Async I/O system
+    async_io_config async_io_sys_config;
+    async_io_sys_config.backend = ASYNC_IO_BACKEND_AUTO;
+    async_io_sys_config.max_in_flight = 256;
+    async_io_sys_config.worker_count = 2;
+    initialize_async_io(&app_state->async_io_system_memory_requirement, 0, async_io_sys_config);
+    app_state->async_io_system_state = linear_allocator_allocate(
+        &app_state->systems_allocator, app_state->async_io_system_memory_requirement);
+    if (!initialize_async_io(&app_state->async_io_system_memory_requirement, app_state->async_io_system_state,
+                             async_io_sys_config)) {
+        LOG_FATAL("Failed to initialize async I/O system! Shutting down.");
+        return false;
+    }
 
     // Resource system
     resource_system_config resource_sys_config;
@@ -277,13 +319,15 @@ b8 application_create(app* app_inst) {
 
 b8 application_run() {
     LOG_DEBUG(get_memory_usage_str());
-    clock_start(&app_state->clock);
+    // integer ticks: the frame delta is a difference of ticks converted once, so it stays
+    // exact however long the session is
+    clock_start_ticks(&app_state->clock);
     clock_update(&app_state->clock);
-    app_state->last_frame_time = app_state->clock.elasped_time;
+    app_state->last_frame_ticks = app_state->clock.elapsed_ticks;
 
-    f64 running_time = 0.0;
-    u8 frame_count = 0;
-    f64 target_frame_seconds = 1.0f / 60;
+    frame_pacer_create(app_state->app_inst->config.target_fps, &app_state->frame_pacer);
+    f64 last_frame_pacing_report_time = app_state->clock.elasped_time;
+    f64 last_suppressed_report_time = app_state->clock.elasped_time;
 
     // Game loop
     while (app_state->state == APPLICATION_STATE_RUNNING) {
@@ -291,11 +335,23 @@ b8 application_run() {
             app_state->state = APPLICATION_STATE_SHUTDOWN;
         }
 
+        // callbacks of the file reads that completed in the background
+        async_io_poll();
+
         if (app_state->state != APPLICATION_STATE_SUSPENDED) {
             clock_update(&app_state->clock);
             f64 current_time = app_state->clock.elasped_time;
-            f64 delta = (current_time - app_state->last_frame_time);
-            f64 frame_start_time = platform_get_absolute_time();
+            u64 current_ticks = app_state->clock.elapsed_ticks;
+            f64 delta = platform_ticks_to_seconds(current_ticks - app_state->last_frame_ticks);
+
+            // a replay feeds its recorded input and substitutes its recorded frame time
+            if (input_is_replaying() && !input_replay_next_frame(&delta)) {
+                LOG_INFO("Input replay finished");
+                if (app_state->app_inst->config.quit_after_replay) {
+                    app_state->state = APPLICATION_STATE_SHUTDOWN;
+                    break;
+                }
+            }
 
             // Update application
             if (!app_state->app_inst->update(app_state->app_inst, (f32)delta)) {
@@ -318,26 +374,25 @@ b8 application_run() {
 
             renderer_draw_frame(&packet);
 
-            f64 frame_end_time = platform_get_absolute_time();
-            f64 frame_elapsed_time = frame_end_time - frame_start_time;
-            running_time += frame_elapsed_time;
-            f64 remaining_time = target_frame_seconds - frame_elapsed_time;
-
-            if (remaining_time > 0) {
-                u64 remaining_ms = (u64)(remaining_time * 1000);
-
-                b8 limit_frame = false;
-                if (remaining_ms > 0 && limit_frame) {
-                    platform_sleep_ms(remaining_ms - 1);
-                }
-
-                frame_count++;
+            // sleep then spin until the end of the frame (no wait when uncapped)
+            frame_pacer_wait(&app_state->frame_pacer);
+            if (current_time - last_frame_pacing_report_time >= FRAME_PACING_REPORT_SECONDS) {
+                frame_pacer_report(&app_state->frame_pacer);
+                last_frame_pacing_report_time = current_time;
             }
 
 
             update_input(delta);
 
-            app_state->last_frame_time = current_time;
+            // payloads fired this frame are no longer valid
+            event_frame_reset();
+
+            if (current_time - last_suppressed_report_time >= LOG_SUPPRESSED_REPORT_SECONDS) {
+                logging_report_suppressed();
+                last_suppressed_report_time = current_time;
+            }
+
+            app_state->last_frame_ticks = current_ticks;
         }
     }
 
@@ -349,7 +404,10 @@ b8 application_run() {
     event_unregister(EVENT_CODE_KEY_PRESSED, 0, application_on_key);
     event_unregister(EVENT_CODE_KEY_RELEASED, 0, application_on_key);
 
+    logging_report_suppressed();
+
     if (app_state->event_system_state) {
+        event_profiling_report(10);
         event_shutdown();
     }
 
@@ -376,11 +434,18 @@ b8 application_run() {
     }
 
     resource_system_shutdown(app_state->resource_system_state);
+
+    if (app_state->async_io_system_state) {
+        shutdown_async_io();
+    }
     
     if (app_state->platform_system_state) {
         shutdown_platform();
     }
 
+    // write out the queued log entries
+    shutdown_logging();
+
     return true;
 }
 
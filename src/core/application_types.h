@@ -9,4 +9,19 @@ typedef struct application_configuration {
     i16 window_width;
     i16 window_height;
     char* window_title;
+    // run without a window, an X server or a GPU (headless platform and null renderer)
+    b8 headless;
+
+    // frames per second the frame loop is paced to, 0 for uncapped
+    u32 target_fps;
+
+    // path of the binary log receiving the LOG_*_BIN messages, 0 to log them as text
+    const char* binary_log_path;
+
+    // record the input of the session to this file, 0 to disable
+    const char* input_record_path;
+    // replay a recorded session instead of the live input, 0 to disable
+    const char* input_replay_path;
+    // quit once the replay is over, for benchmark runs
+    b8 quit_after_replay;
 } application_configuration;
\ No newline at end of file
@@ -3,7 +3,12 @@
 #include "platform/platform.h"
 
 void clock_update(clock* c) {
-    if (c->start_time != 0) {
+    if (c->use_ticks) {
+        if (c->start_ticks != 0) {
+            c->elapsed_ticks = platform_get_ticks() - c->start_ticks;
+            c->elasped_time = platform_ticks_to_seconds(c->elapsed_ticks);
+        }
+    } else if (c->start_time != 0) {
         c->elasped_time = platform_get_absolute_time() - c->start_time;
     }
 }
@@ -11,9 +16,27 @@ void clock_update(clock* c) {
 void clock_start(clock* c) {
     c->start_time = platform_get_absolute_time();
     c->elasped_time = 0;
+    c->use_ticks = false;
+    c->start_ticks = 0;
+    c->elapsed_ticks = 0;
+}
+
+void clock_start_ticks(clock* c) {
+    c->start_time = 0;
+    c->elasped_time = 0;
+    c->use_ticks = true;
+    c->start_ticks = platform_get_ticks();
+    c->elapsed_ticks = 0;
 }
 
 void clock_stop(clock* c) {
     c->start_time = 0;
+    c->start_ticks = 0;
 }
 
+u64 clock_elapsed_ns(const clock* c) {
+    if (c->use_ticks) {
+        return platform_ticks_to_ns(c->elapsed_ticks);
+    }
+    return (u64)(c->elasped_time * 1e9);
+}
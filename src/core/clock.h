@@ -5,8 +5,20 @@
 typedef struct clock {
     f64 start_time;
     f64 elasped_time;
+
+    // integer tick mode (clock_start_ticks): the elapsed time is kept in platform ticks
+    // so it doesn't lose precision in long sessions. elasped_time is derived from it
+    b8 use_ticks;
+    u64 start_ticks;
+    u64 elapsed_ticks;
 } clock;
 
 void clock_update(clock* c);
 void clock_start(clock* c);
 void clock_stop(clock* c);
+
+// Start the clock in integer tick mode (see platform_get_ticks)
+void clock_start_ticks(clock* c);
+
+// Elapsed time in nanoseconds at the last update
+u64 clock_elapsed_ns(const clock* c);
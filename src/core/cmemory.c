@@ -52,7 +52,7 @@ void shutdown_memory() {
 
 void* callocate(u64 size, memory_tag tag) {
     if (tag == MEMORY_TAG_UNKNOWN) {
-        LOG_WARN("Allocating memory with unknown tag is not recommended, try to use a more specific tag");
+        LOG_WARN_ONCE("Allocating memory with unknown tag is not recommended, try to use a more specific tag");
     }
 
     if (state_ptr) {
@@ -69,7 +69,7 @@ void* callocate(u64 size, memory_tag tag) {
 
 void cfree(void* block, u64 size, memory_tag tag) {
     if (tag == MEMORY_TAG_UNKNOWN) {
-        LOG_WARN("Freeing memory with unknown tag is not recommended, try to use a more specific tag");
+        LOG_WARN_ONCE("Freeing memory with unknown tag is not recommended, try to use a more specific tag");
     }
 
     if (state_ptr) {
@@ -3,20 +3,54 @@
 #include "core/cmemory.h"
 #include "core/logger.h"
 #include "containers/darray.h"
+#include "memory/linear_allocator.h"
 
-typedef struct registered_event {
-    void *listener;
-    PFN_on_event callback;
-} registered_event;
+#ifdef cEVENT_PROFILING_ENABLED
+#include "platform/platform.h"
+#endif
 
+/**
+ * Listeners of a single event code. Stored as parallel arrays (SoA) so dispatch
+ * only walks the callbacks and listeners, sorted by descending priority.
+ */
 typedef struct event_code_entry {
-    registered_event *events;
+    u16 code;
+    PFN_on_event* callbacks;
+    void** listeners;
+    i16* priorities;
+
+#ifdef cEVENT_PROFILING_ENABLED
+    u64 fire_count;
+    u64 handled_count;
+    // per listener, in lockstep with the arrays above
+    u64* listener_calls;
+    // time spent in the listener, in platform ticks
+    u64* listener_ticks;
+#endif
 } event_code_entry;
 
-#define MAX_MESSAGE_CODES 16384
+// Maximum number of distinct event codes that can have listeners at once. The entry of a code
+// whose listeners are all unregistered is reused by the next new code once the table is full
+#define MAX_EVENT_CODE_ENTRIES 256
+// Size of the open-addressing lookup table (power of 2, at least twice the entry count)
+#define EVENT_CODE_LOOKUP_SIZE 512
+// Size of the arena holding the payloads fired during one frame
+#define EVENT_PAYLOAD_ARENA_SIZE (64 * 1024)
+// Payloads are rounded up to this size so each one stays aligned in the arena
+#define EVENT_PAYLOAD_ALIGNMENT 16
 
 typedef struct event_system_state {
-    event_code_entry registered[MAX_MESSAGE_CODES];
+    u32 entry_count;
+    event_code_entry entries[MAX_EVENT_CODE_ENTRIES];
+
+    // code -> entry index + 1 (0 means empty slot)
+    u16 lookup[EVENT_CODE_LOOKUP_SIZE];
+
+    // number of event_fire calls in progress, entries are not reused while it isn't 0
+    u32 fire_depth;
+
+    // per-frame storage for event_fire_payload, the memory block follows this struct
+    linear_allocator payload_arena;
 } event_system_state;
 
 /**
@@ -25,9 +59,91 @@ typedef struct event_system_state {
 
 static event_system_state *state_ptr;
 
+static u32 event_code_hash(u16 code) {
+    // Fibonacci hashing, keep the top bits for the lookup table size
+    return ((u32)code * 2654435769u) >> (32 - 9);
+}
+
+static event_code_entry* event_find_entry(u16 code) {
+    u32 slot = event_code_hash(code);
+    for (u32 i = 0; i < EVENT_CODE_LOOKUP_SIZE; ++i) {
+        u16 index = state_ptr->lookup[slot];
+        if (index == 0) {
+            return 0;
+        }
+        if (state_ptr->entries[index - 1].code == code) {
+            return &state_ptr->entries[index - 1];
+        }
+        slot = (slot + 1) & (EVENT_CODE_LOOKUP_SIZE - 1);
+    }
+    return 0;
+}
+
+static void event_rebuild_lookup() {
+    czero_memory(state_ptr->lookup, sizeof(state_ptr->lookup));
+    for (u32 i = 0; i < state_ptr->entry_count; ++i) {
+        u32 slot = event_code_hash(state_ptr->entries[i].code);
+        while (state_ptr->lookup[slot] != 0) {
+            slot = (slot + 1) & (EVENT_CODE_LOOKUP_SIZE - 1);
+        }
+        state_ptr->lookup[slot] = (u16)(i + 1);
+    }
+}
+
+// Give the entry of a code without listeners to another code
+static event_code_entry* event_reuse_entry(u16 code) {
+    if (state_ptr->fire_depth > 0) {
+        // the entry may be the one being dispatched
+        return 0;
+    }
+    for (u32 i = 0; i < state_ptr->entry_count; ++i) {
+        event_code_entry* entry = &state_ptr->entries[i];
+        if (darray_length(entry->callbacks) == 0) {
+            entry->code = code;
+#ifdef cEVENT_PROFILING_ENABLED
+            entry->fire_count = 0;
+            entry->handled_count = 0;
+#endif
+            event_rebuild_lookup();
+            return entry;
+        }
+    }
+    return 0;
+}
+
+static event_code_entry* event_create_entry(u16 code) {
+    if (state_ptr->entry_count >= MAX_EVENT_CODE_ENTRIES) {
+        event_code_entry* reused = event_reuse_entry(code);
+        if (!reused) {
+            LOG_ERROR("Event system: too many distinct event codes registered (max %d)", MAX_EVENT_CODE_ENTRIES);
+        }
+        return reused;
+    }
+
+    u32 slot = event_code_hash(code);
+    while (state_ptr->lookup[slot] != 0) {
+        slot = (slot + 1) & (EVENT_CODE_LOOKUP_SIZE - 1);
+    }
+
+    event_code_entry* entry = &state_ptr->entries[state_ptr->entry_count];
+    entry->code = code;
+    entry->callbacks = darray_create(PFN_on_event);
+    entry->listeners = darray_create(void*);
+    entry->priorities = darray_create(i16);
+#ifdef cEVENT_PROFILING_ENABLED
+    entry->fire_count = 0;
+    entry->handled_count = 0;
+    entry->listener_calls = darray_create(u64);
+    entry->listener_ticks = darray_create(u64);
+#endif
+
+    state_ptr->entry_count++;
+    state_ptr->lookup[slot] = (u16)state_ptr->entry_count;
+    return entry;
+}
 
 b8 initialize_event(u64 *memory_requirement, void *state) {
-    *memory_requirement = sizeof(event_system_state);
+    *memory_requirement = sizeof(event_system_state) + EVENT_PAYLOAD_ARENA_SIZE;
     if (!state) {
         return false;
     }
@@ -40,44 +156,93 @@ b8 initialize_event(u64 *memory_requirement, void *state) {
     state_ptr = state;
     czero_memory(state_ptr, sizeof(event_system_state));
 
+    void* arena_block = (u8*)state + sizeof(event_system_state);
+    linear_allocator_create(EVENT_PAYLOAD_ARENA_SIZE, arena_block, &state_ptr->payload_arena);
+
     return true;
 }
 
 void event_shutdown() {
-    // free the events arrays. And objects poitned to should be destroyed on their own
-    for (u16 i = 0; i < MAX_MESSAGE_CODES; ++i) {
-        if (state_ptr->registered[i].events != 0) {
-            darray_destroy(state_ptr->registered[i].events);
-            state_ptr->registered[i].events = 0;
-        }
+    if (!state_ptr) {
+        return;
     }
+
+    // free the listener arrays. And objects pointed to should be destroyed on their own
+    for (u32 i = 0; i < state_ptr->entry_count; ++i) {
+        event_code_entry* entry = &state_ptr->entries[i];
+        darray_destroy(entry->callbacks);
+        darray_destroy(entry->listeners);
+        darray_destroy(entry->priorities);
+#ifdef cEVENT_PROFILING_ENABLED
+        darray_destroy(entry->listener_calls);
+        darray_destroy(entry->listener_ticks);
+#endif
+    }
+
+    linear_allocator_destroy(&state_ptr->payload_arena);
+    state_ptr = 0;
 }
 
 b8 event_register(u16 code, void *listener, PFN_on_event on_event) {
+    return event_register_priority(code, listener, on_event, EVENT_PRIORITY_NORMAL);
+}
+
+b8 event_register_priority(u16 code, void *listener, PFN_on_event on_event, i16 priority) {
     if (!state_ptr) {
         return false;
     }
 
-    // create the array if it doesn't exist
-    if (state_ptr->registered[code].events == 0) {
-        state_ptr->registered[code].events = darray_create(registered_event);
+    // create the entry if it doesn't exist
+    event_code_entry* entry = event_find_entry(code);
+    if (!entry) {
+        entry = event_create_entry(code);
+        if (!entry) {
+            return false;
+        }
     }
 
     // check if the listener is already registered
-    u64 registered_count = darray_length(state_ptr->registered[code].events);
+    u64 registered_count = darray_length(entry->callbacks);
     for (u64 i = 0; i < registered_count; ++i) {
-        registered_event *event = &state_ptr->registered[code].events[i];
-        if (event->listener == listener && event->callback == on_event) {
+        if (entry->listeners[i] == listener && entry->callbacks[i] == on_event) {
             LOG_WARN("Event listener already registered");
             return false;
         }
     }
 
-    // register
-    registered_event event = {listener, on_event};
-    darray_push(state_ptr->registered[code].events, event);
+    // find the insertion point: after every listener with a priority >= this one,
+    // so listeners of equal priority keep their registration order
+    u64 index = 0;
+    while (index < registered_count && entry->priorities[index] >= priority) {
+        index++;
+    }
+
+    // grow the arrays by one, then shift the tail to open the slot
+    darray_push(entry->callbacks, on_event);
+    darray_push(entry->listeners, listener);
+    darray_push(entry->priorities, priority);
+#ifdef cEVENT_PROFILING_ENABLED
+    darray_push(entry->listener_calls, (u64)0);
+    darray_push(entry->listener_ticks, (u64)0);
+#endif
+    for (u64 i = registered_count; i > index; --i) {
+        entry->callbacks[i] = entry->callbacks[i - 1];
+        entry->listeners[i] = entry->listeners[i - 1];
+        entry->priorities[i] = entry->priorities[i - 1];
+#ifdef cEVENT_PROFILING_ENABLED
+        entry->listener_calls[i] = entry->listener_calls[i - 1];
+        entry->listener_ticks[i] = entry->listener_ticks[i - 1];
+#endif
+    }
+    entry->callbacks[index] = on_event;
+    entry->listeners[index] = listener;
+    entry->priorities[index] = priority;
+#ifdef cEVENT_PROFILING_ENABLED
+    entry->listener_calls[index] = 0;
+    entry->listener_ticks[index] = 0;
+#endif
 
-    LOG_TRACE("Event listener registered for code %d (callback: %p)", code, on_event);
+    LOG_TRACE("Event listener registered for code %d (callback: %p, priority: %d)", code, on_event, priority);
 
     return true;
 }
@@ -87,19 +252,39 @@ b8 event_unregister(u16 code, void *listener, PFN_on_event on_event) {
         return false;
     }
 
-    // if nothign is registered of the code, return false
-    if (state_ptr->registered[code].events == 0) {
+    // if nothing is registered of the code, return false
+    event_code_entry* entry = event_find_entry(code);
+    if (!entry || darray_length(entry->callbacks) == 0) {
         LOG_WARN("No events registered for code %d", code);
         return false;
     }
 
-    // check if the listener is already registered
-    u64 registered_count = darray_length(state_ptr->registered[code].events);
+    u64 registered_count = darray_length(entry->callbacks);
     for (u64 i = 0; i < registered_count; ++i) {
-        registered_event event = state_ptr->registered[code].events[i];
-        if (event.listener == listener && event.callback == on_event) {
-            registered_event popped;
-            darray_pop_at(state_ptr->registered[code].events, i, &popped);
+        if (entry->listeners[i] == listener && entry->callbacks[i] == on_event) {
+            // shift the tail down to keep the priority order, then drop the last slot
+            for (u64 j = i; j < registered_count - 1; ++j) {
+                entry->callbacks[j] = entry->callbacks[j + 1];
+                entry->listeners[j] = entry->listeners[j + 1];
+                entry->priorities[j] = entry->priorities[j + 1];
+#ifdef cEVENT_PROFILING_ENABLED
+                entry->listener_calls[j] = entry->listener_calls[j + 1];
+                entry->listener_ticks[j] = entry->listener_ticks[j + 1];
+#endif
+            }
+
+            PFN_on_event popped_callback;
+            void* popped_listener;
+            i16 popped_priority;
+            darray_pop(entry->callbacks, &popped_callback);
+            darray_pop(entry->listeners, &popped_listener);
+            darray_pop(entry->priorities, &popped_priority);
+#ifdef cEVENT_PROFILING_ENABLED
+            u64 popped_calls;
+            u64 popped_ticks;
+            darray_pop(entry->listener_calls, &popped_calls);
+            darray_pop(entry->listener_ticks, &popped_ticks);
+#endif
             return true;
         }
     }
@@ -114,26 +299,187 @@ b8 event_fire(u16 code, void *sender, event_context context) {
     }
 
     // if nothing is registered of the code, return false
-    if (state_ptr->registered[code].events == 0) {
+    event_code_entry* entry = event_find_entry(code);
+    if (!entry) {
         return false;
     }
-
-    // fire the events
-    u64 registered_count = darray_length(state_ptr->registered[code].events);
-    for (u64 i = 0; i < registered_count; ++i) {
-        registered_event event = state_ptr->registered[code].events[i];
-        if (event.callback(code, sender, event.listener, context)) {
-            return true;
+#ifdef cEVENT_PROFILING_ENABLED
+    // only codes that have or had listeners are counted, firing never creates an entry
+    entry->fire_count++;
+#endif
+
+    // fire the events, highest priority first. A listener can register or unregister on this
+    // code, which may move the arrays: they are read again after every call
+    b8 handled = false;
+    state_ptr->fire_depth++;
+    for (u64 i = 0; i < darray_length(entry->callbacks); ++i) {
+#ifdef cEVENT_PROFILING_ENABLED
+        u64 start = platform_get_ticks();
+        handled = entry->callbacks[i](code, sender, entry->listeners[i], context);
+        if (i < darray_length(entry->listener_ticks)) {
+            entry->listener_ticks[i] += platform_get_ticks() - start;
+            entry->listener_calls[i]++;
         }
+        if (handled) {
+            entry->handled_count++;
+            break;
+        }
+#else
+        if (entry->callbacks[i](code, sender, entry->listeners[i], context)) {
+            handled = true;
+            break;
+        }
+#endif
     }
+    state_ptr->fire_depth--;
 
-    return false;
+    return handled;
 }
 
+b8 event_fire_payload(u16 code, void *sender, const void *payload, u64 size) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    // don't spend arena space if nobody listens
+    event_code_entry* entry = event_find_entry(code);
+    if (!entry || darray_length(entry->callbacks) == 0) {
+        return false;
+    }
+
+    u64 aligned_size = (size + EVENT_PAYLOAD_ALIGNMENT - 1) & ~((u64)EVENT_PAYLOAD_ALIGNMENT - 1);
+    void* block = linear_allocator_allocate(&state_ptr->payload_arena, aligned_size);
+    if (!block) {
+        LOG_WARN("Event payload arena is full, event %d with %llu bytes was dropped", code, size);
+        return false;
+    }
+    ccopy_memory(block, payload, size);
+
+    event_context context;
+    context.data.payload.data = block;
+    context.data.payload.size = size;
+    return event_fire(code, sender, context);
+}
+
+void event_frame_reset() {
+    if (state_ptr) {
+        // every payload is copied over its block, so the arena is only rewound, not zeroed
+        state_ptr->payload_arena.allocated = 0;
+    }
+}
 
+#ifdef cEVENT_PROFILING_ENABLED
 
+b8 event_profiling_get_code_stats(u16 code, event_code_stats* out_stats) {
+    if (!state_ptr || !out_stats) {
+        return false;
+    }
 
+    event_code_entry* entry = event_find_entry(code);
+    if (!entry) {
+        return false;
+    }
 
+    out_stats->code = code;
+    out_stats->fire_count = entry->fire_count;
+    out_stats->handled_count = entry->handled_count;
+    out_stats->listener_count = (u32)darray_length(entry->callbacks);
+    u64 total_ticks = 0;
+    for (u32 i = 0; i < out_stats->listener_count; ++i) {
+        total_ticks += entry->listener_ticks[i];
+    }
+    out_stats->total_listener_time = platform_ticks_to_seconds(total_ticks);
+    return true;
+}
 
+typedef struct event_listener_report {
+    u16 code;
+    void* listener;
+    PFN_on_event callback;
+    u64 calls;
+    f64 time;
+} event_listener_report;
 
+void event_profiling_report(u32 top_n) {
+    if (!state_ptr) {
+        return;
+    }
+
+    // codes sorted by fire count (insertion sort, there are only a few codes)
+    event_code_entry* codes[MAX_EVENT_CODE_ENTRIES];
+    u32 code_count = 0;
+    u64 total_fires = 0;
+    u64 total_handled = 0;
+    event_listener_report* listeners = darray_create(event_listener_report);
+    for (u32 i = 0; i < state_ptr->entry_count; ++i) {
+        event_code_entry* entry = &state_ptr->entries[i];
+        total_fires += entry->fire_count;
+        total_handled += entry->handled_count;
+
+        u32 j = code_count++;
+        while (j > 0 && codes[j - 1]->fire_count < entry->fire_count) {
+            codes[j] = codes[j - 1];
+            j--;
+        }
+        codes[j] = entry;
+
+        u64 listener_count = darray_length(entry->callbacks);
+        for (u64 l = 0; l < listener_count; ++l) {
+            event_listener_report r = {entry->code, entry->listeners[l], entry->callbacks[l], entry->listener_calls[l], platform_ticks_to_seconds(entry->listener_ticks[l])};
+            darray_push(listeners, r);
+        }
+    }
+
+    // listeners sorted by cumulative time
+    u64 listener_count = darray_length(listeners);
+    for (u64 i = 1; i < listener_count; ++i) {
+        event_listener_report r = listeners[i];
+        u64 j = i;
+        while (j > 0 && listeners[j - 1].time < r.time) {
+            listeners[j] = listeners[j - 1];
+            j--;
+        }
+        listeners[j] = r;
+    }
+
+    f64 handled_ratio = total_fires ? (f64)total_handled / (f64)total_fires : 0.0;
+    LOG_INFO("Event profiling: %llu fires, %.1f%% handled / %.1f%% propagated to the end",
+             total_fires, handled_ratio * 100.0, (1.0 - handled_ratio) * 100.0);
+
+    LOG_INFO("Top %u event codes by fire count:", top_n);
+    for (u32 i = 0; i < code_count && i < top_n; ++i) {
+        event_code_entry* entry = codes[i];
+        f64 ratio = entry->fire_count ? (f64)entry->handled_count / (f64)entry->fire_count : 0.0;
+        LOG_INFO("  code 0x%04x: %llu fires, %.1f%% handled, %llu listener(s)",
+                 entry->code, entry->fire_count, ratio * 100.0, darray_length(entry->callbacks));
+    }
+
+    LOG_INFO("Top %u event listeners by cumulative time:", top_n);
+    for (u64 i = 0; i < listener_count && i < top_n; ++i) {
+        event_listener_report* r = &listeners[i];
+        f64 average_us = r->calls ? (r->time * 1e6) / (f64)r->calls : 0.0;
+        LOG_INFO("  code 0x%04x callback %p (listener %p): %llu calls, %.3f ms total, %.3f us avg",
+                 r->code, r->callback, r->listener, r->calls, r->time * 1e3, average_us);
+    }
+
+    darray_destroy(listeners);
+}
+
+void event_profiling_reset() {
+    if (!state_ptr) {
+        return;
+    }
+
+    for (u32 i = 0; i < state_ptr->entry_count; ++i) {
+        event_code_entry* entry = &state_ptr->entries[i];
+        entry->fire_count = 0;
+        entry->handled_count = 0;
+        u64 listener_count = darray_length(entry->callbacks);
+        for (u64 l = 0; l < listener_count; ++l) {
+            entry->listener_calls[l] = 0;
+            entry->listener_ticks[l] = 0;
+        }
+    }
+}
 
+#endif
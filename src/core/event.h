@@ -4,7 +4,7 @@
 
 
 typedef struct event_context {
-    // max size of event data is 128 bytes
+    // max size of event data is 128 bits (16 bytes). Bigger data goes through event_fire_payload
     union {
         i64 i64[2];
         u64 u64[2];
@@ -21,6 +21,13 @@ typedef struct event_context {
         u8 u8[16];
 
         char c[16];
+
+        // Used by event_fire_payload. The data lives in the event frame arena and
+        // is only valid until the next call to event_frame_reset (end of the frame)
+        struct {
+            const void* data;
+            u64 size;
+        } payload;
     } data;
 } event_context;
 
@@ -40,6 +47,22 @@ void event_shutdown();
  */
 b8 event_register(u16 code, void* listener, PFN_on_event on_event);
 
+// Priorities used by event_register_priority. Listeners with a higher priority are called first
+#define EVENT_PRIORITY_LOW     -100
+#define EVENT_PRIORITY_NORMAL  0
+#define EVENT_PRIORITY_HIGH    100
+
+/**
+ * Same as event_register, but the listener is called before every listener of a lower priority.
+ * Listeners sharing the same priority are called in registration order.
+ * @param code The event code to listen for
+ * @param listener The listener instance that will be passed to the callback
+ * @param on_event The callback to be called when the event is sent
+ * @param priority The dispatch priority (higher first). event_register uses EVENT_PRIORITY_NORMAL
+ * @return true if the event was registered, false if the event was not registered
+ */
+b8 event_register_priority(u16 code, void* listener, PFN_on_event on_event, i16 priority);
+
 /**
  * Unregister a listener from an event are sent with the given code. If no matching
  * registration is found, this function returns false.
@@ -52,6 +75,63 @@ b8 event_unregister(u16 code, void* listener, PFN_on_event on_event);
 
 b8 event_fire(u16 code, void* sender, event_context data);
 
+/**
+ * Fire an event carrying more data than fits in event_context. The payload is copied into
+ * a per-frame arena owned by the event system and referenced by data.payload, so no heap
+ * allocation is made. Listeners must copy what they need to keep past the current frame.
+ * @param code The event code to fire
+ * @param sender The sender of the event
+ * @param payload The data to copy and send
+ * @param size The size of the data in bytes
+ * @return true if the event was handled, false if not handled or if the arena is full
+ */
+b8 event_fire_payload(u16 code, void* sender, const void* payload, u64 size);
+
+/**
+ * Release every payload allocated during the frame. Called once per frame by the application,
+ * after which the payload pointers handed out by event_fire_payload are invalid.
+ */
+void event_frame_reset();
+
+// Define cEVENT_PROFILING_ENABLED (CMake option CENGINE_EVENT_PROFILING) to instrument event_fire.
+// When it is not defined the profiling functions below compile to nothing.
+#ifdef cEVENT_PROFILING_ENABLED
+
+typedef struct event_code_stats {
+    u16 code;
+    u64 fire_count;
+    // fires stopped by a listener returning true. The others went through every listener
+    u64 handled_count;
+    u32 listener_count;
+    // cumulative time spent in the listeners of this code, in seconds
+    f64 total_listener_time;
+} event_code_stats;
+
+/**
+ * Get the profiling counters of an event code
+ * @param code The event code to query
+ * @param out_stats A pointer to the stats to fill
+ * @return true if the code has or had listeners, false otherwise. Fires of codes that never
+ * had a listener are not counted
+ */
+b8 event_profiling_get_code_stats(u16 code, event_code_stats* out_stats);
+
+/**
+ * Log the global handled/propagated ratio, the top_n most fired codes and
+ * the top_n listeners with the highest cumulative time
+ */
+void event_profiling_report(u32 top_n);
+
+// Reset every counter, e.g. to only measure a given part of a session
+void event_profiling_reset();
+
+#else
+
+#define event_profiling_report(top_n)
+#define event_profiling_reset()
+
+#endif
+
 typedef enum system_event_code {
     // Shutdown the application
     EVENT_CODE_APPLICATION_QUIT = 0x01,
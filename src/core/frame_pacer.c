@@ -0,0 +1,91 @@
+#include "frame_pacer.h"
+
+#include "logger.h"
+#include "math/cmath.h"
+#include "platform/platform.h"
+
+static void frame_pacer_reset_stats(frame_pacer* pacer) {
+    pacer->frame_count = 0;
+    pacer->missed_count = 0;
+    pacer->frame_time_sum = 0;
+    pacer->frame_time_square_sum = 0;
+    pacer->frame_time_min = 0;
+    pacer->frame_time_max = 0;
+}
+
+void frame_pacer_create(u32 target_fps, frame_pacer* out_pacer) {
+    out_pacer->spin_seconds = FRAME_PACER_DEFAULT_SPIN_SECONDS;
+    frame_pacer_set_target(out_pacer, target_fps);
+    frame_pacer_reset_stats(out_pacer);
+    out_pacer->last_frame_end = platform_get_absolute_time();
+    out_pacer->next_deadline = out_pacer->last_frame_end + out_pacer->target_frame_seconds;
+}
+
+void frame_pacer_set_target(frame_pacer* pacer, u32 target_fps) {
+    pacer->target_frame_seconds = target_fps ? 1.0 / target_fps : 0.0;
+    pacer->next_deadline = platform_get_absolute_time() + pacer->target_frame_seconds;
+}
+
+void frame_pacer_wait(frame_pacer* pacer) {
+    f64 now = platform_get_absolute_time();
+
+    if (pacer->target_frame_seconds > 0) {
+        f64 deadline = pacer->next_deadline;
+        if (now > deadline) {
+            pacer->missed_count++;
+        } else {
+            // coarse sleep, then spin for the last part since waking up is not precise
+            if (deadline - now > pacer->spin_seconds) {
+                platform_sleep_until(deadline - pacer->spin_seconds);
+            }
+            while ((now = platform_get_absolute_time()) < deadline) {
+                platform_cpu_relax();
+            }
+        }
+
+        // keep a fixed cadence, but don't try to catch up after a long frame
+        pacer->next_deadline = deadline + pacer->target_frame_seconds;
+        if (pacer->next_deadline < now) {
+            pacer->next_deadline = now + pacer->target_frame_seconds;
+        }
+    }
+
+    f64 frame_time = now - pacer->last_frame_end;
+    pacer->last_frame_end = now;
+    if (pacer->frame_count == 0 || frame_time < pacer->frame_time_min) {
+        pacer->frame_time_min = frame_time;
+    }
+    if (frame_time > pacer->frame_time_max) {
+        pacer->frame_time_max = frame_time;
+    }
+    pacer->frame_time_sum += frame_time;
+    pacer->frame_time_square_sum += frame_time * frame_time;
+    pacer->frame_count++;
+}
+
+b8 frame_pacer_get_stats(const frame_pacer* pacer, f64* out_average, f64* out_jitter, f64* out_min, f64* out_max) {
+    if (pacer->frame_count == 0) {
+        return false;
+    }
+
+    f64 average = pacer->frame_time_sum / pacer->frame_count;
+    f64 variance = pacer->frame_time_square_sum / pacer->frame_count - average * average;
+    *out_average = average;
+    // jitter is the standard deviation of the frame time
+    *out_jitter = variance > 0 ? c_sqrt(variance) : 0;
+    *out_min = pacer->frame_time_min;
+    *out_max = pacer->frame_time_max;
+    return true;
+}
+
+void frame_pacer_report(frame_pacer* pacer) {
+    f64 average, jitter, min, max;
+    if (!frame_pacer_get_stats(pacer, &average, &jitter, &min, &max)) {
+        return;
+    }
+
+    LOG_DEBUG("Frame pacing: %llu frames, avg %.3f ms (%.1f fps), jitter %.3f ms, min %.3f ms, max %.3f ms, %llu missed",
+              pacer->frame_count, average * 1000.0, 1.0 / average, jitter * 1000.0, min * 1000.0, max * 1000.0,
+              pacer->missed_count);
+    frame_pacer_reset_stats(pacer);
+}
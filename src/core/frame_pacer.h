@@ -0,0 +1,47 @@
+#pragma once
+
+#include "define.h"
+
+/**
+ * Frame limiter: sleeps for the bulk of the remaining frame time, then spin-waits for the
+ * last part so frames end on time without burning a core. It also keeps frame time
+ * statistics to measure the jitter.
+ */
+typedef struct frame_pacer {
+    f64 target_frame_seconds; // 0 for uncapped
+    f64 spin_seconds;         // the end of the frame spent spinning instead of sleeping
+    f64 next_deadline;
+
+    // frame time statistics since the last report
+    f64 last_frame_end;
+    u64 frame_count;
+    u64 missed_count; // frames that ended after their deadline
+    f64 frame_time_sum;
+    f64 frame_time_square_sum;
+    f64 frame_time_min;
+    f64 frame_time_max;
+} frame_pacer;
+
+// Default time spent spinning before each deadline, covers the usual wake-up latency of a sleep
+#define FRAME_PACER_DEFAULT_SPIN_SECONDS 0.001
+
+/**
+ * @param target_fps frames per second to pace to, 0 for uncapped
+ * @param out_pacer the pacer to initialize
+ */
+void frame_pacer_create(u32 target_fps, frame_pacer* out_pacer);
+
+// Change the target, 0 for uncapped. The statistics are kept
+void frame_pacer_set_target(frame_pacer* pacer, u32 target_fps);
+
+// Wait for the end of the current frame and record its duration. Call once per frame
+void frame_pacer_wait(frame_pacer* pacer);
+
+/**
+ * Frame time statistics since the last reset, in seconds.
+ * @return false if no frame was recorded
+ */
+b8 frame_pacer_get_stats(const frame_pacer* pacer, f64* out_average, f64* out_jitter, f64* out_min, f64* out_max);
+
+// Log the frame time statistics (average, jitter, min, max, missed deadlines) and reset them
+void frame_pacer_report(frame_pacer* pacer);
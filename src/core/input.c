@@ -3,6 +3,19 @@
 #include "core/event.h"
 #include "core/cmemory.h"
 #include "core/logger.h"
+#include "platform/filesystem.h"
+#include "platform/platform.h"
+
+/*
+ * Input recording file: a header (magic, version) followed by one record per frame:
+ * f64 delta, u16 event count, then per event u8 type, u8 pressed, u16 code, i16 x, i16 y
+ * and f32 time since the start of the recording.
+ */
+#define INPUT_RECORDING_MAGIC 0x43455243 // "CREC"
+#define INPUT_RECORDING_VERSION 1
+#define INPUT_RECORDING_HEADER_SIZE 8
+#define INPUT_RECORDING_FRAME_HEADER_SIZE (sizeof(f64) + sizeof(u16))
+#define INPUT_RECORDING_EVENT_SIZE 12
 
 typedef struct keyboard_state {
     b8 keys[256];
@@ -25,6 +38,25 @@ typedef struct input_state {
 typedef struct input_system_state {
     b8 initialized;
     input_state state;
+
+    // every transition, the current frame is [frame_event_start, event_write_count)
+    input_event events[INPUT_EVENT_BUFFER_SIZE];
+    u64 event_write_count;
+    u64 frame_event_start;
+
+    // recording, written by update_input
+    b8 recording;
+    file_handle recording_file;
+    f64 recording_start_time;
+    u8 recording_frame[INPUT_RECORDING_FRAME_HEADER_SIZE + INPUT_RECORDING_EVENT_SIZE * INPUT_EVENT_BUFFER_SIZE];
+
+    // replay, the whole file is loaded at start
+    b8 replaying;
+    b8 feeding_replay; // input_process_* calls come from the replay, not the platform
+    u8* replay_data;
+    u64 replay_size;
+    u64 replay_offset;
+    f64 replay_start_time;
 } input_system_state;
 
 static input_system_state* state_ptr;
@@ -36,8 +68,8 @@ b8 initialize_input(u64* memory_requirement, void* state) {
     }
 
     state_ptr = state;
+    czero_memory(state_ptr, sizeof(input_system_state));
     state_ptr->initialized = true;
-    czero_memory(&state_ptr->state, sizeof(input_state));
     LOG_INFO("Input initialized");
     return true;
 }
@@ -48,30 +80,78 @@ void shutdown_input() {
         return;
     }
 
+    input_recording_stop();
+    input_replay_stop();
+
     state_ptr->initialized = false;
     state_ptr = 0;
 }
 
+static void input_recording_write_frame(f64 delta_time);
+
 void update_input(f64 delta_time) {
     if (!state_ptr || !state_ptr->initialized) {
         LOG_WARN("Input not initialized. Do not call update_input before calling initialize_input.");
         return;
     }
 
-    // copy the current state to the previous state
-    ccopy_memory(&state_ptr->state.keyboard_previous, &state_ptr->state.keyboard_current, sizeof(keyboard_state));
-    ccopy_memory(&state_ptr->state.mouse_previous, &state_ptr->state.mouse_current, sizeof(mouse_state));
+    if (state_ptr->recording) {
+        input_recording_write_frame(delta_time);
+    }
+
+    input_state* input = &state_ptr->state;
+    u64 end = state_ptr->event_write_count;
+    if (end - state_ptr->frame_event_start > INPUT_EVENT_BUFFER_SIZE) {
+        // some events were overwritten, copy the whole current state to the previous state
+        ccopy_memory(&input->keyboard_previous, &input->keyboard_current, sizeof(keyboard_state));
+        ccopy_memory(&input->mouse_previous, &input->mouse_current, sizeof(mouse_state));
+    } else {
+        // only what changed this frame differs from the previous state
+        for (u64 i = state_ptr->frame_event_start; i < end; ++i) {
+            const input_event* e = &state_ptr->events[i & (INPUT_EVENT_BUFFER_SIZE - 1)];
+            switch (e->type) {
+                case INPUT_EVENT_KEY:
+                    input->keyboard_previous.keys[e->code] = input->keyboard_current.keys[e->code];
+                    break;
+                case INPUT_EVENT_BUTTON:
+                    input->mouse_previous.buttons[e->code] = input->mouse_current.buttons[e->code];
+                    break;
+                case INPUT_EVENT_MOUSE_MOVE:
+                    input->mouse_previous.x = input->mouse_current.x;
+                    input->mouse_previous.y = input->mouse_current.y;
+                    break;
+            }
+        }
+    }
+
+    state_ptr->frame_event_start = end;
 }
 
-void input_process_key(keys key, b8 pressed) {
+static void input_record_event(input_event_type type, u16 code, i16 x, i16 y, b8 pressed, f64 timestamp) {
+    input_event* e = &state_ptr->events[state_ptr->event_write_count & (INPUT_EVENT_BUFFER_SIZE - 1)];
+    e->timestamp = timestamp;
+    e->code = code;
+    e->x = x;
+    e->y = y;
+    e->type = type;
+    e->pressed = pressed;
+    state_ptr->event_write_count++;
+}
+
+void input_process_key(keys key, b8 pressed, f64 timestamp) {
     if (!state_ptr || !state_ptr->initialized) {
         LOG_WARN("Input not initialized. Do not call input_process_key before calling initialize_input.");
         return;
     }
+    if (state_ptr->replaying && !state_ptr->feeding_replay) {
+        // the replay owns the input
+        return;
+    }
 
     // only handle if the key state actually changed
     if (state_ptr->state.keyboard_current.keys[key] != pressed) {
         state_ptr->state.keyboard_current.keys[key] = pressed;
+        input_record_event(INPUT_EVENT_KEY, key, 0, 0, pressed, timestamp);
 
         if (key == KEY_LALT) {
             LOG_INFO("Left Alt key %s", pressed ? "pressed" : "released");
@@ -85,15 +165,20 @@ void input_process_key(keys key, b8 pressed) {
     }
 }
 
-void input_process_button(buttons button, b8 pressed) {
+void input_process_button(buttons button, b8 pressed, f64 timestamp) {
     if (!state_ptr || !state_ptr->initialized) {
         LOG_WARN("Input not initialized. Do not call input_process_button before calling initialize_input.");
         return;
     }
+    if (state_ptr->replaying && !state_ptr->feeding_replay) {
+        // the replay owns the input
+        return;
+    }
 
     // only handle if the button state actually changed
     if (state_ptr->state.mouse_current.buttons[button] != pressed) {
         state_ptr->state.mouse_current.buttons[button] = pressed;
+        input_record_event(INPUT_EVENT_BUTTON, button, 0, 0, pressed, timestamp);
 
         event_context context;
         context.data.u16[0] = button;
@@ -101,15 +186,20 @@ void input_process_button(buttons button, b8 pressed) {
     }
 }
 
-void input_process_mouse_move(i16 x, i16 y) {
+void input_process_mouse_move(i16 x, i16 y, f64 timestamp) {
     if (!state_ptr || !state_ptr->initialized) {
         LOG_WARN("Input not initialized. Do not call input_process_mouse_move before calling initialize_input.");
         return;
     }
+    if (state_ptr->replaying && !state_ptr->feeding_replay) {
+        // the replay owns the input
+        return;
+    }
 
     if (state_ptr->state.mouse_current.x != x || state_ptr->state.mouse_current.y != y) {
         state_ptr->state.mouse_current.x = x;
         state_ptr->state.mouse_current.y = y;
+        input_record_event(INPUT_EVENT_MOUSE_MOVE, 0, x, y, false, timestamp);
 
         event_context context;
         context.data.u16[0] = x;
@@ -118,11 +208,17 @@ void input_process_mouse_move(i16 x, i16 y) {
     }
 }
 
-void input_process_mouse_wheel(i8 z_delta) {
+void input_process_mouse_wheel(i8 z_delta, f64 timestamp) {
     if (!state_ptr || !state_ptr->initialized) {
         LOG_WARN("Input not initialized. Do not call input_process_mouse_wheel before calling initialize_input.");
         return;
     }
+    if (state_ptr->replaying && !state_ptr->feeding_replay) {
+        // the replay owns the input
+        return;
+    }
+
+    input_record_event(INPUT_EVENT_MOUSE_WHEEL, 0, z_delta, 0, false, timestamp);
 
     event_context context;
     context.data.u8[0] = z_delta;
@@ -183,6 +279,23 @@ b8 input_is_button_up(buttons button) {
     return state_ptr->state.mouse_current.buttons[button] == false;
 }
 
+b8 input_was_button_down(buttons button) {
+    if (!state_ptr || !state_ptr->initialized) {
+        LOG_WARN("Input not initialized. Do not call input_was_button_down before calling initialize_input.");
+        return false;
+    }
+
+    return state_ptr->state.mouse_previous.buttons[button] == true;
+}
+
+b8 input_was_button_up(buttons button) {
+    if (!state_ptr || !state_ptr->initialized) {
+        LOG_WARN("Input not initialized. Do not call input_was_button_up before calling initialize_input.");
+        return true;
+    }
+
+    return state_ptr->state.mouse_previous.buttons[button] == false;
+}
 
 void input_get_mouse_pos(i32* x, i32* y) {
     if (!state_ptr || !state_ptr->initialized) {
@@ -213,3 +326,229 @@ void input_get_previous_mouse_pos(i32* x, i32* y) {
 
 
 
+
+// First event of the current frame still in the ring
+static u64 input_frame_first_event() {
+    u64 end = state_ptr->event_write_count;
+    u64 start = state_ptr->frame_event_start;
+    if (end - start > INPUT_EVENT_BUFFER_SIZE) {
+        start = end - INPUT_EVENT_BUFFER_SIZE;
+    }
+    return start;
+}
+
+static u32 input_count_presses(input_event_type type, u16 code) {
+    u32 count = 0;
+    for (u64 i = input_frame_first_event(); i < state_ptr->event_write_count; ++i) {
+        const input_event* e = &state_ptr->events[i & (INPUT_EVENT_BUFFER_SIZE - 1)];
+        if (e->type == type && e->code == code && e->pressed) {
+            count++;
+        }
+    }
+    return count;
+}
+
+u32 input_key_press_count(keys key) {
+    if (!state_ptr || !state_ptr->initialized) {
+        LOG_WARN("Input not initialized. Do not call input_key_press_count before calling initialize_input.");
+        return 0;
+    }
+
+    return input_count_presses(INPUT_EVENT_KEY, key);
+}
+
+u32 input_button_press_count(buttons button) {
+    if (!state_ptr || !state_ptr->initialized) {
+        LOG_WARN("Input not initialized. Do not call input_button_press_count before calling initialize_input.");
+        return 0;
+    }
+
+    return input_count_presses(INPUT_EVENT_BUTTON, button);
+}
+
+u32 input_frame_event_count() {
+    if (!state_ptr || !state_ptr->initialized) {
+        return 0;
+    }
+
+    return (u32)(state_ptr->event_write_count - input_frame_first_event());
+}
+
+u32 input_get_frame_events(input_event* out_events, u32 max_count) {
+    if (!state_ptr || !state_ptr->initialized) {
+        LOG_WARN("Input not initialized. Do not call input_get_frame_events before calling initialize_input.");
+        return 0;
+    }
+
+    u32 count = 0;
+    for (u64 i = input_frame_first_event(); i < state_ptr->event_write_count && count < max_count; ++i) {
+        out_events[count++] = state_ptr->events[i & (INPUT_EVENT_BUFFER_SIZE - 1)];
+    }
+    return count;
+}
+
+// ---- recording and replay ----
+
+static u8* write_bytes(u8* dest, const void* value, u64 size) {
+    ccopy_memory(dest, value, size);
+    return dest + size;
+}
+
+static void input_recording_write_frame(f64 delta_time) {
+    u64 start = input_frame_first_event();
+    u16 count = (u16)(state_ptr->event_write_count - start);
+
+    u8* at = write_bytes(state_ptr->recording_frame, &delta_time, sizeof(f64));
+    at = write_bytes(at, &count, sizeof(u16));
+    for (u64 i = start; i < state_ptr->event_write_count; ++i) {
+        const input_event* e = &state_ptr->events[i & (INPUT_EVENT_BUFFER_SIZE - 1)];
+        f32 time = (f32)(e->timestamp - state_ptr->recording_start_time);
+        at = write_bytes(at, &e->type, sizeof(u8));
+        at = write_bytes(at, &e->pressed, sizeof(u8));
+        at = write_bytes(at, &e->code, sizeof(u16));
+        at = write_bytes(at, &e->x, sizeof(i16));
+        at = write_bytes(at, &e->y, sizeof(i16));
+        at = write_bytes(at, &time, sizeof(f32));
+    }
+
+    u64 size = at - state_ptr->recording_frame;
+    u64 written = 0;
+    if (!filesystem_write(&state_ptr->recording_file, size, state_ptr->recording_frame, &written)) {
+        LOG_ERROR("Failed to write the input recording, stopping it");
+        input_recording_stop();
+    }
+}
+
+b8 input_recording_start(const char* path) {
+    if (!state_ptr || !state_ptr->initialized) {
+        LOG_WARN("Input not initialized. Do not call input_recording_start before calling initialize_input.");
+        return false;
+    }
+    input_recording_stop();
+
+    if (!filesystem_open(path, FILE_MODE_WRITE, true, &state_ptr->recording_file)) {
+        LOG_ERROR("Failed to open input recording '%s'", path);
+        return false;
+    }
+    u32 header[2] = {INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION};
+    u64 written = 0;
+    filesystem_write(&state_ptr->recording_file, INPUT_RECORDING_HEADER_SIZE, header, &written);
+
+    // the events already received belong to the first recorded frame
+    state_ptr->recording_start_time = platform_get_absolute_time();
+    state_ptr->recording = true;
+    LOG_INFO("Recording input to '%s'", path);
+    return true;
+}
+
+void input_recording_stop() {
+    if (!state_ptr || !state_ptr->recording) {
+        return;
+    }
+    filesystem_close(&state_ptr->recording_file);
+    state_ptr->recording = false;
+}
+
+b8 input_replay_start(const char* path) {
+    if (!state_ptr || !state_ptr->initialized) {
+        LOG_WARN("Input not initialized. Do not call input_replay_start before calling initialize_input.");
+        return false;
+    }
+    input_replay_stop();
+
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_READ, true, &file)) {
+        LOG_ERROR("Failed to open input recording '%s'", path);
+        return false;
+    }
+    u64 size = 0;
+    filesystem_size(&file, &size);
+    if (size < INPUT_RECORDING_HEADER_SIZE) {
+        LOG_ERROR("'%s' is not an input recording", path);
+        filesystem_close(&file);
+        return false;
+    }
+
+    u8* data = callocate(size, MEMORY_TAG_ARRAY);
+    u64 read = 0;
+    b8 result = filesystem_read_all_bytes(&file, data, &read);
+    filesystem_close(&file);
+
+    u32 header[2];
+    ccopy_memory(header, data, INPUT_RECORDING_HEADER_SIZE);
+    if (!result || header[0] != INPUT_RECORDING_MAGIC || header[1] != INPUT_RECORDING_VERSION) {
+        LOG_ERROR("'%s' is not an input recording or can't be read", path);
+        cfree(data, size, MEMORY_TAG_ARRAY);
+        return false;
+    }
+
+    state_ptr->replay_data = data;
+    state_ptr->replay_size = size;
+    state_ptr->replay_offset = INPUT_RECORDING_HEADER_SIZE;
+    state_ptr->replay_start_time = platform_get_absolute_time();
+    state_ptr->replaying = true;
+    LOG_INFO("Replaying input from '%s'", path);
+    return true;
+}
+
+void input_replay_stop() {
+    if (!state_ptr || !state_ptr->replaying) {
+        return;
+    }
+    cfree(state_ptr->replay_data, state_ptr->replay_size, MEMORY_TAG_ARRAY);
+    state_ptr->replay_data = 0;
+    state_ptr->replay_size = 0;
+    state_ptr->replaying = false;
+}
+
+b8 input_is_replaying() {
+    return state_ptr && state_ptr->replaying;
+}
+
+b8 input_replay_next_frame(f64* out_delta) {
+    if (!state_ptr || !state_ptr->replaying) {
+        return false;
+    }
+
+    const u8* data = state_ptr->replay_data;
+    u64 offset = state_ptr->replay_offset;
+    u16 count = 0;
+    if (offset + INPUT_RECORDING_FRAME_HEADER_SIZE > state_ptr->replay_size) {
+        input_replay_stop();
+        return false;
+    }
+    ccopy_memory(out_delta, data + offset, sizeof(f64));
+    ccopy_memory(&count, data + offset + sizeof(f64), sizeof(u16));
+    offset += INPUT_RECORDING_FRAME_HEADER_SIZE;
+    if (offset + (u64)count * INPUT_RECORDING_EVENT_SIZE > state_ptr->replay_size) {
+        LOG_WARN("Input recording is truncated, stopping the replay");
+        input_replay_stop();
+        return false;
+    }
+
+    state_ptr->feeding_replay = true;
+    for (u16 i = 0; i < count; ++i, offset += INPUT_RECORDING_EVENT_SIZE) {
+        const u8* e = data + offset;
+        u8 type = e[0];
+        b8 pressed = e[1];
+        u16 code;
+        i16 x, y;
+        f32 time;
+        ccopy_memory(&code, e + 2, sizeof(u16));
+        ccopy_memory(&x, e + 4, sizeof(i16));
+        ccopy_memory(&y, e + 6, sizeof(i16));
+        ccopy_memory(&time, e + 8, sizeof(f32));
+        f64 timestamp = state_ptr->replay_start_time + time;
+
+        switch (type) {
+            case INPUT_EVENT_KEY: input_process_key((keys)code, pressed, timestamp); break;
+            case INPUT_EVENT_BUTTON: input_process_button((buttons)code, pressed, timestamp); break;
+            case INPUT_EVENT_MOUSE_MOVE: input_process_mouse_move(x, y, timestamp); break;
+            case INPUT_EVENT_MOUSE_WHEEL: input_process_mouse_wheel((i8)x, timestamp); break;
+        }
+    }
+    state_ptr->feeding_replay = false;
+
+    state_ptr->replay_offset = offset;
+    return true;
+}
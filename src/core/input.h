@@ -133,8 +133,32 @@ typedef enum keys {
     KEYS_MAX_KEYS
 } keys;
 
+// Number of events kept by the input event ring, must be a power of 2
+#define INPUT_EVENT_BUFFER_SIZE 1024
+
+typedef enum input_event_type {
+    INPUT_EVENT_KEY = 0,
+    INPUT_EVENT_BUTTON = 1,
+    INPUT_EVENT_MOUSE_MOVE = 2,
+    INPUT_EVENT_MOUSE_WHEEL = 3,
+} input_event_type;
+
+/**
+ * One input transition as received from the platform layer.
+ * For a mouse move x/y is the new position, for a wheel x is the delta.
+ */
+typedef struct input_event {
+    f64 timestamp; // platform_get_absolute_time when the platform dequeued the event
+    u16 code;      // key or button
+    i16 x;
+    i16 y;
+    u8 type;
+    b8 pressed;
+} input_event;
+
 b8 initialize_input(u64* memory_requirement, void* state);
 void shutdown_input();
+// End the input frame: the current state becomes the previous state and the frame events are cleared
 void update_input(f64 delta);
 
 // key curretly down or up?
@@ -145,7 +169,7 @@ b8 input_is_key_up(keys key);
 b8 input_was_key_down(keys key);
 b8 input_was_key_up(keys key);
 
-void input_process_key(keys key, b8 pressed);
+void input_process_key(keys key, b8 pressed, f64 timestamp);
 
 b8 input_is_button_down(buttons button);
 b8 input_is_button_up(buttons button);
@@ -154,8 +178,55 @@ b8 input_was_button_up(buttons button);
 void input_get_mouse_pos(i32* x, i32* y);
 void input_get_previous_mouse_pos(i32* x, i32* y);
 
-void input_process_button(buttons button, b8 pressed);
-void input_process_mouse_move(i16 x, i16 y);
-void input_process_mouse_wheel(i8 z_delta);
-
-
+void input_process_button(buttons button, b8 pressed, f64 timestamp);
+void input_process_mouse_move(i16 x, i16 y, f64 timestamp);
+void input_process_mouse_wheel(i8 z_delta, f64 timestamp);
+
+// Number of times the key was pressed since the last frame, even if it was released since
+u32 input_key_press_count(keys key);
+u32 input_button_press_count(buttons button);
+
+// Number of events received since the last frame
+u32 input_frame_event_count();
+
+/**
+ * Copy the events received since the last frame, oldest first. If more than
+ * INPUT_EVENT_BUFFER_SIZE events arrived only the most recent ones are kept.
+ *
+ * @param out_events receives the events
+ * @param max_count the capacity of out_events
+ * @return the number of events copied
+ */
+u32 input_get_frame_events(input_event* out_events, u32 max_count);
+
+
+
+/**
+ * Record the input events and the delta time of every frame into a binary file, written
+ * by update_input. Replaying it gives the same input sequence on every run.
+ *
+ * @param path path of the recording, overwritten if it exists
+ * @return true if the recording started, false otherwise
+ */
+b8 input_recording_start(const char* path);
+void input_recording_stop();
+
+/**
+ * Replay a recording made by input_recording_start. While replaying, the events coming
+ * from the platform are ignored.
+ *
+ * @param path path of the recording
+ * @return true if the recording was loaded, false otherwise
+ */
+b8 input_replay_start(const char* path);
+void input_replay_stop();
+b8 input_is_replaying();
+
+/**
+ * Feed the events of the next recorded frame to the input system. Call once per frame,
+ * before the application update.
+ *
+ * @param out_delta receives the delta time recorded for that frame
+ * @return false once the recording is over, the replay is then stopped
+ */
+b8 input_replay_next_frame(f64* out_delta);
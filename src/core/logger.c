@@ -4,20 +4,87 @@
 
 // temporary implementation
 #include <stdarg.h>
+#include <stdio.h>
+#include <stdatomic.h>
 
 #include "cmemory.h"
+#include "logger_binary.h"
 #include "cstring.h"
+#include "math/cmath.h"
 #include "platform/filesystem.h"
 #include "platform/platform.h"
 
+// Size of the text of one record in the async ring. Longer messages are written synchronously
+#define LOG_RECORD_TEXT_SIZE 500
+// Size of the console and file buffers the writer thread fills before writing
+#define LOG_WRITER_BUFFER_SIZE (64 * 1024)
+// The writer wakes up at least this often even if nobody signals it
+#define LOG_WRITER_WAIT_MS 10
+
+/**
+ * One formatted message in the async ring. The sequence tells producers and
+ * the writer who owns the slot (bounded MPSC queue, one sequence per slot).
+ */
+typedef enum log_record_kind {
+    LOG_RECORD_TEXT = 0,
+    LOG_RECORD_BINARY = 1, // raw bytes for the binary log
+    LOG_RECORD_SKIPPED = 2, // too long for a record, its message is written synchronously
+} log_record_kind;
+
+typedef struct log_record {
+    atomic_ullong sequence;
+    u8 kind;
+    u8 level;
+    u16 length;
+    char text[LOG_RECORD_TEXT_SIZE];
+} log_record;
+
+typedef struct log_async_state {
+    log_record* records;
+    u32 record_count; // power of 2
+    u32 mask;
+
+    atomic_ullong write_position; // next slot to claim by producers
+    atomic_ullong read_position;  // next slot to write out by the writer
+
+    atomic_bool running;
+    atomic_bool writer_sleeping;
+    platform_semaphore wake_semaphore;
+    platform_thread writer_thread;
+
+    char* console_buffer;
+    char* file_buffer;
+    char* binary_buffer;
+} log_async_state;
+
 typedef struct logger_system_state {
     b8 initialized;
 
     file_handle log_file_handle;
+
+    file_handle binary_file_handle;
+    atomic_uint binary_generation; // generation of the open binary log, 0 if none
+
+    b8 async_enabled;
+    log_async_state async;
 } logger_system_state;
 
 static logger_system_state* state_ptr; // copy to the logger state
 
+// Binary log generations and site ids are unique for the whole process, sites are static
+static atomic_uint binary_generation_counter;
+static atomic_uint next_site_id;
+static atomic_flag site_lock = ATOMIC_FLAG_INIT;
+
+// Rate-limited sites hit at least once, pushed on their first call
+static _Atomic(log_limit_site*) limit_sites;
+
+u8 log_channel_levels[LOG_CHANNEL_MAX] = {
+    LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE, LOG_LEVEL_TRACE,
+};
+
+static const char* level_strings[6] = {"[FATAL]", "[ERROR]", "[WARN]", "[INFO]", "[DEBUG]", "[TRACE]"};
+
 b8 initialize_logging(u64* memory_requirement, void* state) {
     *memory_requirement = sizeof(logger_system_state);
     if (state == 0) {
@@ -25,6 +92,7 @@ b8 initialize_logging(u64* memory_requirement, void* state) {
     }
 
     state_ptr = state;
+    czero_memory(state_ptr, sizeof(logger_system_state));
     state_ptr->initialized = true;
 
     // init the log file
@@ -39,13 +107,32 @@ b8 initialize_logging(u64* memory_requirement, void* state) {
 }
 
 void shutdown_logging() {
-    // TODO: Cleaning up logging and write queued entries
+    if (!state_ptr) {
+        return;
+    }
+
+    // write out the queued entries and stop the writer
+    logging_stop_async();
+
+    logging_binary_close();
+    filesystem_close(&state_ptr->log_file_handle);
     state_ptr = 0;
 }
 
-void append_to_log_file(const char* message) {
-    if (state_ptr->log_file_handle.is_valid) {
-        u64 length = string_length(message);
+void logging_set_level(log_level level) {
+    for (u32 i = 0; i < LOG_CHANNEL_MAX; ++i) {
+        log_channel_levels[i] = level;
+    }
+}
+
+void logging_set_channel_level(log_channel channel, log_level level) {
+    if (channel < LOG_CHANNEL_MAX) {
+        log_channel_levels[channel] = level;
+    }
+}
+
+void append_to_log_file(const char* message, u64 length) {
+    if (state_ptr && state_ptr->log_file_handle.is_valid) {
         u64 written = 0;
         if (!filesystem_write(&state_ptr->log_file_handle, length, message, &written)) {
             platform_console_write_error("ERROR: Failed to write to log file", LOG_LEVEL_ERROR);
@@ -53,29 +140,414 @@ void append_to_log_file(const char* message) {
     }
 }
 
-void log_output(log_level level, const char* message, ...) {
-    const char* level_strings[6] = {"[FATAL]", "[ERROR]", "[WARN]", "[INFO]", "[DEBUG]", "[TRACE]"};
+static void append_to_binary_log(const void* data, u64 length) {
+    if (state_ptr && state_ptr->binary_file_handle.is_valid) {
+        u64 written = 0;
+        if (!filesystem_write(&state_ptr->binary_file_handle, length, data, &written)) {
+            platform_console_write_error("ERROR: Failed to write to binary log file", LOG_LEVEL_ERROR);
+        }
+    }
+}
+
+/**
+ * Format "[LEVEL] message\n" into dest in a single pass.
+ * @param out_truncated set to true if the text didn't fit in capacity, can be 0
+ * @return the length of the formatted text, truncated to fit in capacity
+ */
+static u64 log_format(char* dest, u64 capacity, log_level level, const char* message, va_list args, b8* out_truncated) {
+    i32 prefix = snprintf(dest, capacity, "%s ", level_strings[level]);
+    i32 written = vsnprintf(dest + prefix, capacity - prefix - 1, message, args);
+    u64 length = prefix + (written < 0 ? 0 : written);
+    b8 truncated = length > capacity - 2;
+    if (truncated) {
+        length = capacity - 2;
+    }
+    if (out_truncated) {
+        *out_truncated = truncated;
+    }
+    dest[length++] = '\n';
+    dest[length] = 0;
+    return length;
+}
+
+// Drain every published record into the batch buffers and write them out. Writer thread only.
+static b8 log_writer_drain(log_async_state* async) {
+    // the console buffer holds records for one stream at a time, stdout or stderr
+    u64 console_length = 0;
+    b8 console_is_error = false;
+    u64 file_length = 0;
+    u64 binary_length = 0;
+    b8 wrote = false;
+
+    u64 position = atomic_load_explicit(&async->read_position, memory_order_relaxed);
+    for (;;) {
+        log_record* record = &async->records[position & async->mask];
+        u64 sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+        b8 ready = sequence == position + 1;
+
+        // flush when the buffers can't take another record, or when nothing is left
+        if (!ready || file_length + LOG_RECORD_TEXT_SIZE > LOG_WRITER_BUFFER_SIZE ||
+            binary_length + LOG_RECORD_TEXT_SIZE > LOG_WRITER_BUFFER_SIZE ||
+            console_length + LOG_RECORD_TEXT_SIZE + 32 > LOG_WRITER_BUFFER_SIZE) {
+            if (console_length) {
+                platform_console_write_raw(async->console_buffer, console_length, console_is_error);
+            }
+            if (file_length) {
+                append_to_log_file(async->file_buffer, file_length);
+            }
+            if (binary_length) {
+                append_to_binary_log(async->binary_buffer, binary_length);
+            }
+            // records are only released once written, so logging_flush can rely on read_position
+            atomic_store_explicit(&async->read_position, position, memory_order_release);
+            console_length = 0;
+            file_length = 0;
+            binary_length = 0;
+            if (!ready) {
+                return wrote;
+            }
+        }
+
+        if (record->kind == LOG_RECORD_BINARY) {
+            ccopy_memory(async->binary_buffer + binary_length, record->text, record->length);
+            binary_length += record->length;
+        } else if (record->kind == LOG_RECORD_TEXT) {
+            // a record for the other stream writes out the pending ones first, so the terminal
+            // shows the records in the order they were logged
+            b8 is_error = record->level <= LOG_LEVEL_ERROR;
+            if (console_length && is_error != console_is_error) {
+                platform_console_write_raw(async->console_buffer, console_length, console_is_error);
+                console_length = 0;
+            }
+            console_is_error = is_error;
+            console_length += platform_console_colorize(
+                async->console_buffer + console_length, LOG_WRITER_BUFFER_SIZE - console_length,
+                record->text, record->length, record->level);
+            ccopy_memory(async->file_buffer + file_length, record->text, record->length);
+            file_length += record->length;
+        }
+
+        // hand the slot back to the producers for the next lap of the ring
+        atomic_store_explicit(&record->sequence, position + async->record_count, memory_order_release);
+        position++;
+        wrote = true;
+    }
+}
+
+static u32 log_writer_thread(void* params) {
+    log_async_state* async = params;
+    while (atomic_load(&async->running)) {
+        if (log_writer_drain(async)) {
+            continue;
+        }
+
+        // announce the sleep, then check again so a record published in between is not missed
+        atomic_store(&async->writer_sleeping, true);
+        if (!log_writer_drain(async)) {
+            platform_semaphore_wait(&async->wake_semaphore, LOG_WRITER_WAIT_MS);
+        }
+        atomic_store(&async->writer_sleeping, false);
+    }
+
+    // write out whatever was queued before shutdown
+    log_writer_drain(async);
+    return 0;
+}
+
+static void log_wake_writer(log_async_state* async) {
+    if (atomic_load_explicit(&async->writer_sleeping, memory_order_relaxed) &&
+        atomic_exchange(&async->writer_sleeping, false)) {
+        platform_semaphore_signal(&async->wake_semaphore);
+    }
+}
+
+// Claim the next slot of the ring, waiting for the writer if it is full
+static log_record* log_claim(log_async_state* async, u64* out_position) {
+    log_record* record;
+    u64 position = atomic_load_explicit(&async->write_position, memory_order_relaxed);
+    for (;;) {
+        record = &async->records[position & async->mask];
+        u64 sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+        i64 difference = (i64)sequence - (i64)position;
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&async->write_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // ring full: let the writer catch up rather than losing the message
+            platform_semaphore_signal(&async->wake_semaphore);
+            platform_thread_yield();
+            position = atomic_load_explicit(&async->write_position, memory_order_relaxed);
+        } else {
+            position = atomic_load_explicit(&async->write_position, memory_order_relaxed);
+        }
+    }
+
+    *out_position = position;
+    return record;
+}
+
+// Hand a filled slot to the writer
+static void log_publish(log_async_state* async, log_record* record, u64 position) {
+    atomic_store_explicit(&record->sequence, position + 1, memory_order_release);
+    log_wake_writer(async);
+}
+
+// @return false if the message is too long for a record, its slot is then skipped by the writer
+static b8 log_enqueue(log_async_state* async, log_level level, const char* message, va_list args) {
+    u64 position;
+    log_record* record = log_claim(async, &position);
+    b8 truncated;
+    record->level = level;
+    record->length = (u16)log_format(record->text, LOG_RECORD_TEXT_SIZE, level, message, args, &truncated);
+    record->kind = truncated ? LOG_RECORD_SKIPPED : LOG_RECORD_TEXT;
+    log_publish(async, record, position);
+    return !truncated;
+}
+
+b8 logging_start_async(u32 record_count) {
+    if (!state_ptr || state_ptr->async_enabled) {
+        return false;
+    }
+    if (!is_power_of_2(record_count)) {
+        LOG_ERROR("logging_start_async - record_count must be a power of 2, got %u", record_count);
+        return false;
+    }
+
+    log_async_state* async = &state_ptr->async;
+    async->record_count = record_count;
+    async->mask = record_count - 1;
+    async->records = callocate(sizeof(log_record) * record_count, MEMORY_TAG_RING_QUEUE);
+    for (u32 i = 0; i < record_count; ++i) {
+        atomic_init(&async->records[i].sequence, i);
+    }
+    atomic_init(&async->write_position, 0);
+    atomic_init(&async->read_position, 0);
+    atomic_init(&async->running, true);
+    atomic_init(&async->writer_sleeping, false);
+
+    async->console_buffer = callocate(LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+    async->file_buffer = callocate(LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+    async->binary_buffer = callocate(LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+
+    if (!platform_semaphore_create(0, &async->wake_semaphore) ||
+        !platform_thread_create(log_writer_thread, async, &async->writer_thread)) {
+        LOG_ERROR("Failed to start the async log writer, staying synchronous");
+        platform_semaphore_destroy(&async->wake_semaphore);
+        cfree(async->records, sizeof(log_record) * record_count, MEMORY_TAG_RING_QUEUE);
+        cfree(async->console_buffer, LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+        cfree(async->file_buffer, LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+        cfree(async->binary_buffer, LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+        czero_memory(async, sizeof(log_async_state));
+        return false;
+    }
+
+    state_ptr->async_enabled = true;
+    return true;
+}
+
+void logging_stop_async() {
+    if (!state_ptr || !state_ptr->async_enabled) {
+        return;
+    }
+
+    log_async_state* async = &state_ptr->async;
+    atomic_store(&async->running, false);
+    platform_semaphore_signal(&async->wake_semaphore);
+    platform_thread_join(&async->writer_thread);
+    platform_semaphore_destroy(&async->wake_semaphore);
+
+    state_ptr->async_enabled = false;
+    cfree(async->records, sizeof(log_record) * async->record_count, MEMORY_TAG_RING_QUEUE);
+    cfree(async->console_buffer, LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+    cfree(async->file_buffer, LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+    cfree(async->binary_buffer, LOG_WRITER_BUFFER_SIZE, MEMORY_TAG_RING_QUEUE);
+    czero_memory(async, sizeof(log_async_state));
+}
+
+void logging_flush() {
+    if (!state_ptr || !state_ptr->async_enabled) {
+        return;
+    }
+
+    log_async_state* async = &state_ptr->async;
+    u64 target = atomic_load(&async->write_position);
+    while (atomic_load_explicit(&async->read_position, memory_order_acquire) < target) {
+        platform_semaphore_signal(&async->wake_semaphore);
+        platform_thread_yield();
+    }
+}
+
+static void log_output_v(log_level level, const char* message, va_list args) {
+    if (state_ptr && state_ptr->async_enabled && level != LOG_LEVEL_FATAL) {
+        // the arguments are formatted again below if the message doesn't fit in a record
+        va_list queued_args;
+        va_copy(queued_args, args);
+        b8 queued = log_enqueue(&state_ptr->async, level, message, queued_args);
+        va_end(queued_args);
+        if (queued) {
+            return;
+        }
+    }
+    // FATAL and the messages too long for the ring are written synchronously, after
+    // everything queued before them
+    logging_flush();
+
     b8 is_error = level <= LOG_LEVEL_ERROR;
 
     char out_message[32000];
-    czero_memory(out_message, sizeof(out_message));
+    u64 length = log_format(out_message, sizeof(out_message), level, message, args, 0);
+
+    if (is_error) {
+        platform_console_write_error(out_message, level);
+    } else {
+        platform_console_write(out_message, level);
+    }
+
+    append_to_log_file(out_message, length);
+}
 
+void log_output(log_level level, const char* message, ...) {
     __builtin_va_list args_ptr; // pointer to the arguments of the function
     va_start(args_ptr, message);
-    string_format_v(out_message, message, args_ptr);
+    log_output_v(level, message, args_ptr);
     va_end(args_ptr);
+}
 
-    string_format(out_message, "%s %s\n", level_strings[level], out_message);
+b8 logging_binary_open(const char* path) {
+    if (!state_ptr) {
+        return false;
+    }
+    logging_binary_close();
 
-    if (is_error) {
-        platform_console_write_error(out_message, level);
+    if (!filesystem_open(path, FILE_MODE_WRITE, true, &state_ptr->binary_file_handle)) {
+        LOG_ERROR("Failed to open binary log file '%s'", path);
+        return false;
+    }
+    u8 header[LOG_BINARY_HEADER_SIZE];
+    append_to_binary_log(header, log_binary_encode_header(header));
+
+    // every site writes its site record again in the new file
+    atomic_store_explicit(&state_ptr->binary_generation, atomic_fetch_add(&binary_generation_counter, 1) + 1,
+                          memory_order_release);
+    return true;
+}
+
+void logging_binary_close() {
+    if (!state_ptr || !state_ptr->binary_file_handle.is_valid) {
+        return;
+    }
+    atomic_store(&state_ptr->binary_generation, 0);
+    logging_flush();
+    filesystem_close(&state_ptr->binary_file_handle);
+}
+
+// Queue raw bytes for the binary log, or write them right away when logging synchronously
+static void log_binary_write(const u8* data, u64 size) {
+    if (state_ptr->async_enabled) {
+        u64 position;
+        log_record* record = log_claim(&state_ptr->async, &position);
+        record->kind = LOG_RECORD_BINARY;
+        record->length = (u16)size;
+        ccopy_memory(record->text, data, size);
+        log_publish(&state_ptr->async, record, position);
     } else {
-        platform_console_write(out_message, level);
+        append_to_binary_log(data, size);
+    }
+}
+
+// Parse the site on its first call and write its site record to the current binary log
+static void log_binary_register(log_binary_site* site, u32 generation) {
+    while (atomic_flag_test_and_set_explicit(&site_lock, memory_order_acquire)) {
+        platform_thread_yield();
+    }
+
+    if (atomic_load_explicit(&site->generation, memory_order_relaxed) != generation) {
+        if (!site->parsed) {
+            site->text_only = !log_binary_parse_format(site->format, site->arg_types, &site->arg_count);
+            site->id = atomic_fetch_add(&next_site_id, 1) + 1;
+            site->parsed = true;
+        }
+        if (!site->text_only) {
+            u8 record[LOG_RECORD_TEXT_SIZE];
+            u64 size = log_binary_encode_site(site, record, sizeof(record));
+            if (size) {
+                log_binary_write(record, size);
+            } else {
+                site->text_only = true;
+            }
+        }
+        atomic_store_explicit(&site->generation, generation, memory_order_release);
+    }
+
+    atomic_flag_clear_explicit(&site_lock, memory_order_release);
+}
+
+void log_binary_output(log_binary_site* site, ...) {
+    __builtin_va_list args_ptr;
+    va_start(args_ptr, site);
+
+    u32 generation = state_ptr ? atomic_load_explicit(&state_ptr->binary_generation, memory_order_acquire) : 0;
+    if (generation && atomic_load_explicit(&site->generation, memory_order_acquire) != generation) {
+        log_binary_register(site, generation);
+    }
+
+    // no binary log open: same as the text macros
+    if (!generation || site->text_only) {
+        log_output_v(site->level, site->format, args_ptr);
+        va_end(args_ptr);
+        return;
     }
 
-    append_to_log_file(out_message);
+    f64 time = platform_get_absolute_time();
+    if (state_ptr->async_enabled) {
+        // encode straight into the ring slot
+        u64 position;
+        log_record* record = log_claim(&state_ptr->async, &position);
+        record->kind = LOG_RECORD_BINARY;
+        record->length = (u16)log_binary_encode_message(site, time, args_ptr, (u8*)record->text, LOG_RECORD_TEXT_SIZE);
+        log_publish(&state_ptr->async, record, position);
+    } else {
+        u8 message[LOG_RECORD_TEXT_SIZE];
+        append_to_binary_log(message, log_binary_encode_message(site, time, args_ptr, message, sizeof(message)));
+    }
+    va_end(args_ptr);
 }
 
 void report_assertion_failure(const char* expression, const char* message, const char* file, i32 line) {
     log_output(LOG_LEVEL_FATAL, "\n/!\\ Assertion failed: %s\n%s\n\nFile %s:%d", expression, message, file, line);
 }
+
+b8 log_limit_should_log(log_limit_site* site, u64 every_n) {
+    u64 index = atomic_fetch_add_explicit(&site->count, 1, memory_order_relaxed);
+    if (index == 0) {
+        // only one caller sees the first call, it links the site for the report
+        log_limit_site* head = atomic_load_explicit(&limit_sites, memory_order_relaxed);
+        do {
+            site->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&limit_sites, &head, site, memory_order_release,
+                                                        memory_order_relaxed));
+    }
+
+    b8 should_log = every_n == 0 ? index == 0 : index % every_n == 0;
+    if (should_log) {
+        atomic_fetch_add_explicit(&site->logged, 1, memory_order_relaxed);
+    }
+    return should_log;
+}
+
+void logging_report_suppressed() {
+    log_limit_site* site = atomic_load_explicit(&limit_sites, memory_order_acquire);
+    for (; site; site = site->next) {
+        u64 logged = atomic_load_explicit(&site->logged, memory_order_relaxed);
+        u64 suppressed = atomic_load_explicit(&site->count, memory_order_relaxed) - logged;
+        u64 reported = atomic_load_explicit(&site->reported, memory_order_relaxed);
+        if (suppressed > reported) {
+            // filtered like any warning. The counts are still marked as reported either way
+            LOG_WARN("Suppressed %llu more message(s) from %s:%u: \"%s\"", suppressed - reported, site->file,
+                     site->line, site->format);
+            atomic_store_explicit(&site->reported, suppressed, memory_order_relaxed);
+        }
+    }
+}
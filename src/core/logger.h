@@ -2,7 +2,18 @@
 
 #include "define.h"
 
-#define LOG_LEVEL LOG_LEVEL_DEBUG
+#include <stdatomic.h>
+
+// Least severe level compiled in, as a number so it can be tested by the preprocessor
+// (5 trace, 4 debug, 3 info, 2 warn, 1 error). Statements above it are removed and
+// their arguments never evaluated. Can be set from the build (-DLOG_LEVEL_MIN=3)
+#ifndef LOG_LEVEL_MIN
+#if _DEBUG
+#define LOG_LEVEL_MIN 5
+#else
+#define LOG_LEVEL_MIN 3
+#endif
+#endif
 
 typedef enum log_level {
     LOG_LEVEL_FATAL = 0,
@@ -13,6 +24,36 @@ typedef enum log_level {
     LOG_LEVEL_TRACE = 5
 } log_level;
 
+/**
+ * Log channels, each with its own runtime level. A translation unit picks its channel by
+ * defining LOG_CHANNEL before including any header, otherwise it logs to LOG_CHANNEL_CORE.
+ */
+typedef enum log_channel {
+    LOG_CHANNEL_CORE = 0,
+    LOG_CHANNEL_PLATFORM = 1,
+    LOG_CHANNEL_RENDERER = 2,
+    LOG_CHANNEL_RESOURCES = 3,
+    LOG_CHANNEL_GAME = 4,
+    LOG_CHANNEL_MAX
+} log_channel;
+
+#ifndef LOG_CHANNEL
+#define LOG_CHANNEL LOG_CHANNEL_CORE
+#endif
+
+// Most verbose level written by each channel. Read by every log statement before its
+// arguments are evaluated, use logging_set_channel_level to change it
+extern u8 log_channel_levels[LOG_CHANNEL_MAX];
+
+// Set the runtime level of every channel
+void logging_set_level(log_level level);
+
+void logging_set_channel_level(log_channel channel, log_level level);
+
+// true if a statement of this level is compiled in and enabled for the current channel
+#define LOG_ENABLED(log_level_value) \
+    (LOG_LEVEL_MIN >= (log_level_value) && log_channel_levels[LOG_CHANNEL] >= (log_level_value))
+
 /**
  * Initialize the logging system. call twice; once with state = 0 to get the required memory and
  * then a second time passing allocated memory to state.
@@ -24,11 +65,175 @@ typedef enum log_level {
 b8 initialize_logging(u64* memory_requirement, void* state);
 void shutdown_logging();
 
+/**
+ * Switch the logger to asynchronous mode. Messages are formatted into a lock-free ring of
+ * fixed-size records and a writer thread writes them in batches to the console and the log
+ * file. FATAL messages flush the ring and are written synchronously.
+ *
+ * @param record_count number of records in the ring, must be a power of 2
+ * @return true if the writer thread was started, false otherwise (logging stays synchronous)
+ */
+b8 logging_start_async(u32 record_count);
+
+// Write out every queued message, stop the writer thread and go back to synchronous logging
+void logging_stop_async();
+
+// Block until every message logged before this call has been written out
+void logging_flush();
+
 void log_output(log_level, const char* message, ...);
 
-#define LOG_TRACE(message, ...) log_output(LOG_LEVEL_TRACE, message, ##__VA_ARGS__)
-#define LOG_DEBUG(message, ...) log_output(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__)
-#define LOG_INFO(message, ...) log_output(LOG_LEVEL_INFO, message, ##__VA_ARGS__)
-#define LOG_WARN(message, ...) log_output(LOG_LEVEL_WARN, message, ##__VA_ARGS__)
-#define LOG_ERROR(message, ...) log_output(LOG_LEVEL_ERROR, message, ##__VA_ARGS__)
+#define LOG_BINARY_MAX_ARGS 16
+
+/**
+ * A deferred-format call site. One static instance per LOG_*_BIN call; the format is
+ * parsed and written to the binary log once, then each call only stores its arguments.
+ */
+typedef struct log_binary_site {
+    const char* format;
+    const char* file;
+    u32 line;
+    log_level level;
+
+    // filled on the first call
+    u32 id;
+    atomic_uint generation; // binary log the site record was written to, 0 if never
+    b8 parsed;
+    b8 text_only; // the format can't be deferred, always formatted as text
+    u8 arg_count;
+    u8 arg_types[LOG_BINARY_MAX_ARGS];
+} log_binary_site;
+
+/**
+ * Start writing the deferred-format messages (LOG_*_BIN) to a binary log, decoded offline
+ * by cEngine_logdecode. Until this is called they are formatted and logged as text.
+ *
+ * @param path path of the binary log, overwritten if it exists
+ * @return true if the file was opened, false otherwise
+ */
+b8 logging_binary_open(const char* path);
+
+// Write out the queued binary messages and close the binary log
+void logging_binary_close();
+
+void log_binary_output(log_binary_site* site, ...);
+
+/**
+ * A rate-limited call site. One static instance per LOG_*_ONCE / LOG_*_EVERY_N call; it
+ * counts the calls and the number of messages that were not written.
+ */
+typedef struct log_limit_site {
+    const char* format;
+    const char* file;
+    u32 line;
+
+    atomic_ullong count;    // calls
+    atomic_ullong logged;   // calls that were written out
+    atomic_ullong reported; // suppressed calls already reported by logging_report_suppressed
+    struct log_limit_site* next; // sites hit at least once, for the report
+} log_limit_site;
+
+/**
+ * Count a call of a rate-limited site. The site is linked in the report list on its first
+ * call, so it must have static storage.
+ *
+ * @param site the call site
+ * @param every_n write one call every n, 0 to only write the first one
+ * @return true if this call should be written out
+ */
+b8 log_limit_should_log(log_limit_site* site, u64 every_n);
+
+/**
+ * Log how many messages every rate-limited site suppressed since the previous report.
+ * Sites with nothing new to report stay quiet.
+ */
+void logging_report_suppressed();
+
+#define LOG_AT(log_level_value, message, ...)                     \
+    do {                                                          \
+        if (LOG_ENABLED(log_level_value)) {                       \
+            log_output(log_level_value, message, ##__VA_ARGS__);  \
+        }                                                         \
+    } while (0)
+
+// the levels above LOG_LEVEL_MIN compile to nothing. The arguments are never evaluated, but
+// still referenced so the variables only read by a removed statement don't warn as unused
+#define LOG_DISABLED(message, ...)                                \
+    do {                                                          \
+        if (0) {                                                  \
+            log_output(LOG_LEVEL_TRACE, message, ##__VA_ARGS__);  \
+        }                                                         \
+    } while (0)
+
+#if LOG_LEVEL_MIN >= 5
+#define LOG_TRACE(message, ...) LOG_AT(LOG_LEVEL_TRACE, message, ##__VA_ARGS__)
+#else
+#define LOG_TRACE LOG_DISABLED
+#endif
+
+#if LOG_LEVEL_MIN >= 4
+#define LOG_DEBUG(message, ...) LOG_AT(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG LOG_DISABLED
+#endif
+
+#if LOG_LEVEL_MIN >= 3
+#define LOG_INFO(message, ...) LOG_AT(LOG_LEVEL_INFO, message, ##__VA_ARGS__)
+#else
+#define LOG_INFO LOG_DISABLED
+#endif
+
+#if LOG_LEVEL_MIN >= 2
+#define LOG_WARN(message, ...) LOG_AT(LOG_LEVEL_WARN, message, ##__VA_ARGS__)
+#else
+#define LOG_WARN LOG_DISABLED
+#endif
+
+#if LOG_LEVEL_MIN >= 1
+#define LOG_ERROR(message, ...) LOG_AT(LOG_LEVEL_ERROR, message, ##__VA_ARGS__)
+#else
+#define LOG_ERROR LOG_DISABLED
+#endif
+
+// fatal messages are never filtered
 #define LOG_FATAL(message, ...) log_output(LOG_LEVEL_FATAL, message, ##__VA_ARGS__)
+
+// Rate-limited variants for paths that can repeat every frame. The suppressed calls are
+// counted and reported by logging_report_suppressed
+#define LOG_EVERY_N(log_level_value, n, message, ...)                                       \
+    do {                                                                                     \
+        static log_limit_site _log_limit_site = {message, __FILE__, __LINE__};               \
+        if (LOG_ENABLED(log_level_value) && log_limit_should_log(&_log_limit_site, n)) {     \
+            log_output(log_level_value, message, ##__VA_ARGS__);                             \
+        }                                                                                    \
+    } while (0)
+
+#define LOG_WARN_ONCE(message, ...) LOG_EVERY_N(LOG_LEVEL_WARN, 0, message, ##__VA_ARGS__)
+#define LOG_WARN_EVERY_N(n, message, ...) LOG_EVERY_N(LOG_LEVEL_WARN, n, message, ##__VA_ARGS__)
+
+// Never called. The encoder reads each argument with the width its conversion implies
+// (%i reads 32 bits, %llu 64), so the compiler checks the arguments against the format
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((format(printf, 1, 2)))
+#endif
+cINLINE void log_binary_check_format(const char* format, ...) {
+    (void)format;
+}
+
+// Deferred-format variants for hot paths. The format string must be a literal; only the
+// raw arguments are stored at runtime when a binary log is open
+#define LOG_BINARY_CALL(log_level_value, message, ...)                                       \
+    do {                                                                                      \
+        static log_binary_site _log_site = {message, __FILE__, __LINE__, log_level_value};   \
+        if (0) {                                                                              \
+            log_binary_check_format(message, ##__VA_ARGS__);                                  \
+        }                                                                                     \
+        if (LOG_ENABLED(log_level_value)) {                                                   \
+            log_binary_output(&_log_site, ##__VA_ARGS__);                                     \
+        }                                                                                     \
+    } while (0)
+
+#define LOG_TRACE_BIN(message, ...) LOG_BINARY_CALL(LOG_LEVEL_TRACE, message, ##__VA_ARGS__)
+#define LOG_DEBUG_BIN(message, ...) LOG_BINARY_CALL(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__)
+#define LOG_INFO_BIN(message, ...) LOG_BINARY_CALL(LOG_LEVEL_INFO, message, ##__VA_ARGS__)
+#define LOG_WARN_BIN(message, ...) LOG_BINARY_CALL(LOG_LEVEL_WARN, message, ##__VA_ARGS__)
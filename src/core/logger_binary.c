@@ -0,0 +1,429 @@
+#include "logger_binary.h"
+
+#include <stdio.h>
+
+#include "cmemory.h"
+#include "cstring.h"
+
+// Only the end of the source path is kept in site records
+#define LOG_BINARY_MAX_FILE_LENGTH 96
+// Size of the text rebuilt for one message by the decoder
+#define LOG_BINARY_DECODE_TEXT_SIZE 4096
+#define LOG_BINARY_MAX_SPEC_LENGTH 32
+
+// fixed part of a message record: type, id, time, payload length
+#define LOG_BINARY_MESSAGE_HEADER_SIZE (1 + 4 + 8 + 2)
+
+typedef struct format_spec {
+    u64 length; // from the '%' to the conversion character included
+    char conversion;
+    b8 wide;        // l, ll, z, j, t or q
+    b8 long_double; // L
+    b8 star;        // '*' width or precision
+} format_spec;
+
+// Read the conversion spec starting on the '%' at format[0]. @return false if it is not terminated
+static b8 format_spec_read(const char* format, u64 remaining, format_spec* out_spec) {
+    czero_memory(out_spec, sizeof(format_spec));
+    u64 i = 1;
+
+    while (i < remaining && (format[i] == '-' || format[i] == '+' || format[i] == ' ' || format[i] == '#' ||
+                             format[i] == '0')) {
+        i++;
+    }
+    // width and precision
+    while (i < remaining && ((format[i] >= '0' && format[i] <= '9') || format[i] == '.' || format[i] == '*')) {
+        if (format[i] == '*') {
+            out_spec->star = true;
+        }
+        i++;
+    }
+    // length modifiers
+    while (i < remaining && (format[i] == 'h' || format[i] == 'l' || format[i] == 'z' || format[i] == 'j' ||
+                             format[i] == 't' || format[i] == 'q' || format[i] == 'L')) {
+        if (format[i] == 'L') {
+            out_spec->long_double = true;
+        } else if (format[i] != 'h') {
+            out_spec->wide = true;
+        }
+        i++;
+    }
+    if (i >= remaining) {
+        return false;
+    }
+
+    out_spec->conversion = format[i];
+    out_spec->length = i + 1;
+    return true;
+}
+
+b8 log_binary_parse_format(const char* format, u8* out_arg_types, u8* out_arg_count) {
+    u64 length = string_length(format);
+    u8 count = 0;
+
+    for (u64 i = 0; i < length; ++i) {
+        if (format[i] != '%') {
+            continue;
+        }
+        if (i + 1 < length && format[i + 1] == '%') {
+            i++;
+            continue;
+        }
+
+        format_spec spec;
+        if (!format_spec_read(format + i, length - i, &spec) || spec.star || spec.long_double) {
+            return false;
+        }
+
+        u8 type;
+        switch (spec.conversion) {
+            case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+                type = spec.wide ? LOG_BINARY_ARG_I64 : LOG_BINARY_ARG_I32;
+                break;
+            case 'c':
+                if (spec.wide) {
+                    return false;
+                }
+                type = LOG_BINARY_ARG_I32;
+                break;
+            case 's':
+                if (spec.wide) {
+                    return false;
+                }
+                type = LOG_BINARY_ARG_STRING;
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                type = LOG_BINARY_ARG_F64;
+                break;
+            case 'p':
+                type = LOG_BINARY_ARG_POINTER;
+                break;
+            default:
+                // %n and unknown conversions
+                return false;
+        }
+
+        if (count == LOG_BINARY_MAX_ARGS) {
+            return false;
+        }
+        out_arg_types[count++] = type;
+        i += spec.length - 1;
+    }
+
+    *out_arg_count = count;
+    return true;
+}
+
+static u8* write_bytes(u8* dest, const void* value, u64 size) {
+    ccopy_memory(dest, value, size);
+    return dest + size;
+}
+
+u64 log_binary_encode_header(u8* dest) {
+    u32 magic = LOG_BINARY_MAGIC;
+    u32 version = LOG_BINARY_VERSION;
+    u8* at = write_bytes(dest, &magic, sizeof(u32));
+    at = write_bytes(at, &version, sizeof(u32));
+    return at - dest;
+}
+
+u64 log_binary_encode_site(const log_binary_site* site, u8* dest, u64 capacity) {
+    const char* file = site->file ? site->file : "";
+    u64 file_length = string_length(file);
+    if (file_length > LOG_BINARY_MAX_FILE_LENGTH) {
+        file += file_length - LOG_BINARY_MAX_FILE_LENGTH;
+        file_length = LOG_BINARY_MAX_FILE_LENGTH;
+    }
+    u64 format_length = string_length(site->format);
+
+    u64 size = 1 + 4 + 1 + 4 + 1 + site->arg_count + 2 + file_length + 2 + format_length;
+    if (size > capacity || format_length > 0xFFFF) {
+        return 0;
+    }
+
+    u8 type = LOG_BINARY_RECORD_SITE;
+    u8 level = (u8)site->level;
+    u16 length16;
+    u8* at = write_bytes(dest, &type, 1);
+    at = write_bytes(at, &site->id, sizeof(u32));
+    at = write_bytes(at, &level, 1);
+    at = write_bytes(at, &site->line, sizeof(u32));
+    at = write_bytes(at, &site->arg_count, 1);
+    at = write_bytes(at, site->arg_types, site->arg_count);
+    length16 = (u16)file_length;
+    at = write_bytes(at, &length16, sizeof(u16));
+    at = write_bytes(at, file, file_length);
+    length16 = (u16)format_length;
+    at = write_bytes(at, &length16, sizeof(u16));
+    at = write_bytes(at, site->format, format_length);
+    return at - dest;
+}
+
+u64 log_binary_encode_message(const log_binary_site* site, f64 time, va_list args, u8* dest, u64 capacity) {
+    // room left for the characters once every fixed size argument has its place
+    u64 fixed_size = LOG_BINARY_MESSAGE_HEADER_SIZE;
+    for (u8 i = 0; i < site->arg_count; ++i) {
+        switch (site->arg_types[i]) {
+            case LOG_BINARY_ARG_I32: fixed_size += sizeof(i32); break;
+            case LOG_BINARY_ARG_STRING: fixed_size += sizeof(u16); break;
+            default: fixed_size += sizeof(u64); break;
+        }
+    }
+    u64 string_budget = capacity > fixed_size ? capacity - fixed_size : 0;
+
+    u8 type = LOG_BINARY_RECORD_MESSAGE;
+    u8* at = write_bytes(dest, &type, 1);
+    at = write_bytes(at, &site->id, sizeof(u32));
+    at = write_bytes(at, &time, sizeof(f64));
+    u8* payload_length_at = at;
+    at += sizeof(u16);
+    u8* payload = at;
+
+    for (u8 i = 0; i < site->arg_count; ++i) {
+        switch (site->arg_types[i]) {
+            case LOG_BINARY_ARG_I32: {
+                i32 value = va_arg(args, i32);
+                at = write_bytes(at, &value, sizeof(i32));
+            } break;
+            case LOG_BINARY_ARG_I64: {
+                i64 value = va_arg(args, i64);
+                at = write_bytes(at, &value, sizeof(i64));
+            } break;
+            case LOG_BINARY_ARG_F64: {
+                f64 value = va_arg(args, f64);
+                at = write_bytes(at, &value, sizeof(f64));
+            } break;
+            case LOG_BINARY_ARG_POINTER: {
+                u64 value = (u64)va_arg(args, void*);
+                at = write_bytes(at, &value, sizeof(u64));
+            } break;
+            case LOG_BINARY_ARG_STRING: {
+                const char* value = va_arg(args, const char*);
+                if (!value) {
+                    value = "(null)";
+                }
+                u64 length = string_length(value);
+                if (length > string_budget) {
+                    length = string_budget;
+                }
+                if (length > 0xFFFF) {
+                    length = 0xFFFF;
+                }
+                string_budget -= length;
+                u16 length16 = (u16)length;
+                at = write_bytes(at, &length16, sizeof(u16));
+                at = write_bytes(at, value, length);
+            } break;
+        }
+    }
+
+    u16 payload_length = (u16)(at - payload);
+    write_bytes(payload_length_at, &payload_length, sizeof(u16));
+    return at - dest;
+}
+
+typedef struct byte_reader {
+    const u8* data;
+    u64 size;
+    u64 offset;
+} byte_reader;
+
+static b8 read_bytes(byte_reader* reader, void* out, u64 size) {
+    if (reader->offset + size > reader->size) {
+        return false;
+    }
+    ccopy_memory(out, reader->data + reader->offset, size);
+    reader->offset += size;
+    return true;
+}
+
+typedef struct decoded_site {
+    b8 valid;
+    u8 level;
+    u8 arg_count;
+    u8 arg_types[LOG_BINARY_MAX_ARGS];
+    const char* format; // points into the decoded data, not null terminated
+    u16 format_length;
+} decoded_site;
+
+typedef struct decoded_site_table {
+    decoded_site* sites; // indexed by site id
+    u32 capacity;
+} decoded_site_table;
+
+static decoded_site* site_table_get(decoded_site_table* table, u32 id, b8 create) {
+    if (id >= table->capacity) {
+        if (!create) {
+            return 0;
+        }
+        u32 new_capacity = table->capacity ? table->capacity : 64;
+        while (new_capacity <= id) {
+            new_capacity *= 2;
+        }
+        decoded_site* sites = callocate(sizeof(decoded_site) * new_capacity, MEMORY_TAG_ARRAY);
+        if (table->sites) {
+            ccopy_memory(sites, table->sites, sizeof(decoded_site) * table->capacity);
+            cfree(table->sites, sizeof(decoded_site) * table->capacity, MEMORY_TAG_ARRAY);
+        }
+        table->sites = sites;
+        table->capacity = new_capacity;
+    }
+    return &table->sites[id];
+}
+
+static b8 decode_site(byte_reader* reader, decoded_site_table* table) {
+    u32 id;
+    u8 level;
+    u32 line;
+    u8 arg_count;
+    u16 file_length;
+    if (!read_bytes(reader, &id, sizeof(u32)) || !read_bytes(reader, &level, 1) ||
+        !read_bytes(reader, &line, sizeof(u32)) || !read_bytes(reader, &arg_count, 1) ||
+        arg_count > LOG_BINARY_MAX_ARGS) {
+        return false;
+    }
+
+    decoded_site* site = site_table_get(table, id, true);
+    site->level = level;
+    site->arg_count = arg_count;
+    if (!read_bytes(reader, site->arg_types, arg_count) || !read_bytes(reader, &file_length, sizeof(u16))) {
+        return false;
+    }
+    // the file and line are kept for tooling, the text only needs the format
+    reader->offset += file_length;
+    if (!read_bytes(reader, &site->format_length, sizeof(u16)) ||
+        reader->offset + site->format_length > reader->size) {
+        return false;
+    }
+    site->format = (const char*)reader->data + reader->offset;
+    reader->offset += site->format_length;
+    site->valid = true;
+    return true;
+}
+
+// Rebuild the text of a message from its site format and its payload. @return the text length
+static u64 render_message(const decoded_site* site, byte_reader* payload, char* text, u64 capacity) {
+    u64 length = 0;
+    u8 arg_index = 0;
+    char spec_buffer[LOG_BINARY_MAX_SPEC_LENGTH];
+    char string_buffer[LOG_BINARY_DECODE_TEXT_SIZE];
+
+    for (u64 i = 0; i < site->format_length && length < capacity - 1; ++i) {
+        char c = site->format[i];
+        if (c != '%') {
+            text[length++] = c;
+            continue;
+        }
+        if (i + 1 < site->format_length && site->format[i + 1] == '%') {
+            text[length++] = '%';
+            i++;
+            continue;
+        }
+
+        format_spec spec;
+        if (!format_spec_read(site->format + i, site->format_length - i, &spec) ||
+            spec.length >= LOG_BINARY_MAX_SPEC_LENGTH || arg_index >= site->arg_count) {
+            break;
+        }
+        ccopy_memory(spec_buffer, site->format + i, spec.length);
+        spec_buffer[spec.length] = 0;
+        i += spec.length - 1;
+
+        i32 written = 0;
+        char* dest = text + length;
+        u64 remaining = capacity - length;
+        switch (site->arg_types[arg_index++]) {
+            case LOG_BINARY_ARG_I32: {
+                i32 value = 0;
+                read_bytes(payload, &value, sizeof(i32));
+                written = snprintf(dest, remaining, spec_buffer, value);
+            } break;
+            case LOG_BINARY_ARG_I64: {
+                i64 value = 0;
+                read_bytes(payload, &value, sizeof(i64));
+                written = snprintf(dest, remaining, spec_buffer, value);
+            } break;
+            case LOG_BINARY_ARG_F64: {
+                f64 value = 0;
+                read_bytes(payload, &value, sizeof(f64));
+                written = snprintf(dest, remaining, spec_buffer, value);
+            } break;
+            case LOG_BINARY_ARG_POINTER: {
+                u64 value = 0;
+                read_bytes(payload, &value, sizeof(u64));
+                written = snprintf(dest, remaining, spec_buffer, (void*)value);
+            } break;
+            case LOG_BINARY_ARG_STRING: {
+                u16 string_length = 0;
+                read_bytes(payload, &string_length, sizeof(u16));
+                if (string_length >= sizeof(string_buffer) || !read_bytes(payload, string_buffer, string_length)) {
+                    string_length = 0;
+                }
+                string_buffer[string_length] = 0;
+                written = snprintf(dest, remaining, spec_buffer, string_buffer);
+            } break;
+        }
+
+        if (written > 0) {
+            length += (u64)written < remaining ? (u64)written : remaining - 1;
+        }
+    }
+
+    text[length] = 0;
+    return length;
+}
+
+b8 log_binary_decode(const u8* data, u64 size, PFN_log_binary_on_line on_line, void* user_data) {
+    byte_reader reader = {data, size, 0};
+    u32 magic;
+    u32 version;
+    if (!read_bytes(&reader, &magic, sizeof(u32)) || !read_bytes(&reader, &version, sizeof(u32)) ||
+        magic != LOG_BINARY_MAGIC || version != LOG_BINARY_VERSION) {
+        return false;
+    }
+
+    decoded_site_table table = {0};
+    char text[LOG_BINARY_DECODE_TEXT_SIZE];
+    b8 result = true;
+
+    while (reader.offset < reader.size) {
+        u8 type;
+        read_bytes(&reader, &type, 1);
+
+        if (type == LOG_BINARY_RECORD_SITE) {
+            if (!decode_site(&reader, &table)) {
+                result = false;
+                break;
+            }
+        } else if (type == LOG_BINARY_RECORD_MESSAGE) {
+            u32 id;
+            f64 time;
+            u16 payload_length;
+            if (!read_bytes(&reader, &id, sizeof(u32)) || !read_bytes(&reader, &time, sizeof(f64)) ||
+                !read_bytes(&reader, &payload_length, sizeof(u16)) || reader.offset + payload_length > reader.size) {
+                result = false;
+                break;
+            }
+            byte_reader payload = {reader.data + reader.offset, payload_length, 0};
+            reader.offset += payload_length;
+
+            decoded_site* site = site_table_get(&table, id, false);
+            if (!site || !site->valid) {
+                // a message without its site can't be rebuilt, keep going with the next one
+                u64 length = snprintf(text, sizeof(text), "<unknown log site %u>", id);
+                on_line(LOG_LEVEL_WARN, time, text, length, user_data);
+                continue;
+            }
+            u64 length = render_message(site, &payload, text, sizeof(text));
+            on_line((log_level)site->level, time, text, length, user_data);
+        } else {
+            result = false;
+            break;
+        }
+    }
+
+    if (table.sites) {
+        cfree(table.sites, sizeof(decoded_site) * table.capacity, MEMORY_TAG_ARRAY);
+    }
+    return result;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "define.h"
+#include "logger.h"
+
+#include <stdarg.h>
+
+/*
+ * Binary log format used by the deferred-format LOG_*_BIN macros.
+ *
+ * The file starts with a header (magic, version) followed by records, each starting with
+ * a u8 record type:
+ *  - site:    u32 id, u8 level, u32 line, u8 arg_count, u8 arg_types[arg_count],
+ *             u16 file_length, file, u16 format_length, format
+ *  - message: u32 id, f64 time, u16 payload_length, payload (the raw arguments)
+ *
+ * A site record is written once per file the first time a call site logs, before its
+ * first message. Everything is stored in the native byte order.
+ */
+
+#define LOG_BINARY_MAGIC 0x474F4C43 // "CLOG"
+#define LOG_BINARY_VERSION 1
+#define LOG_BINARY_HEADER_SIZE 8
+
+typedef enum log_binary_record_type {
+    LOG_BINARY_RECORD_SITE = 1,
+    LOG_BINARY_RECORD_MESSAGE = 2,
+} log_binary_record_type;
+
+typedef enum log_binary_arg_type {
+    LOG_BINARY_ARG_I32 = 0, // every int conversion without l/ll/z/j/t, and %c
+    LOG_BINARY_ARG_I64 = 1, // int conversions with l/ll/z/j/t
+    LOG_BINARY_ARG_F64 = 2, // float conversions (floats are promoted to double)
+    LOG_BINARY_ARG_POINTER = 3,
+    LOG_BINARY_ARG_STRING = 4, // u16 length followed by the characters
+} log_binary_arg_type;
+
+/**
+ * Find the argument types of a printf-style format string.
+ *
+ * @param format the format string
+ * @param out_arg_types receives up to LOG_BINARY_MAX_ARGS log_binary_arg_type values
+ * @param out_arg_count receives the number of arguments
+ * @return false if the format can't be deferred (too many args, '*' width, %n, long double...)
+ */
+b8 log_binary_parse_format(const char* format, u8* out_arg_types, u8* out_arg_count);
+
+// Write the file header into dest (LOG_BINARY_HEADER_SIZE bytes). @return the size written
+u64 log_binary_encode_header(u8* dest);
+
+/**
+ * Encode the site record of a registered call site.
+ * @return the size written, 0 if it doesn't fit in capacity
+ */
+u64 log_binary_encode_site(const log_binary_site* site, u8* dest, u64 capacity);
+
+/**
+ * Encode a message record: the site id, the time and the raw bytes of the arguments.
+ * Strings that don't fit in capacity are truncated.
+ * @return the size written
+ */
+u64 log_binary_encode_message(const log_binary_site* site, f64 time, va_list args, u8* dest, u64 capacity);
+
+// Called for every decoded message. text is null terminated and has no trailing newline
+typedef void (*PFN_log_binary_on_line)(log_level level, f64 time, const char* text, u64 length, void* user_data);
+
+/**
+ * Decode a whole binary log and rebuild the text of every message.
+ *
+ * @param data the content of the binary log
+ * @param size the size of data
+ * @param on_line called for every message, in order
+ * @param user_data passed to on_line
+ * @return false if the header is invalid or the data is truncated or corrupted. The lines
+ * decoded before the error have been reported.
+ */
+b8 log_binary_decode(const u8* data, u64 size, PFN_log_binary_on_line on_line, void* user_data);
@@ -0,0 +1,177 @@
+#include "text_reader.h"
+
+#include "core/logger.h"
+#include "core/cmemory.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+b8 text_reader_open(const char* path, text_reader* out_reader) {
+    czero_memory(out_reader, sizeof(text_reader));
+    if (filesystem_map(path, FILE_MAP_HINT_SEQUENTIAL, FILE_MAP_FLAG_NONE, &out_reader->mapping)) {
+        out_reader->is_mapped = true;
+        out_reader->data = out_reader->mapping.data;
+        out_reader->size = out_reader->mapping.size;
+        return true;
+    }
+    return text_reader_open_buffered(path, TEXT_READER_DEFAULT_BLOCK_SIZE, out_reader);
+}
+
+b8 text_reader_open_buffered(const char* path, u64 block_size, text_reader* out_reader) {
+    czero_memory(out_reader, sizeof(text_reader));
+    if (!filesystem_open(path, FILE_MODE_READ, true, &out_reader->file)) {
+        LOG_ERROR("Failed to open text file '%s'", path);
+        return false;
+    }
+
+    out_reader->is_buffered = true;
+    out_reader->buffer_size = block_size ? block_size : TEXT_READER_DEFAULT_BLOCK_SIZE;
+    out_reader->buffer = callocate(out_reader->buffer_size, MEMORY_TAG_ARRAY);
+    out_reader->data = out_reader->buffer;
+    return true;
+}
+
+void text_reader_from_memory(const char* text, u64 length, text_reader* out_reader) {
+    czero_memory(out_reader, sizeof(text_reader));
+    out_reader->data = text;
+    out_reader->size = length;
+}
+
+void text_reader_close(text_reader* reader) {
+    if (reader->is_mapped) {
+        filesystem_unmap(&reader->mapping);
+    }
+    if (reader->is_buffered) {
+        filesystem_close(&reader->file);
+        cfree(reader->buffer, reader->buffer_size, MEMORY_TAG_ARRAY);
+    }
+    czero_memory(reader, sizeof(text_reader));
+}
+
+// Keep the unread part of the block and read the next one after it
+static void text_reader_refill(text_reader* reader) {
+    u64 remaining = reader->size - reader->position;
+    if (remaining == reader->buffer_size) {
+        // the line is longer than the block
+        u64 new_size = reader->buffer_size * 2;
+        char* new_buffer = callocate(new_size, MEMORY_TAG_ARRAY);
+        ccopy_memory(new_buffer, reader->buffer + reader->position, remaining);
+        cfree(reader->buffer, reader->buffer_size, MEMORY_TAG_ARRAY);
+        reader->buffer = new_buffer;
+        reader->buffer_size = new_size;
+    } else if (remaining > 0 && reader->position > 0) {
+        memmove(reader->buffer, reader->buffer + reader->position, remaining);
+    }
+
+    u64 requested = reader->buffer_size - remaining;
+    u64 bytes_read = 0;
+    // a short read is the end of the file
+    if (!filesystem_read(&reader->file, requested, reader->buffer + remaining, &bytes_read)) {
+        reader->end_of_file = true;
+    }
+
+    reader->data = reader->buffer;
+    reader->size = remaining + bytes_read;
+    reader->position = 0;
+}
+
+b8 text_reader_next_line(text_reader* reader, text_slice* out_line) {
+    while (true) {
+        const char* start = reader->data + reader->position;
+        u64 available = reader->size - reader->position;
+        const char* newline = available ? memchr(start, '\n', available) : 0;
+
+        u64 length;
+        if (newline) {
+            length = newline - start;
+            reader->position += length + 1;
+        } else if (reader->is_buffered && !reader->end_of_file) {
+            text_reader_refill(reader);
+            continue;
+        } else if (available > 0) {
+            // last line without a line ending
+            length = available;
+            reader->position = reader->size;
+        } else {
+            return false;
+        }
+
+        if (length > 0 && start[length - 1] == '\r') {
+            length--;
+        }
+        out_line->data = start;
+        out_line->length = length;
+        reader->line_number++;
+        return true;
+    }
+}
+
+text_slice text_slice_from_string(const char* str) {
+    text_slice slice = {str, str ? strlen(str) : 0};
+    return slice;
+}
+
+text_slice text_slice_trim(text_slice slice) {
+    while (slice.length > 0 && isspace((unsigned char)slice.data[0])) {
+        slice.data++;
+        slice.length--;
+    }
+    while (slice.length > 0 && isspace((unsigned char)slice.data[slice.length - 1])) {
+        slice.length--;
+    }
+    return slice;
+}
+
+b8 text_slice_split(text_slice slice, char separator, text_slice* out_before, text_slice* out_after) {
+    const char* found = slice.length ? memchr(slice.data, separator, slice.length) : 0;
+    if (!found) {
+        return false;
+    }
+    u64 index = found - slice.data;
+    out_before->data = slice.data;
+    out_before->length = index;
+    out_after->data = found + 1;
+    out_after->length = slice.length - index - 1;
+    return true;
+}
+
+b8 text_slice_next_token(text_slice* cursor, text_slice* out_token) {
+    text_slice remaining = *cursor;
+    while (remaining.length > 0 && isspace((unsigned char)remaining.data[0])) {
+        remaining.data++;
+        remaining.length--;
+    }
+    if (remaining.length == 0) {
+        *cursor = remaining;
+        return false;
+    }
+
+    u64 length = 0;
+    while (length < remaining.length && !isspace((unsigned char)remaining.data[length])) {
+        length++;
+    }
+    out_token->data = remaining.data;
+    out_token->length = length;
+    cursor->data = remaining.data + length;
+    cursor->length = remaining.length - length;
+    return true;
+}
+
+b8 text_slice_equals(text_slice slice, const char* str) {
+    return strncmp(slice.data, str, slice.length) == 0 && str[slice.length] == '\0';
+}
+
+b8 text_slice_equals_case(text_slice slice, const char* str) {
+    return strncasecmp(slice.data, str, slice.length) == 0 && str[slice.length] == '\0';
+}
+
+u64 text_slice_copy(text_slice slice, char* dest, u64 capacity) {
+    if (capacity == 0) {
+        return 0;
+    }
+    u64 length = slice.length < capacity - 1 ? slice.length : capacity - 1;
+    ccopy_memory(dest, slice.data, length);
+    dest[length] = '\0';
+    return length;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "define.h"
+#include "platform/filesystem.h"
+
+/*
+ * Line reader for text based resources.
+ *
+ * The file is mapped when possible, and read in large blocks otherwise. Lines and tokens
+ * are returned as slices pointing into the mapping or the block buffer: nothing is
+ * copied, and a slice stays valid only until the next call to text_reader_next_line.
+ */
+
+// A piece of text that is not null terminated
+typedef struct text_slice {
+    const char* data;
+    u64 length;
+} text_slice;
+
+typedef struct text_reader {
+    const char* data; // the mapping, the block buffer or the memory given to the reader
+    u64 size;
+    u64 position;
+    // number of the line last returned, starting at 1
+    u32 line_number;
+
+    b8 is_mapped;
+    file_mapping mapping;
+
+    // block mode
+    b8 is_buffered;
+    file_handle file;
+    char* buffer;
+    u64 buffer_size;
+    b8 end_of_file;
+} text_reader;
+
+#define TEXT_READER_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+/**
+ * Open a text file for reading, mapping it or falling back to block reads
+ * @param path path to the file to read
+ * @param out_reader the reader to be filled
+ * @return true if the file was opened successfully, false otherwise
+ */
+b8 text_reader_open(const char* path, text_reader* out_reader);
+
+/**
+ * Open a text file read in blocks of block_size bytes. The block grows when a line doesn't fit
+ * @return true if the file was opened successfully, false otherwise
+ */
+b8 text_reader_open_buffered(const char* path, u64 block_size, text_reader* out_reader);
+
+// Read lines from text already in memory
+void text_reader_from_memory(const char* text, u64 length, text_reader* out_reader);
+
+void text_reader_close(text_reader* reader);
+
+/**
+ * Get the next line, without its line ending ("\n" or "\r\n")
+ * @param reader the reader
+ * @param out_line the line, valid until the next call
+ * @return false at the end of the text
+ */
+b8 text_reader_next_line(text_reader* reader, text_slice* out_line);
+
+text_slice text_slice_from_string(const char* str);
+
+// The slice without its leading and trailing whitespaces
+text_slice text_slice_trim(text_slice slice);
+
+/**
+ * Split the slice around the first occurence of a character
+ * @param slice the slice to split
+ * @param separator the character to split around, not included in either part
+ * @param out_before receives the part before the separator
+ * @param out_after receives the part after the separator
+ * @return false if the separator was not found
+ */
+b8 text_slice_split(text_slice slice, char separator, text_slice* out_before, text_slice* out_after);
+
+/**
+ * Take the next whitespace separated token from the slice
+ * @param cursor the remaining text, advanced past the token
+ * @param out_token the token
+ * @return false if there is no token left
+ */
+b8 text_slice_next_token(text_slice* cursor, text_slice* out_token);
+
+b8 text_slice_equals(text_slice slice, const char* str);
+b8 text_slice_equals_case(text_slice slice, const char* str);
+
+/**
+ * Copy the slice as a null terminated string, truncated to fit
+ * @param slice the slice to copy
+ * @param dest the destination
+ * @param capacity size of dest, the terminator included
+ * @return the number of characters copied
+ */
+u64 text_slice_copy(text_slice slice, char* dest, u64 capacity);
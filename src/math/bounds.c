@@ -0,0 +1,126 @@
+#include "bounds.h"
+
+#include "cmath.h"
+
+void bounds_from_vertices(const vertex_3d* vertices, u32 vertex_count, extents_3d* out_extents, sphere_3d* out_sphere) {
+    extents_3d extents = {0};
+    sphere_3d sphere = {0};
+    if (vertex_count == 0) {
+        if (out_extents) {
+            *out_extents = extents;
+        }
+        if (out_sphere) {
+            *out_sphere = sphere;
+        }
+        return;
+    }
+
+    u32 i = 0;
+#if defined(cUSE_SIMD)
+    // a 16 bytes load at the position also reads texcoord.x, which stays in the unused lane 3
+    __m128 minimum = _mm_loadu_ps(vertices[0].position.elements);
+    __m128 maximum = minimum;
+    // two chains so consecutive min/max don't wait on each other
+    __m128 minimum_odd = minimum;
+    __m128 maximum_odd = minimum;
+    for (; i + 2 <= vertex_count; i += 2) {
+        __m128 p0 = _mm_loadu_ps(vertices[i].position.elements);
+        __m128 p1 = _mm_loadu_ps(vertices[i + 1].position.elements);
+        minimum = _mm_min_ps(minimum, p0);
+        maximum = _mm_max_ps(maximum, p0);
+        minimum_odd = _mm_min_ps(minimum_odd, p1);
+        maximum_odd = _mm_max_ps(maximum_odd, p1);
+    }
+    vec4 reduced_min;
+    vec4 reduced_max;
+    reduced_min.data = _mm_min_ps(minimum, minimum_odd);
+    reduced_max.data = _mm_max_ps(maximum, maximum_odd);
+    extents.min = (vec3){{reduced_min.x, reduced_min.y, reduced_min.z}};
+    extents.max = (vec3){{reduced_max.x, reduced_max.y, reduced_max.z}};
+#else
+    extents.min = vertices[0].position;
+    extents.max = vertices[0].position;
+#endif
+    for (; i < vertex_count; ++i) {
+        const vec3* p = &vertices[i].position;
+        extents.min.x = p->x < extents.min.x ? p->x : extents.min.x;
+        extents.min.y = p->y < extents.min.y ? p->y : extents.min.y;
+        extents.min.z = p->z < extents.min.z ? p->z : extents.min.z;
+        extents.max.x = p->x > extents.max.x ? p->x : extents.max.x;
+        extents.max.y = p->y > extents.max.y ? p->y : extents.max.y;
+        extents.max.z = p->z > extents.max.z ? p->z : extents.max.z;
+    }
+    if (out_extents) {
+        *out_extents = extents;
+    }
+    if (!out_sphere) {
+        return;
+    }
+
+    sphere.center = vec3_scale(vec3_add(extents.min, extents.max), 0.5f);
+    f32 max_distance_squared = 0.0f;
+    i = 0;
+#if defined(cUSE_SIMD)
+    __m128 center_x = _mm_set1_ps(sphere.center.x);
+    __m128 center_y = _mm_set1_ps(sphere.center.y);
+    __m128 center_z = _mm_set1_ps(sphere.center.z);
+    __m128 farthest = _mm_setzero_ps();
+    for (; i + 4 <= vertex_count; i += 4) {
+        __m128 x = _mm_loadu_ps(vertices[i].position.elements);
+        __m128 y = _mm_loadu_ps(vertices[i + 1].position.elements);
+        __m128 z = _mm_loadu_ps(vertices[i + 2].position.elements);
+        __m128 w = _mm_loadu_ps(vertices[i + 3].position.elements);
+        // one vertex per lane
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        __m128 dx = _mm_sub_ps(x, center_x);
+        __m128 dy = _mm_sub_ps(y, center_y);
+        __m128 dz = _mm_sub_ps(z, center_z);
+        __m128 distance_squared = c_mm_madd_ps(dz, dz, c_mm_madd_ps(dy, dy, _mm_mul_ps(dx, dx)));
+        farthest = _mm_max_ps(farthest, distance_squared);
+    }
+    farthest = _mm_max_ps(farthest, c_mm_shuffle(farthest, 1, 0, 3, 2));
+    farthest = _mm_max_ps(farthest, c_mm_shuffle(farthest, 2, 3, 0, 1));
+    max_distance_squared = _mm_cvtss_f32(farthest);
+#endif
+    for (; i < vertex_count; ++i) {
+        f32 distance_squared = vec3_length_squared(vec3_subtract(vertices[i].position, sphere.center));
+        max_distance_squared = distance_squared > max_distance_squared ? distance_squared : max_distance_squared;
+    }
+    sphere.radius = c_sqrtf(max_distance_squared);
+    *out_sphere = sphere;
+}
+
+sphere_3d bounds_sphere_transform(sphere_3d sphere, mat4 model) {
+    const f32* m = model.data;
+    vec3 c = sphere.center;
+    sphere_3d result;
+    result.center.x = c.x * m[0] + c.y * m[4] + c.z * m[8] + m[12];
+    result.center.y = c.x * m[1] + c.y * m[5] + c.z * m[9] + m[13];
+    result.center.z = c.x * m[2] + c.y * m[6] + c.z * m[10] + m[14];
+
+    // the rows of the upper 3x3 are the transformed axes, their length is the scale along them
+    f32 scale_x = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+    f32 scale_y = m[4] * m[4] + m[5] * m[5] + m[6] * m[6];
+    f32 scale_z = m[8] * m[8] + m[9] * m[9] + m[10] * m[10];
+    f32 largest = scale_x > scale_y ? scale_x : scale_y;
+    largest = scale_z > largest ? scale_z : largest;
+    result.radius = sphere.radius * c_sqrtf(largest);
+    return result;
+}
+
+extents_3d bounds_extents_transform(extents_3d extents, mat4 model) {
+    const f32* m = model.data;
+    vec3 center = vec3_scale(vec3_add(extents.min, extents.max), 0.5f);
+    vec3 half_extent = vec3_scale(vec3_subtract(extents.max, extents.min), 0.5f);
+
+    // each axis of the new box gathers the moved half extents along it (Arvo)
+    vec3 moved_center;
+    vec3 moved_half_extent;
+    for (u32 j = 0; j < 3; ++j) {
+        moved_center.elements[j] = center.x * m[j] + center.y * m[4 + j] + center.z * m[8 + j] + m[12 + j];
+        moved_half_extent.elements[j] = c_absf(m[j]) * half_extent.x + c_absf(m[4 + j]) * half_extent.y +
+                                        c_absf(m[8 + j]) * half_extent.z;
+    }
+    extents_3d result = {vec3_subtract(moved_center, moved_half_extent), vec3_add(moved_center, moved_half_extent)};
+    return result;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "define.h"
+#include "math_types.h"
+
+/*
+ * Bounding volumes of vertex data, computed once when a geometry is created so the vertices
+ * don't have to stay on the CPU to cull or sort it.
+ */
+
+/**
+ * Compute the bounding box and a bounding sphere of vertices. The sphere is centered on the box,
+ * its radius reaching the farthest vertex. With cUSE_SIMD, the positions are reduced 4 at a time
+ * @param vertices the vertices
+ * @param vertex_count number of vertices, 0 gives an empty box and sphere at the origin
+ * @param out_extents receives the box, can be 0
+ * @param out_sphere receives the sphere, can be 0
+ */
+void bounds_from_vertices(const vertex_3d* vertices, u32 vertex_count, extents_3d* out_extents, sphere_3d* out_sphere);
+
+/**
+ * Move a bounding sphere by a model matrix. The radius is scaled by the largest scale of the
+ * matrix, so the sphere still contains the object when the scale isn't uniform
+ * @param sphere the sphere in model space
+ * @param model the model matrix, as applied by mat4_multiply (row vectors)
+ * @return the sphere in world space
+ */
+sphere_3d bounds_sphere_transform(sphere_3d sphere, mat4 model);
+
+/**
+ * Move a box by a model matrix
+ * @param extents the box in model space
+ * @param model the model matrix, as applied by mat4_multiply (row vectors)
+ * @return the smallest axis aligned box containing the moved box
+ */
+extents_3d bounds_extents_transform(extents_3d extents, mat4 model);
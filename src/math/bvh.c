@@ -0,0 +1,548 @@
+#include "bvh.h"
+
+#include "cmath.h"
+#include "core/cmemory.h"
+#include "core/logger.h"
+
+// deeper than any balanced tree that fits in memory
+#define BVH_QUERY_STACK_SIZE 256
+
+typedef enum bvh_frustum_result {
+    BVH_FRUSTUM_OUTSIDE,
+    BVH_FRUSTUM_INTERSECTS,
+    BVH_FRUSTUM_INSIDE,
+} bvh_frustum_result;
+
+cINLINE b8 node_is_leaf(const bvh_node* node) {
+    return node->children[0] == INVALID_ID;
+}
+
+cINLINE extents_3d extents_union(extents_3d a, extents_3d b) {
+    extents_3d result;
+    for (u32 i = 0; i < 3; ++i) {
+        result.min.elements[i] = a.min.elements[i] < b.min.elements[i] ? a.min.elements[i] : b.min.elements[i];
+        result.max.elements[i] = a.max.elements[i] > b.max.elements[i] ? a.max.elements[i] : b.max.elements[i];
+    }
+    return result;
+}
+
+// Half the surface of the box, the cost used to choose where leaves go
+cINLINE f32 extents_area(extents_3d e) {
+    f32 x = e.max.x - e.min.x;
+    f32 y = e.max.y - e.min.y;
+    f32 z = e.max.z - e.min.z;
+    return x * y + y * z + z * x;
+}
+
+cINLINE b8 extents_contains(extents_3d outer, extents_3d inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+           inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+static void link_free_nodes(bvh* tree, u32 first) {
+    for (u32 i = first; i < tree->node_capacity; ++i) {
+        tree->nodes[i].parent = i + 1 < tree->node_capacity ? i + 1 : INVALID_ID;
+        tree->nodes[i].height = -1;
+    }
+    tree->free_list = first;
+}
+
+static u32 allocate_node(bvh* tree) {
+    if (tree->free_list == INVALID_ID) {
+        u32 old_capacity = tree->node_capacity;
+        bvh_node* old_nodes = tree->nodes;
+        tree->node_capacity = old_capacity * 2;
+        tree->nodes = callocate(sizeof(bvh_node) * tree->node_capacity, MEMORY_TAG_BST);
+        ccopy_memory(tree->nodes, old_nodes, sizeof(bvh_node) * old_capacity);
+        cfree(old_nodes, sizeof(bvh_node) * old_capacity, MEMORY_TAG_BST);
+        link_free_nodes(tree, old_capacity);
+    }
+
+    u32 index = tree->free_list;
+    bvh_node* node = &tree->nodes[index];
+    tree->free_list = node->parent;
+    node->parent = INVALID_ID;
+    node->children[0] = INVALID_ID;
+    node->children[1] = INVALID_ID;
+    node->height = 0;
+    node->user_data = 0;
+    tree->node_count++;
+    return index;
+}
+
+static void free_node(bvh* tree, u32 index) {
+    tree->nodes[index].parent = tree->free_list;
+    tree->nodes[index].height = -1;
+    tree->free_list = index;
+    tree->node_count--;
+}
+
+// Replace a child of parent, or the root when parent is INVALID_ID
+static void replace_child(bvh* tree, u32 parent, u32 old_child, u32 new_child) {
+    if (parent == INVALID_ID) {
+        tree->root = new_child;
+        return;
+    }
+    bvh_node* p = &tree->nodes[parent];
+    p->children[p->children[0] == old_child ? 0 : 1] = new_child;
+}
+
+cINLINE i32 max_height(i32 a, i32 b) {
+    return a > b ? a : b;
+}
+
+// Lift a grandchild of a if one side is more than 1 taller than the other
+static u32 balance(bvh* tree, u32 ia) {
+    bvh_node* nodes = tree->nodes;
+    bvh_node* a = &nodes[ia];
+    if (node_is_leaf(a)) {
+        return ia;
+    }
+
+    // the tall child (up) takes the place of a, a takes the shorter of its children
+    u32 ib = a->children[0];
+    u32 ic = a->children[1];
+    i32 difference = nodes[ic].height - nodes[ib].height;
+    if (difference >= -1 && difference <= 1) {
+        return ia;
+    }
+    u32 up_side = difference > 1 ? 1 : 0;
+    u32 iup = a->children[up_side];
+    u32 istay = a->children[1 - up_side];
+    bvh_node* up = &nodes[iup];
+    u32 i0 = up->children[0];
+    u32 i1 = up->children[1];
+    u32 ikeep = nodes[i0].height > nodes[i1].height ? i0 : i1;
+    u32 igive = ikeep == i0 ? i1 : i0;
+
+    up->children[0] = ia;
+    up->children[1] = ikeep;
+    up->parent = a->parent;
+    a->parent = iup;
+    replace_child(tree, up->parent, ia, iup);
+
+    a->children[up_side] = igive;
+    nodes[igive].parent = ia;
+    a->extents = extents_union(nodes[istay].extents, nodes[igive].extents);
+    a->height = 1 + max_height(nodes[istay].height, nodes[igive].height);
+    up->extents = extents_union(a->extents, nodes[ikeep].extents);
+    up->height = 1 + max_height(a->height, nodes[ikeep].height);
+    return iup;
+}
+
+// Refit and rebalance the ancestors of a node up to the root
+static void refit(bvh* tree, u32 index) {
+    while (index != INVALID_ID) {
+        index = balance(tree, index);
+        bvh_node* node = &tree->nodes[index];
+        bvh_node* c0 = &tree->nodes[node->children[0]];
+        bvh_node* c1 = &tree->nodes[node->children[1]];
+        node->height = 1 + max_height(c0->height, c1->height);
+        node->extents = extents_union(c0->extents, c1->extents);
+        index = node->parent;
+    }
+}
+
+static void insert_leaf(bvh* tree, u32 leaf) {
+    if (tree->root == INVALID_ID) {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = INVALID_ID;
+        return;
+    }
+
+    // go down while making the new leaf a sibling deeper is cheaper (surface area heuristic)
+    extents_3d leaf_extents = tree->nodes[leaf].extents;
+    u32 index = tree->root;
+    while (!node_is_leaf(&tree->nodes[index])) {
+        const bvh_node* node = &tree->nodes[index];
+        f32 area = extents_area(node->extents);
+        f32 combined_area = extents_area(extents_union(node->extents, leaf_extents));
+        // a sibling here adds a parent covering both
+        f32 cost = 2.0f * combined_area;
+        // going down grows every ancestor
+        f32 inheritance_cost = 2.0f * (combined_area - area);
+
+        f32 child_costs[2];
+        for (u32 i = 0; i < 2; ++i) {
+            const bvh_node* child = &tree->nodes[node->children[i]];
+            f32 grown = extents_area(extents_union(child->extents, leaf_extents));
+            child_costs[i] = (node_is_leaf(child) ? grown : grown - extents_area(child->extents)) + inheritance_cost;
+        }
+        if (cost < child_costs[0] && cost < child_costs[1]) {
+            break;
+        }
+        index = node->children[child_costs[0] < child_costs[1] ? 0 : 1];
+    }
+
+    u32 sibling = index;
+    u32 new_parent = allocate_node(tree);
+    // allocating may move the nodes
+    bvh_node* nodes = tree->nodes;
+    u32 old_parent = nodes[sibling].parent;
+    nodes[new_parent].parent = old_parent;
+    nodes[new_parent].extents = extents_union(leaf_extents, nodes[sibling].extents);
+    nodes[new_parent].height = nodes[sibling].height + 1;
+    nodes[new_parent].children[0] = sibling;
+    nodes[new_parent].children[1] = leaf;
+    nodes[sibling].parent = new_parent;
+    nodes[leaf].parent = new_parent;
+    replace_child(tree, old_parent, sibling, new_parent);
+
+    refit(tree, new_parent);
+}
+
+static void remove_leaf(bvh* tree, u32 leaf) {
+    if (leaf == tree->root) {
+        tree->root = INVALID_ID;
+        return;
+    }
+
+    bvh_node* nodes = tree->nodes;
+    u32 parent = nodes[leaf].parent;
+    u32 grandparent = nodes[parent].parent;
+    u32 sibling = nodes[parent].children[nodes[parent].children[0] == leaf ? 1 : 0];
+
+    // the sibling takes the place of the parent
+    replace_child(tree, grandparent, parent, sibling);
+    nodes[sibling].parent = grandparent;
+    free_node(tree, parent);
+
+    refit(tree, grandparent);
+}
+
+b8 bvh_create(u32 initial_capacity, f32 margin, bvh* out_tree) {
+    if (!out_tree) {
+        LOG_ERROR("bvh_create requires a valid pointer to a tree");
+        return false;
+    }
+    // a tree of n objects has 2n - 1 nodes
+    u32 capacity = initial_capacity > 0 ? initial_capacity * 2 : 2;
+    out_tree->nodes = callocate(sizeof(bvh_node) * capacity, MEMORY_TAG_BST);
+    out_tree->node_capacity = capacity;
+    out_tree->node_count = 0;
+    out_tree->root = INVALID_ID;
+    out_tree->margin = margin;
+    link_free_nodes(out_tree, 0);
+    return true;
+}
+
+void bvh_destroy(bvh* tree) {
+    if (tree->nodes) {
+        cfree(tree->nodes, sizeof(bvh_node) * tree->node_capacity, MEMORY_TAG_BST);
+    }
+    czero_memory(tree, sizeof(bvh));
+    tree->root = INVALID_ID;
+    tree->free_list = INVALID_ID;
+}
+
+u32 bvh_insert(bvh* tree, extents_3d extents, u64 user_data) {
+    u32 proxy = allocate_node(tree);
+    bvh_node* node = &tree->nodes[proxy];
+    vec3 margin = vec3_create_from_scalar(tree->margin);
+    node->extents.min = vec3_subtract(extents.min, margin);
+    node->extents.max = vec3_add(extents.max, margin);
+    node->user_data = user_data;
+    insert_leaf(tree, proxy);
+    return proxy;
+}
+
+void bvh_remove(bvh* tree, u32 proxy) {
+    if (proxy >= tree->node_capacity || !node_is_leaf(&tree->nodes[proxy]) || tree->nodes[proxy].height != 0) {
+        LOG_ERROR("bvh_remove called with an invalid proxy %u", proxy);
+        return;
+    }
+    remove_leaf(tree, proxy);
+    free_node(tree, proxy);
+}
+
+b8 bvh_move(bvh* tree, u32 proxy, extents_3d extents) {
+    if (proxy >= tree->node_capacity || !node_is_leaf(&tree->nodes[proxy]) || tree->nodes[proxy].height != 0) {
+        LOG_ERROR("bvh_move called with an invalid proxy %u", proxy);
+        return false;
+    }
+    if (extents_contains(tree->nodes[proxy].extents, extents)) {
+        return false;
+    }
+
+    remove_leaf(tree, proxy);
+    vec3 margin = vec3_create_from_scalar(tree->margin);
+    tree->nodes[proxy].extents.min = vec3_subtract(extents.min, margin);
+    tree->nodes[proxy].extents.max = vec3_add(extents.max, margin);
+    insert_leaf(tree, proxy);
+    return true;
+}
+
+u64 bvh_get_user_data(const bvh* tree, u32 proxy) {
+    return tree->nodes[proxy].user_data;
+}
+
+extents_3d bvh_get_fat_extents(const bvh* tree, u32 proxy) {
+    return tree->nodes[proxy].extents;
+}
+
+u32 bvh_get_height(const bvh* tree) {
+    return tree->root == INVALID_ID ? 0 : (u32)tree->nodes[tree->root].height;
+}
+
+// Push the children of a node on a query stack, starting to load them while other nodes are tested
+cINLINE void push_children(const bvh* tree, const bvh_node* node, u32* stack, u32* stack_count) {
+#if defined(cUSE_SIMD)
+    _mm_prefetch((const char*)&tree->nodes[node->children[0]], _MM_HINT_T0);
+    _mm_prefetch((const char*)&tree->nodes[node->children[1]], _MM_HINT_T0);
+#endif
+    stack[(*stack_count)++] = node->children[0];
+    stack[(*stack_count)++] = node->children[1];
+}
+
+// Report every leaf under a node
+static b8 report_subtree(const bvh* tree, u32 index, PFN_bvh_query_callback callback, void* context) {
+    u32 stack[BVH_QUERY_STACK_SIZE];
+    u32 stack_count = 0;
+    stack[stack_count++] = index;
+    while (stack_count > 0) {
+        const bvh_node* node = &tree->nodes[stack[--stack_count]];
+        if (node_is_leaf(node)) {
+            if (!callback(stack[stack_count], node->user_data, context)) {
+                return false;
+            }
+            continue;
+        }
+        push_children(tree, node, stack, &stack_count);
+    }
+    return true;
+}
+
+#if defined(cUSE_SIMD)
+// The planes of a frustum as 2 groups of 4, the last 2 planes always passing
+typedef struct bvh_frustum_planes {
+    __m128 normal_x[2];
+    __m128 normal_y[2];
+    __m128 normal_z[2];
+    __m128 abs_normal_x[2];
+    __m128 abs_normal_y[2];
+    __m128 abs_normal_z[2];
+    __m128 distance[2];
+} bvh_frustum_planes;
+
+static void frustum_planes_load(const frustum* f, bvh_frustum_planes* out_planes) {
+    alignas(16) f32 values[4][8];
+    for (u32 i = 0; i < 8; ++i) {
+        b8 used = i < FRUSTUM_SIDE_COUNT;
+        values[0][i] = used ? f->sides[i].normal.x : 0.0f;
+        values[1][i] = used ? f->sides[i].normal.y : 0.0f;
+        values[2][i] = used ? f->sides[i].normal.z : 0.0f;
+        values[3][i] = used ? f->sides[i].distance : 1e30f;
+    }
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    for (u32 g = 0; g < 2; ++g) {
+        out_planes->normal_x[g] = _mm_load_ps(&values[0][g * 4]);
+        out_planes->normal_y[g] = _mm_load_ps(&values[1][g * 4]);
+        out_planes->normal_z[g] = _mm_load_ps(&values[2][g * 4]);
+        out_planes->distance[g] = _mm_load_ps(&values[3][g * 4]);
+        out_planes->abs_normal_x[g] = _mm_andnot_ps(sign_mask, out_planes->normal_x[g]);
+        out_planes->abs_normal_y[g] = _mm_andnot_ps(sign_mask, out_planes->normal_y[g]);
+        out_planes->abs_normal_z[g] = _mm_andnot_ps(sign_mask, out_planes->normal_z[g]);
+    }
+}
+
+// Test a box against the 6 planes at once, 4 planes per instruction
+static bvh_frustum_result frustum_test_extents(const bvh_frustum_planes* planes, const extents_3d* e) {
+    // the 4th lane of the loads is the next field of the node, never used
+    __m128 minimum = _mm_loadu_ps(e->min.elements);
+    __m128 maximum = _mm_loadu_ps(e->max.elements);
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 center = _mm_mul_ps(_mm_add_ps(minimum, maximum), half);
+    __m128 extent = _mm_mul_ps(_mm_sub_ps(maximum, minimum), half);
+    __m128 cx = c_mm_shuffle(center, 0, 0, 0, 0);
+    __m128 cy = c_mm_shuffle(center, 1, 1, 1, 1);
+    __m128 cz = c_mm_shuffle(center, 2, 2, 2, 2);
+    __m128 ex = c_mm_shuffle(extent, 0, 0, 0, 0);
+    __m128 ey = c_mm_shuffle(extent, 1, 1, 1, 1);
+    __m128 ez = c_mm_shuffle(extent, 2, 2, 2, 2);
+
+    __m128 zero = _mm_setzero_ps();
+    i32 outside = 0;
+    i32 crossing = 0;
+    for (u32 g = 0; g < 2; ++g) {
+        __m128 distance = c_mm_madd_ps(planes->normal_x[g], cx, planes->distance[g]);
+        distance = c_mm_madd_ps(planes->normal_y[g], cy, distance);
+        distance = c_mm_madd_ps(planes->normal_z[g], cz, distance);
+        __m128 reach = _mm_mul_ps(planes->abs_normal_x[g], ex);
+        reach = c_mm_madd_ps(planes->abs_normal_y[g], ey, reach);
+        reach = c_mm_madd_ps(planes->abs_normal_z[g], ez, reach);
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, reach), zero));
+        crossing |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, reach), zero));
+    }
+    if (outside) {
+        return BVH_FRUSTUM_OUTSIDE;
+    }
+    return crossing ? BVH_FRUSTUM_INTERSECTS : BVH_FRUSTUM_INSIDE;
+}
+#else
+typedef struct bvh_frustum_planes {
+    frustum f;
+} bvh_frustum_planes;
+
+static void frustum_planes_load(const frustum* f, bvh_frustum_planes* out_planes) {
+    out_planes->f = *f;
+}
+
+static bvh_frustum_result frustum_test_extents(const bvh_frustum_planes* planes, const extents_3d* e) {
+    vec3 center = vec3_scale(vec3_add(e->min, e->max), 0.5f);
+    vec3 extent = vec3_scale(vec3_subtract(e->max, e->min), 0.5f);
+    bvh_frustum_result result = BVH_FRUSTUM_INSIDE;
+    for (u32 i = 0; i < FRUSTUM_SIDE_COUNT; ++i) {
+        const plane_3d* p = &planes->f.sides[i];
+        f32 distance = vec3_dot(p->normal, center) + p->distance;
+        f32 reach = c_absf(p->normal.x) * extent.x + c_absf(p->normal.y) * extent.y + c_absf(p->normal.z) * extent.z;
+        if (distance + reach < 0.0f) {
+            return BVH_FRUSTUM_OUTSIDE;
+        }
+        if (distance - reach < 0.0f) {
+            result = BVH_FRUSTUM_INTERSECTS;
+        }
+    }
+    return result;
+}
+#endif
+
+void bvh_query_frustum(const bvh* tree, const frustum* f, PFN_bvh_query_callback callback, void* context) {
+    if (tree->root == INVALID_ID) {
+        return;
+    }
+    bvh_frustum_planes planes;
+    frustum_planes_load(f, &planes);
+
+    u32 stack[BVH_QUERY_STACK_SIZE];
+    u32 stack_count = 0;
+    stack[stack_count++] = tree->root;
+    while (stack_count > 0) {
+        u32 index = stack[--stack_count];
+        const bvh_node* node = &tree->nodes[index];
+        bvh_frustum_result result = frustum_test_extents(&planes, &node->extents);
+        if (result == BVH_FRUSTUM_OUTSIDE) {
+            continue;
+        }
+        if (result == BVH_FRUSTUM_INSIDE || node_is_leaf(node)) {
+            if (!report_subtree(tree, index, callback, context)) {
+                return;
+            }
+            continue;
+        }
+        if (stack_count + 2 > BVH_QUERY_STACK_SIZE) {
+            LOG_ERROR("bvh_query_frustum: the tree is too deep, results are incomplete");
+            return;
+        }
+        push_children(tree, node, stack, &stack_count);
+    }
+}
+
+void bvh_query_overlap(const bvh* tree, extents_3d extents, PFN_bvh_query_callback callback, void* context) {
+    if (tree->root == INVALID_ID) {
+        return;
+    }
+#if defined(cUSE_SIMD)
+    vec4 query_min = vec4_create(extents.min.x, extents.min.y, extents.min.z, 0.0f);
+    vec4 query_max = vec4_create(extents.max.x, extents.max.y, extents.max.z, 0.0f);
+#endif
+
+    u32 stack[BVH_QUERY_STACK_SIZE];
+    u32 stack_count = 0;
+    stack[stack_count++] = tree->root;
+    while (stack_count > 0) {
+        u32 index = stack[--stack_count];
+        const bvh_node* node = &tree->nodes[index];
+#if defined(cUSE_SIMD)
+        __m128 overlap = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node->extents.min.elements), query_max.data),
+                                    _mm_cmple_ps(query_min.data, _mm_loadu_ps(node->extents.max.elements)));
+        if ((_mm_movemask_ps(overlap) & 7) != 7) {
+            continue;
+        }
+#else
+        const extents_3d* e = &node->extents;
+        if (e->min.x > extents.max.x || e->min.y > extents.max.y || e->min.z > extents.max.z ||
+            extents.min.x > e->max.x || extents.min.y > e->max.y || extents.min.z > e->max.z) {
+            continue;
+        }
+#endif
+        if (node_is_leaf(node)) {
+            if (!callback(index, node->user_data, context)) {
+                return;
+            }
+            continue;
+        }
+        if (stack_count + 2 > BVH_QUERY_STACK_SIZE) {
+            LOG_ERROR("bvh_query_overlap: the tree is too deep, results are incomplete");
+            return;
+        }
+        push_children(tree, node, stack, &stack_count);
+    }
+}
+
+void bvh_raycast(const bvh* tree, vec3 origin, vec3 direction, f32 max_distance, PFN_bvh_raycast_callback callback, void* context) {
+    if (tree->root == INVALID_ID) {
+        return;
+    }
+    // 1 / 0 is infinite, which the slab test handles except for a ray exactly on a face
+    vec3 inverse_direction = {{1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z}};
+#if defined(cUSE_SIMD)
+    __m128 ray_origin = _mm_set_ps(0.0f, origin.z, origin.y, origin.x);
+    __m128 ray_inverse = _mm_set_ps(0.0f, inverse_direction.z, inverse_direction.y, inverse_direction.x);
+    __m128 ray_end = _mm_set1_ps(max_distance);
+    __m128 zero = _mm_setzero_ps();
+#endif
+
+    u32 stack[BVH_QUERY_STACK_SIZE];
+    u32 stack_count = 0;
+    stack[stack_count++] = tree->root;
+    while (stack_count > 0) {
+        u32 index = stack[--stack_count];
+        const bvh_node* node = &tree->nodes[index];
+#if defined(cUSE_SIMD)
+        // slab test on the 3 axes at once, the unused 4th lane copying the 3rd
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node->extents.min.elements), ray_origin), ray_inverse);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node->extents.max.elements), ray_origin), ray_inverse);
+        __m128 t_enter = _mm_max_ps(c_mm_shuffle(_mm_min_ps(t0, t1), 0, 1, 2, 2), zero);
+        __m128 t_exit = _mm_min_ps(c_mm_shuffle(_mm_max_ps(t0, t1), 0, 1, 2, 2), ray_end);
+        t_enter = _mm_max_ps(t_enter, c_mm_shuffle(t_enter, 1, 0, 3, 2));
+        t_enter = _mm_max_ps(t_enter, c_mm_shuffle(t_enter, 2, 3, 0, 1));
+        t_exit = _mm_min_ps(t_exit, c_mm_shuffle(t_exit, 1, 0, 3, 2));
+        t_exit = _mm_min_ps(t_exit, c_mm_shuffle(t_exit, 2, 3, 0, 1));
+        if (_mm_comigt_ss(t_enter, t_exit)) {
+            continue;
+        }
+#else
+        f32 t_enter = 0.0f;
+        f32 t_exit = max_distance;
+        for (u32 i = 0; i < 3; ++i) {
+            f32 t0 = (node->extents.min.elements[i] - origin.elements[i]) * inverse_direction.elements[i];
+            f32 t1 = (node->extents.max.elements[i] - origin.elements[i]) * inverse_direction.elements[i];
+            f32 t_near = t0 < t1 ? t0 : t1;
+            f32 t_far = t0 < t1 ? t1 : t0;
+            t_enter = t_near > t_enter ? t_near : t_enter;
+            t_exit = t_far < t_exit ? t_far : t_exit;
+        }
+        if (t_enter > t_exit) {
+            continue;
+        }
+#endif
+        if (node_is_leaf(node)) {
+            f32 distance = callback(index, node->user_data, max_distance, context);
+            if (distance == 0.0f) {
+                return;
+            }
+            if (distance < max_distance) {
+                max_distance = distance;
+#if defined(cUSE_SIMD)
+                ray_end = _mm_set1_ps(max_distance);
+#endif
+            }
+            continue;
+        }
+        if (stack_count + 2 > BVH_QUERY_STACK_SIZE) {
+            LOG_ERROR("bvh_raycast: the tree is too deep, results are incomplete");
+            return;
+        }
+        push_children(tree, node, stack, &stack_count);
+    }
+}
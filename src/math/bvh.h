@@ -0,0 +1,121 @@
+#pragma once
+
+#include "define.h"
+#include "math_types.h"
+
+/*
+ * Dynamic bounding volume hierarchy: a binary tree of axis aligned boxes updated one object at
+ * a time, to find the objects in a frustum, along a ray or overlapping a box without testing
+ * all of them.
+ *
+ * Each object is a leaf holding a fat box, its box grown by the margin of the tree, so an
+ * object moving a little stays in its leaf. New leaves go where they grow the surface of the
+ * tree the least, and the tree is kept balanced with rotations like an AVL tree. With
+ * cUSE_SIMD, each node box is tested in a few SSE instructions.
+ *
+ * Objects are identified by the index of their leaf (a proxy), which never changes while
+ * the object is in the tree. The tree doesn't lock: update and query it from one thread at
+ * a time, or query it from many threads while nothing updates it.
+ */
+
+typedef struct bvh_node {
+    // fat box for leaves, the union of the children for the others
+    extents_3d extents;
+    // the next free node while the node is free
+    u32 parent;
+    // INVALID_ID for leaves
+    u32 children[2];
+    // 0 for leaves, -1 for free nodes
+    i32 height;
+    u64 user_data;
+} bvh_node;
+
+typedef struct bvh {
+    bvh_node* nodes;
+    u32 node_capacity;
+    u32 node_count;
+    u32 root;
+    u32 free_list;
+    // how much each side of a leaf box is grown
+    f32 margin;
+} bvh;
+
+/**
+ * Called for each object found by a query
+ * @param proxy the object
+ * @param user_data the value given when the object was inserted
+ * @param context the context given to the query
+ * @return false to stop the query
+ */
+typedef b8 (*PFN_bvh_query_callback)(u32 proxy, u64 user_data, void* context);
+
+/**
+ * Called for each object whose fat box is hit by the ray, closest first is not guaranteed
+ * @param proxy the object
+ * @param user_data the value given when the object was inserted
+ * @param max_distance how far along the ray the query currently looks
+ * @param context the context given to the query
+ * @return the distance of the hit to only look for closer objects, max_distance to ignore this
+ * object, or 0 to stop the query
+ */
+typedef f32 (*PFN_bvh_raycast_callback)(u32 proxy, u64 user_data, f32 max_distance, void* context);
+
+/**
+ * Create a tree
+ * @param initial_capacity number of objects before the nodes grow, at least 1
+ * @param margin how much each side of the object boxes is grown, 0 for exact boxes
+ * @param out_tree the tree to be filled
+ * @return true on success
+ */
+b8 bvh_create(u32 initial_capacity, f32 margin, bvh* out_tree);
+
+void bvh_destroy(bvh* tree);
+
+/**
+ * Add an object
+ * @param tree the tree
+ * @param extents the box of the object in world space, see bounds_extents_transform
+ * @param user_data any value, given back by the queries
+ * @return the proxy of the object
+ */
+u32 bvh_insert(bvh* tree, extents_3d extents, u64 user_data);
+
+void bvh_remove(bvh* tree, u32 proxy);
+
+/**
+ * Update the box of an object. Nothing changes in the tree while the box stays in the fat box
+ * of the object
+ * @param tree the tree
+ * @param proxy the object
+ * @param extents the new box of the object
+ * @return true if the object was moved in the tree
+ */
+b8 bvh_move(bvh* tree, u32 proxy, extents_3d extents);
+
+u64 bvh_get_user_data(const bvh* tree, u32 proxy);
+
+// The box of an object as stored in the tree, grown by the margin
+extents_3d bvh_get_fat_extents(const bvh* tree, u32 proxy);
+
+// Height of the tree, 0 for an empty tree or a single object
+u32 bvh_get_height(const bvh* tree);
+
+/**
+ * Find the objects whose fat box is at least partly in a frustum. Subtrees entirely inside
+ * the frustum are reported without more tests
+ */
+void bvh_query_frustum(const bvh* tree, const frustum* f, PFN_bvh_query_callback callback, void* context);
+
+// Find the objects whose fat box overlaps a box
+void bvh_query_overlap(const bvh* tree, extents_3d extents, PFN_bvh_query_callback callback, void* context);
+
+/**
+ * Find the objects whose fat box is hit by a ray
+ * @param tree the tree
+ * @param origin start of the ray
+ * @param direction direction of the ray, distances are in multiples of its length
+ * @param max_distance end of the ray
+ * @param callback called for each hit box, can shorten the ray
+ * @param context given to the callback
+ */
+void bvh_raycast(const bvh* tree, vec3 origin, vec3 direction, f32 max_distance, PFN_bvh_raycast_callback callback, void* context);
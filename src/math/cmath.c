@@ -1,10 +1,8 @@
 #include "cmath.h"
+#include "crandom.h"
 
-#include "platform/platform.h"
 #include <math.h>
 
-static b8 rand_seeded = false;
-
 f32 c_sinf(f32 x) {
     return sinf(x);
 }
@@ -25,30 +23,27 @@ f32 c_sqrtf(f32 x) {
     return sqrtf(x);
 }
 
+f64 c_sqrt(f64 x) {
+    return sqrt(x);
+}
+
 f32 c_absf(f32 x) {
     return fabsf(x);
 }
 
 i32 crandom() {
-    if (!rand_seeded) {
-        srand((u32)platform_get_absolute_time());
-        rand_seeded = true;
-    }
-    return rand();
+    // same range as rand() with glibc
+    return (i32)(random_next_u32(random_thread_state()) >> 1);
 }
 
 i32 crandom_in_range(i32 min, i32 max) {
-    return crandom() % (max - min + 1) + min;
+    return random_range_i32(random_thread_state(), min, max);
 }
 
 f32 fcrandom() {
-    if (!rand_seeded) {
-        srand((u32)platform_get_absolute_time());
-        rand_seeded = true;
-    }
-    return (f32)rand() / (f32)RAND_MAX;
+    return random_next_f32(random_thread_state());
 }
 
 f32 fcrandom_in_range(f32 min, f32 max) {
-    return fcrandom() * (max - min) + min;
+    return random_range_f32(random_thread_state(), min, max);
 }
@@ -25,11 +25,29 @@
 #define INFINITY 1e30f
 #define FLOAT_EPSILON 1.192092896e-07f
 
+#if defined(cUSE_SIMD)
+// a * b + c, fused when the compiler targets FMA
+#if defined(__FMA__)
+#define c_mm_madd_ps(a, b, c) _mm_fmadd_ps(a, b, c)
+#else
+#define c_mm_madd_ps(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+#endif
+
+#define c_mm_shuffle(v, x, y, z, w) _mm_shuffle_ps(v, v, _MM_SHUFFLE(w, z, y, x))
+
+// sum of the 4 lanes, in every lane
+cINLINE __m128 c_mm_hsum_ps(__m128 v) {
+    __m128 s = _mm_add_ps(v, c_mm_shuffle(v, 1, 0, 3, 2));
+    return _mm_add_ps(s, c_mm_shuffle(s, 2, 3, 0, 1));
+}
+#endif
+
 f32 c_sinf(f32 x);
 f32 c_cosf(f32 x);
 f32 c_tanf(f32 x);
 f32 c_acosf(f32 x);
 f32 c_sqrtf(f32 x);
+f64 c_sqrt(f64 x);
 f32 c_absf(f32 x);
 
 
@@ -37,9 +55,12 @@ cINLINE b8 is_power_of_2(u64 value) {
     return (value != 0) && ((value & (value - 1)) == 0);
 }
 
+// random numbers from the generator of the calling thread, see crandom.h
 i32 crandom();
+// in [min, max], both included
 i32 crandom_in_range(i32 min, i32 max);
 
+// in [0, 1)
 f32 fcrandom();
 f32 fcrandom_in_range(f32 min, f32 max);
 
@@ -249,46 +270,74 @@ cINLINE vec4 vec4_one() {
 
 cINLINE vec4 vec4_add(vec4 a, vec4 b) {
     vec4 result;
+#if defined(cUSE_SIMD)
+    result.data = _mm_add_ps(a.data, b.data);
+#else
     for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = a.elements[i] + b.elements[i];
     }
+#endif
     return result;
 }
 
 cINLINE vec4 vec4_subtract(vec4 a, vec4 b) {
     vec4 result;
+#if defined(cUSE_SIMD)
+    result.data = _mm_sub_ps(a.data, b.data);
+#else
     for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = a.elements[i] - b.elements[i];
     }
+#endif
     return result;
 }
 
 cINLINE vec4 vec4_multiply(vec4 a, vec4 b) {
     vec4 result;
+#if defined(cUSE_SIMD)
+    result.data = _mm_mul_ps(a.data, b.data);
+#else
     for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = a.elements[i] * b.elements[i];
     }
+#endif
     return result;
 }
 
 cINLINE vec4 vec4_divide(vec4 a, vec4 b) {
     vec4 result;
+#if defined(cUSE_SIMD)
+    result.data = _mm_div_ps(a.data, b.data);
+#else
     for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = a.elements[i] / b.elements[i];
     }
+#endif
     return result;
 }
 
 cINLINE vec4 vec4_scale(vec4 a, f32 scalar) {
     vec4 result;
+#if defined(cUSE_SIMD)
+    result.data = _mm_mul_ps(a.data, _mm_set1_ps(scalar));
+#else
     for (u64 i = 0; i < 4; ++i) {
         result.elements[i] = a.elements[i] * scalar;
     }
+#endif
     return result;
 }
 
+cINLINE f32 vec4_dot(vec4 a, vec4 b) {
+#if defined(cUSE_SIMD)
+    return _mm_cvtss_f32(c_mm_hsum_ps(_mm_mul_ps(a.data, b.data)));
+#else
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+#endif
+}
+
 cINLINE f32 vec4_length_squared(vec4 a) {
-    return a.x * a.x + a.y * a.y + a.z * a.z + a.w * a.w;
+    return vec4_dot(a, a);
 }
 
 cINLINE f32 vec4_length(vec4 a) {
@@ -296,12 +345,15 @@ cINLINE f32 vec4_length(vec4 a) {
 }
 
 cINLINE void vec4_normalize(vec4* a) {
-
     f32 length = vec4_length(*a);
+#if defined(cUSE_SIMD)
+    a->data = _mm_div_ps(a->data, _mm_set1_ps(length));
+#else
     a->x /= length;
     a->y /= length;
     a->z /= length;
     a->w /= length;
+#endif
 }
 
 cINLINE vec4 vec4_normalized(vec4 a) {
@@ -323,6 +375,18 @@ cINLINE mat4 mat4_identity() {
 }
 
 cINLINE mat4 mat4_multiply(mat4 a, mat4 b) {
+#if defined(cUSE_SIMD)
+    // each row of the result is a combination of the rows of b
+    mat4 simd_result;
+    for (i32 i = 0; i < 4; ++i) {
+        __m128 row = _mm_mul_ps(_mm_set1_ps(a.data[i * 4 + 0]), b.rows[0]);
+        row = c_mm_madd_ps(_mm_set1_ps(a.data[i * 4 + 1]), b.rows[1], row);
+        row = c_mm_madd_ps(_mm_set1_ps(a.data[i * 4 + 2]), b.rows[2], row);
+        row = c_mm_madd_ps(_mm_set1_ps(a.data[i * 4 + 3]), b.rows[3], row);
+        simd_result.rows[i] = row;
+    }
+    return simd_result;
+#else
     mat4 result = mat4_identity();
 
     const f32* m1_ptr = a.data;
@@ -342,6 +406,7 @@ cINLINE mat4 mat4_multiply(mat4 a, mat4 b) {
     }
 
     return result;
+#endif
 }
 
 cINLINE mat4 mat4_orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 near, f32 far) {
@@ -417,6 +482,10 @@ cINLINE mat4 mat4_look_at(vec3 position, vec3 target, vec3 up) {
 }
 
 cINLINE mat4 mat4_transposed(mat4 a) {
+#if defined(cUSE_SIMD)
+    _MM_TRANSPOSE4_PS(a.rows[0], a.rows[1], a.rows[2], a.rows[3]);
+    return a;
+#else
     mat4 result = mat4_identity();
     result.data[0] = a.data[0];
     result.data[1] = a.data[4];
@@ -435,9 +504,75 @@ cINLINE mat4 mat4_transposed(mat4 a) {
     result.data[14] = a.data[11];
     result.data[15] = a.data[15];
     return result;
+#endif
 }
 
+#if defined(cUSE_SIMD)
+// 2x2 matrices stored as (m00, m01, m10, m11) in a register
+// a * b
+cINLINE __m128 c_mm_mat2_mul(__m128 a, __m128 b) {
+    return _mm_add_ps(_mm_mul_ps(a, c_mm_shuffle(b, 0, 3, 0, 3)),
+                      _mm_mul_ps(c_mm_shuffle(a, 1, 0, 3, 2), c_mm_shuffle(b, 2, 1, 2, 1)));
+}
+// adjugate(a) * b
+cINLINE __m128 c_mm_mat2_adj_mul(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(c_mm_shuffle(a, 3, 3, 0, 0), b),
+                      _mm_mul_ps(c_mm_shuffle(a, 1, 1, 2, 2), c_mm_shuffle(b, 2, 3, 0, 1)));
+}
+// a * adjugate(b)
+cINLINE __m128 c_mm_mat2_mul_adj(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(a, c_mm_shuffle(b, 3, 0, 3, 0)),
+                      _mm_mul_ps(c_mm_shuffle(a, 1, 0, 3, 2), c_mm_shuffle(b, 2, 1, 2, 1)));
+}
+#endif
+
 cINLINE mat4 mat4_inverse(mat4 a) {
+#if defined(cUSE_SIMD)
+    // block inverse on the four 2x2 sub matrices | A B |
+    //                                            | C D |
+    __m128 A = _mm_movelh_ps(a.rows[0], a.rows[1]);
+    __m128 B = _mm_movehl_ps(a.rows[1], a.rows[0]);
+    __m128 C = _mm_movelh_ps(a.rows[2], a.rows[3]);
+    __m128 D = _mm_movehl_ps(a.rows[3], a.rows[2]);
+
+    // determinants of the sub matrices (|A|, |B|, |C|, |D|)
+    __m128 det_sub = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(a.rows[0], a.rows[2], _MM_SHUFFLE(2, 0, 2, 0)),
+                   _mm_shuffle_ps(a.rows[1], a.rows[3], _MM_SHUFFLE(3, 1, 3, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(a.rows[0], a.rows[2], _MM_SHUFFLE(3, 1, 3, 1)),
+                   _mm_shuffle_ps(a.rows[1], a.rows[3], _MM_SHUFFLE(2, 0, 2, 0))));
+    __m128 det_a = c_mm_shuffle(det_sub, 0, 0, 0, 0);
+    __m128 det_b = c_mm_shuffle(det_sub, 1, 1, 1, 1);
+    __m128 det_c = c_mm_shuffle(det_sub, 2, 2, 2, 2);
+    __m128 det_d = c_mm_shuffle(det_sub, 3, 3, 3, 3);
+
+    __m128 d_c = c_mm_mat2_adj_mul(D, C);
+    __m128 a_b = c_mm_mat2_adj_mul(A, B);
+    // adjugates of the blocks of the inverse
+    __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, A), c_mm_mat2_mul(B, d_c));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, D), c_mm_mat2_mul(C, a_b));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, C), c_mm_mat2_mul_adj(D, a_b));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, B), c_mm_mat2_mul_adj(A, d_c));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 det_m = _mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c));
+    __m128 trace = c_mm_hsum_ps(_mm_mul_ps(a_b, c_mm_shuffle(d_c, 0, 2, 1, 3)));
+    det_m = _mm_sub_ps(det_m, trace);
+
+    __m128 inv_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_m);
+    x = _mm_mul_ps(x, inv_det);
+    y = _mm_mul_ps(y, inv_det);
+    z = _mm_mul_ps(z, inv_det);
+    w = _mm_mul_ps(w, inv_det);
+
+    // adjugate the blocks while storing them
+    mat4 simd_result;
+    simd_result.rows[0] = _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3));
+    simd_result.rows[1] = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2));
+    simd_result.rows[2] = _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3));
+    simd_result.rows[3] = _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2));
+    return simd_result;
+#else
     const f32* m = a.data;
 
     const f32 t0 = m[10] * m[15];
@@ -493,6 +628,233 @@ cINLINE mat4 mat4_inverse(mat4 a) {
     o[14] = d * ((t18 * m[6] + t23 * m[14] + t15 * m[2]) - (t22 * m[14] + t14 * m[2] + t19 * m[6]));
     o[15] = d * ((t22 * m[10] + t16 * m[2] + t21 * m[6]) - (t20 * m[6] + t23 * m[10] + t17 * m[2]));
 
+    return result;
+#endif
+}
+
+#if defined(cUSE_SIMD)
+// a x b on the first 3 lanes, 0 in the last one
+cINLINE __m128 c_mm_cross3_ps(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(c_mm_shuffle(a, 1, 2, 0, 3), c_mm_shuffle(b, 2, 0, 1, 3)),
+                      _mm_mul_ps(c_mm_shuffle(a, 2, 0, 1, 3), c_mm_shuffle(b, 1, 2, 0, 3)));
+}
+#endif
+
+/**
+ * Inverse of a rotation followed by a translation, such as a camera transform: the
+ * rotation is transposed and the translation rotated back. Much cheaper than mat4_inverse
+ * @param a the matrix, its upper 3x3 must be orthonormal (no scale) and its last column (0, 0, 0, 1)
+ * @return the inverse of a
+ */
+cINLINE mat4 mat4_inverse_rigid(mat4 a) {
+#if defined(cUSE_SIMD)
+    mat4 simd_result;
+    __m128 r0 = a.rows[0];
+    __m128 r1 = a.rows[1];
+    __m128 r2 = a.rows[2];
+    __m128 r3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    __m128 t = a.rows[3];
+    __m128 translation = _mm_mul_ps(c_mm_shuffle(t, 0, 0, 0, 0), r0);
+    translation = c_mm_madd_ps(c_mm_shuffle(t, 1, 1, 1, 1), r1, translation);
+    translation = c_mm_madd_ps(c_mm_shuffle(t, 2, 2, 2, 2), r2, translation);
+    simd_result.rows[0] = r0;
+    simd_result.rows[1] = r1;
+    simd_result.rows[2] = r2;
+    simd_result.rows[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), translation);
+    return simd_result;
+#else
+    const f32* m = a.data;
+    mat4 result;
+    f32* o = result.data;
+
+    o[0] = m[0];
+    o[1] = m[4];
+    o[2] = m[8];
+    o[3] = 0.0f;
+    o[4] = m[1];
+    o[5] = m[5];
+    o[6] = m[9];
+    o[7] = 0.0f;
+    o[8] = m[2];
+    o[9] = m[6];
+    o[10] = m[10];
+    o[11] = 0.0f;
+    o[12] = -(m[12] * o[0] + m[13] * o[4] + m[14] * o[8]);
+    o[13] = -(m[12] * o[1] + m[13] * o[5] + m[14] * o[9]);
+    o[14] = -(m[12] * o[2] + m[13] * o[6] + m[14] * o[10]);
+    o[15] = 1.0f;
+    return result;
+#endif
+}
+
+/**
+ * Inverse of an affine transform (any 3x3 linear part, scale and shear included, then a
+ * translation). The 3x3 part is inverted with cross products instead of the full 4x4 cofactors
+ * @param a the matrix, its last column must be (0, 0, 0, 1)
+ * @return the inverse of a
+ */
+cINLINE mat4 mat4_inverse_affine(mat4 a) {
+#if defined(cUSE_SIMD)
+    // the columns of the inverse 3x3 are the cross products of the rows, over the determinant
+    __m128 c0 = c_mm_cross3_ps(a.rows[1], a.rows[2]);
+    __m128 c1 = c_mm_cross3_ps(a.rows[2], a.rows[0]);
+    __m128 c2 = c_mm_cross3_ps(a.rows[0], a.rows[1]);
+    __m128 c3 = _mm_setzero_ps();
+    __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), c_mm_hsum_ps(_mm_mul_ps(a.rows[0], c0)));
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    mat4 simd_result;
+    simd_result.rows[0] = _mm_mul_ps(c0, inv_det);
+    simd_result.rows[1] = _mm_mul_ps(c1, inv_det);
+    simd_result.rows[2] = _mm_mul_ps(c2, inv_det);
+    __m128 t = a.rows[3];
+    __m128 translation = _mm_mul_ps(c_mm_shuffle(t, 0, 0, 0, 0), simd_result.rows[0]);
+    translation = c_mm_madd_ps(c_mm_shuffle(t, 1, 1, 1, 1), simd_result.rows[1], translation);
+    translation = c_mm_madd_ps(c_mm_shuffle(t, 2, 2, 2, 2), simd_result.rows[2], translation);
+    simd_result.rows[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), translation);
+    return simd_result;
+#else
+    const f32* m = a.data;
+    // cross products of the rows of the 3x3 part
+    f32 c0[3] = {m[5] * m[10] - m[6] * m[9], m[6] * m[8] - m[4] * m[10], m[4] * m[9] - m[5] * m[8]};
+    f32 c1[3] = {m[9] * m[2] - m[10] * m[1], m[10] * m[0] - m[8] * m[2], m[8] * m[1] - m[9] * m[0]};
+    f32 c2[3] = {m[1] * m[6] - m[2] * m[5], m[2] * m[4] - m[0] * m[6], m[0] * m[5] - m[1] * m[4]};
+    f32 inv_det = 1.0f / (m[0] * c0[0] + m[1] * c0[1] + m[2] * c0[2]);
+
+    mat4 result;
+    f32* o = result.data;
+    for (u32 k = 0; k < 3; ++k) {
+        o[k * 4 + 0] = c0[k] * inv_det;
+        o[k * 4 + 1] = c1[k] * inv_det;
+        o[k * 4 + 2] = c2[k] * inv_det;
+        o[k * 4 + 3] = 0.0f;
+    }
+    for (u32 j = 0; j < 3; ++j) {
+        o[12 + j] = -(m[12] * o[j] + m[13] * o[4 + j] + m[14] * o[8 + j]);
+    }
+    o[15] = 1.0f;
+    return result;
+#endif
+}
+
+cINLINE mat3x4 mat3x4_identity() {
+    mat3x4 result;
+    czero_memory(result.data, sizeof(result.data));
+    result.data[0] = 1.0f;
+    result.data[5] = 1.0f;
+    result.data[10] = 1.0f;
+    return result;
+}
+
+// The affine part of a mat4, whose last column is assumed to be (0, 0, 0, 1)
+cINLINE mat3x4 mat3x4_from_mat4(mat4 a) {
+    mat3x4 result;
+#if defined(cUSE_SIMD)
+    _MM_TRANSPOSE4_PS(a.rows[0], a.rows[1], a.rows[2], a.rows[3]);
+    result.rows[0] = a.rows[0];
+    result.rows[1] = a.rows[1];
+    result.rows[2] = a.rows[2];
+#else
+    for (u32 i = 0; i < 3; ++i) {
+        for (u32 j = 0; j < 4; ++j) {
+            result.data[i * 4 + j] = a.data[j * 4 + i];
+        }
+    }
+#endif
+    return result;
+}
+
+cINLINE mat4 mat4_from_mat3x4(mat3x4 a) {
+    mat4 result;
+#if defined(cUSE_SIMD)
+    result.rows[0] = a.rows[0];
+    result.rows[1] = a.rows[1];
+    result.rows[2] = a.rows[2];
+    result.rows[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    _MM_TRANSPOSE4_PS(result.rows[0], result.rows[1], result.rows[2], result.rows[3]);
+#else
+    for (u32 i = 0; i < 3; ++i) {
+        for (u32 j = 0; j < 4; ++j) {
+            result.data[j * 4 + i] = a.data[i * 4 + j];
+        }
+    }
+    result.data[3] = 0.0f;
+    result.data[7] = 0.0f;
+    result.data[11] = 0.0f;
+    result.data[15] = 1.0f;
+#endif
+    return result;
+}
+
+/**
+ * Combine two affine transforms, in the same order as mat4_multiply
+ * @return the transform applying a, then b
+ */
+cINLINE mat3x4 mat3x4_multiply(mat3x4 a, mat3x4 b) {
+    mat3x4 result;
+#if defined(cUSE_SIMD)
+    for (u32 i = 0; i < 3; ++i) {
+        __m128 row = _mm_mul_ps(_mm_set1_ps(b.data[i * 4 + 0]), a.rows[0]);
+        row = c_mm_madd_ps(_mm_set1_ps(b.data[i * 4 + 1]), a.rows[1], row);
+        row = c_mm_madd_ps(_mm_set1_ps(b.data[i * 4 + 2]), a.rows[2], row);
+        result.rows[i] = _mm_add_ps(row, _mm_setr_ps(0.0f, 0.0f, 0.0f, b.data[i * 4 + 3]));
+    }
+#else
+    for (u32 i = 0; i < 3; ++i) {
+        for (u32 j = 0; j < 4; ++j) {
+            result.data[i * 4 + j] = b.data[i * 4 + 0] * a.data[j] +
+                                     b.data[i * 4 + 1] * a.data[4 + j] +
+                                     b.data[i * 4 + 2] * a.data[8 + j];
+        }
+        result.data[i * 4 + 3] += b.data[i * 4 + 3];
+    }
+#endif
+    return result;
+}
+
+// Inverse of an affine transform, see mat4_inverse_affine
+cINLINE mat3x4 mat3x4_inverse(mat3x4 a) {
+    mat3x4 result;
+#if defined(cUSE_SIMD)
+    __m128 c0 = c_mm_cross3_ps(a.rows[1], a.rows[2]);
+    __m128 c1 = c_mm_cross3_ps(a.rows[2], a.rows[0]);
+    __m128 c2 = c_mm_cross3_ps(a.rows[0], a.rows[1]);
+    // the last lane of c0 is 0, the translation doesn't reach the determinant
+    __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), c_mm_hsum_ps(_mm_mul_ps(a.rows[0], c0)));
+    c0 = _mm_mul_ps(c0, inv_det);
+    c1 = _mm_mul_ps(c1, inv_det);
+    c2 = _mm_mul_ps(c2, inv_det);
+    // translation column (the last lane of the rows), moved back through the inverse 3x3
+    __m128 translation = _mm_mul_ps(c_mm_shuffle(a.rows[0], 3, 3, 3, 3), c0);
+    translation = c_mm_madd_ps(c_mm_shuffle(a.rows[1], 3, 3, 3, 3), c1, translation);
+    translation = c_mm_madd_ps(c_mm_shuffle(a.rows[2], 3, 3, 3, 3), c2, translation);
+    translation = _mm_sub_ps(_mm_setzero_ps(), translation);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, translation);
+    result.rows[0] = c0;
+    result.rows[1] = c1;
+    result.rows[2] = c2;
+#else
+    const f32* m = a.data;
+    f32 c0[3] = {m[5] * m[10] - m[6] * m[9], m[6] * m[8] - m[4] * m[10], m[4] * m[9] - m[5] * m[8]};
+    f32 c1[3] = {m[9] * m[2] - m[10] * m[1], m[10] * m[0] - m[8] * m[2], m[8] * m[1] - m[9] * m[0]};
+    f32 c2[3] = {m[1] * m[6] - m[2] * m[5], m[2] * m[4] - m[0] * m[6], m[0] * m[5] - m[1] * m[4]};
+    f32 inv_det = 1.0f / (m[0] * c0[0] + m[1] * c0[1] + m[2] * c0[2]);
+    for (u32 k = 0; k < 3; ++k) {
+        result.data[k * 4 + 0] = c0[k] * inv_det;
+        result.data[k * 4 + 1] = c1[k] * inv_det;
+        result.data[k * 4 + 2] = c2[k] * inv_det;
+        result.data[k * 4 + 3] = -(result.data[k * 4 + 0] * m[3] + result.data[k * 4 + 1] * m[7] + result.data[k * 4 + 2] * m[11]);
+    }
+#endif
+    return result;
+}
+
+cINLINE vec3 mat3x4_transform_point(mat3x4 m, vec3 p) {
+    vec3 result;
+    for (u32 i = 0; i < 3; ++i) {
+        result.elements[i] = m.data[i * 4 + 0] * p.x + m.data[i * 4 + 1] * p.y + m.data[i * 4 + 2] * p.z + m.data[i * 4 + 3];
+    }
     return result;
 }
 
@@ -615,16 +977,26 @@ cINLINE quat quat_identity() {
 }
 
 cINLINE f32 quat_normal(quat q) {
-    return c_sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return c_sqrtf(vec4_dot(q, q));
 }
 
 cINLINE quat quat_normalize(quat q) {
     f32 n = quat_normal(q);
+#if defined(cUSE_SIMD)
+    q.data = _mm_div_ps(q.data, _mm_set1_ps(n));
+    return q;
+#else
     return (quat){{q.x / n, q.y / n, q.z / n, q.w / n}};
+#endif
 }
 
 cINLINE quat quat_conjugate(quat q) {
+#if defined(cUSE_SIMD)
+    q.data = _mm_xor_ps(q.data, _mm_setr_ps(-0.0f, -0.0f, -0.0f, 0.0f));
+    return q;
+#else
     return (quat){{-q.x, -q.y, -q.z, q.w}};
+#endif
 }
 
 cINLINE quat quat_inverse(quat q) {
@@ -633,17 +1005,29 @@ cINLINE quat quat_inverse(quat q) {
 
 cINLINE quat quat_mul(quat a, quat b) {
     quat result;
-
+#if defined(cUSE_SIMD)
+    // a.w * b + a.x * (b.w, -b.z, b.y, -b.x) + a.y * (b.z, b.w, -b.x, -b.y) + a.z * (-b.y, b.x, b.w, -b.z)
+    __m128 r = _mm_mul_ps(_mm_set1_ps(a.w), b.data);
+    __m128 bx = _mm_mul_ps(c_mm_shuffle(b.data, 3, 2, 1, 0), _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f));
+    __m128 by = _mm_mul_ps(c_mm_shuffle(b.data, 2, 3, 0, 1), _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f));
+    __m128 bz = _mm_mul_ps(c_mm_shuffle(b.data, 1, 0, 3, 2), _mm_setr_ps(-1.0f, 1.0f, 1.0f, -1.0f));
+    r = c_mm_madd_ps(_mm_set1_ps(a.x), bx, r);
+    r = c_mm_madd_ps(_mm_set1_ps(a.y), by, r);
+    r = c_mm_madd_ps(_mm_set1_ps(a.z), bz, r);
+    result.data = r;
+    return result;
+#else
     result.x = a.x * b.w + a.y * b.z - a.z * b.y + a.w * b.x;
     result.y = -a.x * b.z + a.y * b.w + a.z * b.x + a.w * b.y;
     result.z = a.x * b.y - a.y * b.x + a.z * b.w + a.w * b.z;
     result.w = -a.x * b.x - a.y * b.y - a.z * b.z + a.w * b.w;
 
     return result;
+#endif
 }
 
 cINLINE f32 quat_dot(quat a, quat b) {
-    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    return vec4_dot(a, b);
 }
 
 cINLINE mat4 quat_to_mat4(quat q) {
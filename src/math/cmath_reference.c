@@ -0,0 +1,33 @@
+// always the scalar implementation, see cmath_reference.h
+#undef cUSE_SIMD
+
+#include "cmath_reference.h"
+#include "cmath.h"
+
+void mat4_multiply_reference(const mat4* a, const mat4* b, mat4* out_result) {
+    *out_result = mat4_multiply(*a, *b);
+}
+
+void mat4_inverse_reference(const mat4* a, mat4* out_result) {
+    *out_result = mat4_inverse(*a);
+}
+
+void mat4_transposed_reference(const mat4* a, mat4* out_result) {
+    *out_result = mat4_transposed(*a);
+}
+
+void quat_mul_reference(const quat* a, const quat* b, quat* out_result) {
+    *out_result = quat_mul(*a, *b);
+}
+
+void quat_normalize_reference(const quat* q, quat* out_result) {
+    *out_result = quat_normalize(*q);
+}
+
+f32 vec4_dot_reference(const vec4* a, const vec4* b) {
+    return vec4_dot(*a, *b);
+}
+
+void vec4_normalized_reference(const vec4* a, vec4* out_result) {
+    *out_result = vec4_normalized(*a);
+}
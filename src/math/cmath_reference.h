@@ -0,0 +1,22 @@
+#pragma once
+
+#include "math_types.h"
+
+/*
+ * Scalar versions of the math functions that have an SSE implementation, compiled
+ * without cUSE_SIMD whatever the build options. Used by the tests and the benchmarks
+ * to check and measure the SIMD code.
+ *
+ * They take pointers: the vec4 and mat4 unions don't have the same members with and
+ * without cUSE_SIMD, so they are not passed by value across the two builds.
+ */
+
+void mat4_multiply_reference(const mat4* a, const mat4* b, mat4* out_result);
+void mat4_inverse_reference(const mat4* a, mat4* out_result);
+void mat4_transposed_reference(const mat4* a, mat4* out_result);
+
+void quat_mul_reference(const quat* a, const quat* b, quat* out_result);
+void quat_normalize_reference(const quat* q, quat* out_result);
+
+f32 vec4_dot_reference(const vec4* a, const vec4* b);
+void vec4_normalized_reference(const vec4* a, vec4* out_result);
@@ -0,0 +1,181 @@
+#include "crandom.h"
+
+#include "cmath.h"
+#include "platform/platform.h"
+
+#include <stdatomic.h>
+
+// minimum count for the interleaved SIMD fill to pay for the jump of its second generator
+#define RANDOM_SIMD_FILL_MIN_COUNT 256
+
+// incremented by random_seed_threads, 0 until it is called
+static atomic_uint seed_generation = 0;
+static atomic_uint next_thread_index = 0;
+// where the next thread to be seeded starts, a long jump past the previous one
+static random_state next_thread_state;
+static atomic_flag next_thread_state_lock = ATOMIC_FLAG_INIT;
+
+static _Thread_local random_state thread_state;
+// seed_generation + 1 when the state was seeded, 0 if it never was
+static _Thread_local u32 thread_state_generation = 0;
+static _Thread_local u32 thread_index = INVALID_ID;
+
+static u64 splitmix64(u64* x) {
+    u64 z = (*x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+void random_seed(random_state* state, u64 seed) {
+    for (u32 i = 0; i < 4; ++i) {
+        state->s[i] = splitmix64(&seed);
+    }
+}
+
+static void random_apply_jump(random_state* state, const u64 jump[4]) {
+    u64 s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (u32 i = 0; i < 4; ++i) {
+        for (u32 b = 0; b < 64; ++b) {
+            if (jump[i] & (1ull << b)) {
+                s0 ^= state->s[0];
+                s1 ^= state->s[1];
+                s2 ^= state->s[2];
+                s3 ^= state->s[3];
+            }
+            random_next_u64(state);
+        }
+    }
+    state->s[0] = s0;
+    state->s[1] = s1;
+    state->s[2] = s2;
+    state->s[3] = s3;
+}
+
+void random_jump(random_state* state) {
+    static const u64 jump[] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+    random_apply_jump(state, jump);
+}
+
+void random_long_jump(random_state* state) {
+    static const u64 long_jump[] = {0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull, 0x39109bb02acbe635ull};
+    random_apply_jump(state, long_jump);
+}
+
+void random_fill_u32(random_state* state, u32* out_values, u64 count) {
+    u64 i = 0;
+    // both halves of a number are usable with the ** scrambler
+    for (; i + 2 <= count; i += 2) {
+        u64 value = random_next_u64(state);
+        out_values[i] = (u32)(value >> 32);
+        out_values[i + 1] = (u32)value;
+    }
+    if (i < count) {
+        out_values[i] = random_next_u32(state);
+    }
+}
+
+#if defined(cUSE_SIMD)
+cINLINE __m128i random_mm_rotl_epi64(__m128i x, i32 k) {
+    return _mm_or_si128(_mm_slli_epi64(x, k), _mm_srli_epi64(x, 64 - k));
+}
+
+/**
+ * Two generators in the 64 bit lanes of SSE registers, each step gives 4 floats (24 bits of each
+ * 32 bit half)
+ * @return the number of values written, a multiple of 4
+ */
+static u64 random_fill_f32_simd(random_state* state, f32* out_values, u64 count, f32 min, f32 max) {
+    random_state second = *state;
+    random_jump(&second);
+    __m128i s0 = _mm_set_epi64x((i64)second.s[0], (i64)state->s[0]);
+    __m128i s1 = _mm_set_epi64x((i64)second.s[1], (i64)state->s[1]);
+    __m128i s2 = _mm_set_epi64x((i64)second.s[2], (i64)state->s[2]);
+    __m128i s3 = _mm_set_epi64x((i64)second.s[3], (i64)state->s[3]);
+
+    __m128 scale = _mm_set1_ps((max - min) * (1.0f / 16777216.0f));
+    __m128 offset = _mm_set1_ps(min);
+    u64 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // result = rotl(s1 * 5, 7) * 9, the multiplications as shifts and adds
+        __m128i result = _mm_add_epi64(_mm_slli_epi64(s1, 2), s1);
+        result = random_mm_rotl_epi64(result, 7);
+        result = _mm_add_epi64(_mm_slli_epi64(result, 3), result);
+
+        __m128i t = _mm_slli_epi64(s1, 17);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = random_mm_rotl_epi64(s3, 45);
+
+        __m128 values = _mm_cvtepi32_ps(_mm_srli_epi32(result, 8));
+        _mm_storeu_ps(out_values + i, c_mm_madd_ps(values, scale, offset));
+    }
+
+    // the first generator continues the sequence. The second one is dropped: jumping the final
+    // state lands on its final state, so the next fill continues it as well
+    alignas(16) u64 lanes[2];
+    _mm_store_si128((__m128i*)lanes, s0);
+    state->s[0] = lanes[0];
+    _mm_store_si128((__m128i*)lanes, s1);
+    state->s[1] = lanes[0];
+    _mm_store_si128((__m128i*)lanes, s2);
+    state->s[2] = lanes[0];
+    _mm_store_si128((__m128i*)lanes, s3);
+    state->s[3] = lanes[0];
+    return i;
+}
+#endif
+
+void random_fill_f32(random_state* state, f32* out_values, u64 count, f32 min, f32 max) {
+    u64 i = 0;
+#if defined(cUSE_SIMD)
+    if (count >= RANDOM_SIMD_FILL_MIN_COUNT) {
+        i = random_fill_f32_simd(state, out_values, count, min, max);
+    }
+#endif
+    for (; i < count; ++i) {
+        out_values[i] = random_range_f32(state, min, max);
+    }
+}
+
+cINLINE void next_thread_state_lock_acquire() {
+    while (atomic_flag_test_and_set_explicit(&next_thread_state_lock, memory_order_acquire)) {
+        platform_thread_yield();
+    }
+}
+
+cINLINE void next_thread_state_lock_release() {
+    atomic_flag_clear_explicit(&next_thread_state_lock, memory_order_release);
+}
+
+void random_seed_threads(u64 seed) {
+    next_thread_state_lock_acquire();
+    random_seed(&next_thread_state, seed);
+    atomic_fetch_add(&seed_generation, 1);
+    next_thread_state_lock_release();
+}
+
+random_state* random_thread_state() {
+    u32 generation = atomic_load_explicit(&seed_generation, memory_order_acquire);
+    if (thread_state_generation != generation + 1) {
+        if (thread_index == INVALID_ID) {
+            thread_index = atomic_fetch_add(&next_thread_index, 1);
+        }
+        if (generation == 0) {
+            // never seeded, the sequence differs from run to run
+            random_seed(&thread_state, (u64)(platform_get_absolute_time() * 1e9) + thread_index);
+        } else {
+            // one long jump per thread: the sequences of the threads never overlap, and neither
+            // do the second generators of their fills, a single jump ahead
+            next_thread_state_lock_acquire();
+            thread_state = next_thread_state;
+            random_long_jump(&next_thread_state);
+            next_thread_state_lock_release();
+        }
+        thread_state_generation = generation + 1;
+    }
+    return &thread_state;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "define.h"
+
+/*
+ * xoshiro256** pseudo random generator (Blackman & Vigna) with explicit state.
+ *
+ * A random_state is owned by its user and never shared between threads without
+ * synchronization. Each thread also has its own state, random_thread_state(), which is what
+ * crandom() and fcrandom() use. Seeding is deterministic: the same seed gives the same
+ * sequence on every platform.
+ */
+
+typedef struct random_state {
+    u64 s[4];
+} random_state;
+
+/**
+ * Seed a generator. The seed is expanded with splitmix64, so close seeds give unrelated sequences
+ * @param state the generator
+ * @param seed any value, 0 included
+ */
+void random_seed(random_state* state, u64 seed);
+
+/**
+ * Advance the generator by 2^128 numbers. Generators seeded the same way then jumped 0, 1, 2...
+ * times produce sequences that never overlap
+ */
+void random_jump(random_state* state);
+
+/**
+ * Advance the generator by 2^192 numbers, room for 2^64 jumps in between. Used to space the
+ * generators of the threads, which random_fill_f32 jumps
+ */
+void random_long_jump(random_state* state);
+
+cINLINE u64 random_rotl(u64 x, u32 k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+cINLINE u64 random_next_u64(random_state* state) {
+    u64* s = state->s;
+    u64 result = random_rotl(s[1] * 5, 7) * 9;
+    u64 t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = random_rotl(s[3], 45);
+    return result;
+}
+
+cINLINE u32 random_next_u32(random_state* state) {
+    // the high bits are the best ones
+    return (u32)(random_next_u64(state) >> 32);
+}
+
+// Uniform in [0, 1)
+cINLINE f32 random_next_f32(random_state* state) {
+    return (f32)(random_next_u64(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+// Uniform in [0, 1)
+cINLINE f64 random_next_f64(random_state* state) {
+    return (f64)(random_next_u64(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Uniform integer in [0, bound), without the bias of a modulo (Lemire's method)
+ * @param state the generator
+ * @param bound the exclusive upper bound, 0 returns 0
+ */
+cINLINE u32 random_next_bounded(random_state* state, u32 bound) {
+    u64 m = (u64)random_next_u32(state) * bound;
+    u32 low = (u32)m;
+    if (low < bound) {
+        u32 threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            m = (u64)random_next_u32(state) * bound;
+            low = (u32)m;
+        }
+    }
+    return (u32)(m >> 32);
+}
+
+// Uniform integer in [min, max], both included
+cINLINE i32 random_range_i32(random_state* state, i32 min, i32 max) {
+    u32 span = (u32)((i64)max - (i64)min + 1);
+    if (span == 0) {
+        // the whole i32 range
+        return (i32)random_next_u32(state);
+    }
+    return (i32)((i64)min + random_next_bounded(state, span));
+}
+
+// Uniform in [min, max)
+cINLINE f32 random_range_f32(random_state* state, f32 min, f32 max) {
+    return min + random_next_f32(state) * (max - min);
+}
+
+void random_fill_u32(random_state* state, u32* out_values, u64 count);
+
+/**
+ * Fill an array with uniform floats in [min, max). With cUSE_SIMD, large arrays are generated
+ * by two interleaved generators, the second being the state jumped once: the sequence is not
+ * the one of random_range_f32, but it is the same for the same state and count
+ * @param state the generator, advanced past the generated numbers
+ * @param out_values receives count values
+ * @param count number of values
+ * @param min inclusive lower bound
+ * @param max exclusive upper bound
+ */
+void random_fill_f32(random_state* state, f32* out_values, u64 count, f32 min, f32 max);
+
+/**
+ * Seed the generators of every thread. Each thread is reseeded on its next call, from the
+ * seed long jumped once per thread reseeded before it (the first one gets the seed itself),
+ * so the sequences only depend on the order in which the threads next draw a number
+ */
+void random_seed_threads(u64 seed);
+
+// The generator of the calling thread, seeded on first use
+random_state* random_thread_state();
@@ -0,0 +1,39 @@
+#include "fast_trig.h"
+
+void c_sincosf_array(const f32* angles, u32 count, b8 precise, f32* out_sin, f32* out_cos) {
+    u32 i = 0;
+#if defined(cUSE_SIMD)
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8) {
+        __m256 s, c;
+        c_mm256_sincos_ps_tier(_mm256_loadu_ps(angles + i), precise, &s, &c);
+        if (out_sin) {
+            _mm256_storeu_ps(out_sin + i, s);
+        }
+        if (out_cos) {
+            _mm256_storeu_ps(out_cos + i, c);
+        }
+    }
+#endif
+    for (; i + 4 <= count; i += 4) {
+        __m128 s, c;
+        c_mm_sincos_ps_tier(_mm_loadu_ps(angles + i), precise, &s, &c);
+        if (out_sin) {
+            _mm_storeu_ps(out_sin + i, s);
+        }
+        if (out_cos) {
+            _mm_storeu_ps(out_cos + i, c);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        f32 s, c;
+        c_sincosf_tier(angles[i], precise, &s, &c);
+        if (out_sin) {
+            out_sin[i] = s;
+        }
+        if (out_cos) {
+            out_cos[i] = c;
+        }
+    }
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "define.h"
+#include "cmath.h"
+
+/*
+ * Polynomial approximations of the trigonometric functions, inlined and without branches
+ * so loops over them vectorize. c_sinf & co. in cmath.h stay the libm versions.
+ *
+ * Two accuracy tiers, maximum absolute error measured against the double precision libm
+ * functions (the float libm functions are within 3.3e-8):
+ *  - precise: 1e-7 for sin/cos over |x| <= 8192. Three part range reduction, degree 7 (sin)
+ *    and 8 (cos) polynomials
+ *  - fast: 1.1e-6 for sin/cos over [-pi, pi], growing to 4e-5 at |x| = 512 because of the
+ *    single constant range reduction. Degree 5 and 6 polynomials. Enough for animation and
+ *    anything drawn on screen when the angles are kept small
+ *
+ * Past these ranges the range reduction loses precision quickly, use libm.
+ * The tangent is sin / cos, its relative error is about twice the tier error.
+ * acos over [-1, 1]: 3e-7 (precise) and 6.8e-5 (fast).
+ *
+ * With cUSE_SIMD, c_mm_* versions compute 4 values at once (SSE2) and c_mm256_* 8 values
+ * (when compiled with AVX2). They round to the nearest quadrant the same way as the scalar
+ * versions and agree with them within a few ulp.
+ */
+
+// pi / 2 split in parts exactly representable in a float (Cody & Waite)
+#define FAST_TRIG_PIO2_1 1.5703125f
+#define FAST_TRIG_PIO2_2 4.837512969970703125e-4f
+#define FAST_TRIG_PIO2_3 7.54978995489188216e-8f
+#define FAST_TRIG_TWO_OVER_PI 0.636619772367581343f
+
+// sin(r) and cos(r) coefficients on [-pi/4, pi/4]
+#define FAST_TRIG_SIN_P0 -1.6666654611e-1f
+#define FAST_TRIG_SIN_P1 8.3321608736e-3f
+#define FAST_TRIG_SIN_P2 -1.9515295891e-4f
+#define FAST_TRIG_COS_P0 4.166664568298827e-2f
+#define FAST_TRIG_COS_P1 -1.388731625493765e-3f
+#define FAST_TRIG_COS_P2 2.443315711809948e-5f
+// lower degree fits for the fast tier
+#define FAST_TRIG_SIN_FAST_P0 -1.6662834e-1f
+#define FAST_TRIG_SIN_FAST_P1 8.1529923e-3f
+#define FAST_TRIG_COS_FAST_P0 4.1661279e-2f
+#define FAST_TRIG_COS_FAST_P1 -1.3652450e-3f
+
+// asin(x) coefficients on [-0.5, 0.5]
+#define FAST_TRIG_ASIN_P0 1.6666752422e-1f
+#define FAST_TRIG_ASIN_P1 7.4953002686e-2f
+#define FAST_TRIG_ASIN_P2 4.5470025998e-2f
+#define FAST_TRIG_ASIN_P3 2.4181311049e-2f
+#define FAST_TRIG_ASIN_P4 4.2163199048e-2f
+
+/**
+ * Sine and cosine of x in one call. The shared range reduction makes it about the cost of one of them
+ * @param x the angle in radians
+ * @param precise selects the tier, meant to be a constant
+ * @param out_sin receives sin(x)
+ * @param out_cos receives cos(x)
+ */
+cINLINE void c_sincosf_tier(f32 x, b8 precise, f32* out_sin, f32* out_cos) {
+    // x = r + q * pi / 2 with r in [-pi/4, pi/4]
+    f32 qf = (f32)(i32)(x * FAST_TRIG_TWO_OVER_PI + (x >= 0.0f ? 0.5f : -0.5f));
+    i32 q = (i32)qf;
+    f32 r;
+    if (precise) {
+        r = ((x - qf * FAST_TRIG_PIO2_1) - qf * FAST_TRIG_PIO2_2) - qf * FAST_TRIG_PIO2_3;
+    } else {
+        r = x - qf * (FAST_TRIG_PIO2_1 + FAST_TRIG_PIO2_2);
+    }
+    f32 r2 = r * r;
+
+    f32 s, c;
+    if (precise) {
+        s = r + r * r2 * (FAST_TRIG_SIN_P0 + r2 * (FAST_TRIG_SIN_P1 + r2 * FAST_TRIG_SIN_P2));
+        c = 1.0f - 0.5f * r2 + r2 * r2 * (FAST_TRIG_COS_P0 + r2 * (FAST_TRIG_COS_P1 + r2 * FAST_TRIG_COS_P2));
+    } else {
+        s = r + r * r2 * (FAST_TRIG_SIN_FAST_P0 + r2 * FAST_TRIG_SIN_FAST_P1);
+        c = 1.0f - 0.5f * r2 + r2 * r2 * (FAST_TRIG_COS_FAST_P0 + r2 * FAST_TRIG_COS_FAST_P1);
+    }
+
+    // odd quadrants swap sin and cos, the sign follows the quadrant
+    f32 sin_result = (q & 1) ? c : s;
+    f32 cos_result = (q & 1) ? s : c;
+    *out_sin = (q & 2) ? -sin_result : sin_result;
+    *out_cos = ((q + 1) & 2) ? -cos_result : cos_result;
+}
+
+cINLINE void c_sincosf_precise(f32 x, f32* out_sin, f32* out_cos) {
+    c_sincosf_tier(x, true, out_sin, out_cos);
+}
+
+cINLINE void c_sincosf_fast(f32 x, f32* out_sin, f32* out_cos) {
+    c_sincosf_tier(x, false, out_sin, out_cos);
+}
+
+cINLINE f32 c_sinf_precise(f32 x) {
+    f32 s, c;
+    c_sincosf_tier(x, true, &s, &c);
+    return s;
+}
+
+cINLINE f32 c_cosf_precise(f32 x) {
+    f32 s, c;
+    c_sincosf_tier(x, true, &s, &c);
+    return c;
+}
+
+cINLINE f32 c_tanf_precise(f32 x) {
+    f32 s, c;
+    c_sincosf_tier(x, true, &s, &c);
+    return s / c;
+}
+
+cINLINE f32 c_sinf_fast(f32 x) {
+    f32 s, c;
+    c_sincosf_tier(x, false, &s, &c);
+    return s;
+}
+
+cINLINE f32 c_cosf_fast(f32 x) {
+    f32 s, c;
+    c_sincosf_tier(x, false, &s, &c);
+    return c;
+}
+
+cINLINE f32 c_tanf_fast(f32 x) {
+    f32 s, c;
+    c_sincosf_tier(x, false, &s, &c);
+    return s / c;
+}
+
+// acos of x in [-1, 1]
+cINLINE f32 c_acosf_precise(f32 x) {
+    f32 a = x < 0.0f ? -x : x;
+    // acos(|x|) = 2 * asin(sqrt((1 - |x|) / 2)) above 0.5, pi/2 - asin(|x|) below
+    b8 large = a > 0.5f;
+    f32 z = large ? 0.5f * (1.0f - a) : a * a;
+    f32 s = large ? c_sqrtf(z) : a;
+    f32 asin_s = s + s * z * (FAST_TRIG_ASIN_P0 + z * (FAST_TRIG_ASIN_P1 + z * (FAST_TRIG_ASIN_P2 + z * (FAST_TRIG_ASIN_P3 + z * FAST_TRIG_ASIN_P4))));
+    f32 result = large ? 2.0f * asin_s : HALF_PI - asin_s;
+    return x < 0.0f ? PI - result : result;
+}
+
+// acos of x in [-1, 1] (Abramowitz & Stegun 4.4.45)
+cINLINE f32 c_acosf_fast(f32 x) {
+    f32 a = x < 0.0f ? -x : x;
+    f32 result = c_sqrtf(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f + a * -0.0187293f)));
+    return x < 0.0f ? PI - result : result;
+}
+
+#if defined(cUSE_SIMD)
+// 4 wide version of c_sincosf_tier
+cINLINE void c_mm_sincos_ps_tier(__m128 x, b8 precise, __m128* out_sin, __m128* out_cos) {
+    // cvtps rounds to the nearest integer
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(FAST_TRIG_TWO_OVER_PI)));
+    __m128 qf = _mm_cvtepi32_ps(q);
+    __m128 r;
+    if (precise) {
+        r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(FAST_TRIG_PIO2_1)));
+        r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(FAST_TRIG_PIO2_2)));
+        r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(FAST_TRIG_PIO2_3)));
+    } else {
+        r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(FAST_TRIG_PIO2_1 + FAST_TRIG_PIO2_2)));
+    }
+    __m128 r2 = _mm_mul_ps(r, r);
+    __m128 r4 = _mm_mul_ps(r2, r2);
+
+    __m128 s, c;
+    if (precise) {
+        s = c_mm_madd_ps(r2, _mm_set1_ps(FAST_TRIG_SIN_P2), _mm_set1_ps(FAST_TRIG_SIN_P1));
+        s = c_mm_madd_ps(r2, s, _mm_set1_ps(FAST_TRIG_SIN_P0));
+        c = c_mm_madd_ps(r2, _mm_set1_ps(FAST_TRIG_COS_P2), _mm_set1_ps(FAST_TRIG_COS_P1));
+        c = c_mm_madd_ps(r2, c, _mm_set1_ps(FAST_TRIG_COS_P0));
+    } else {
+        s = c_mm_madd_ps(r2, _mm_set1_ps(FAST_TRIG_SIN_FAST_P1), _mm_set1_ps(FAST_TRIG_SIN_FAST_P0));
+        c = c_mm_madd_ps(r2, _mm_set1_ps(FAST_TRIG_COS_FAST_P1), _mm_set1_ps(FAST_TRIG_COS_FAST_P0));
+    }
+    s = c_mm_madd_ps(_mm_mul_ps(r, r2), s, r);
+    c = c_mm_madd_ps(r4, c, _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)));
+
+    __m128i one = _mm_set1_epi32(1);
+    __m128i two = _mm_set1_epi32(2);
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 sin_result = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+    __m128 cos_result = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+    // bit 1 of q (and of q + 1) moved to the sign bit
+    __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+    *out_sin = _mm_xor_ps(sin_result, sin_sign);
+    *out_cos = _mm_xor_ps(cos_result, cos_sign);
+}
+
+cINLINE void c_mm_sincos_ps(__m128 x, __m128* out_sin, __m128* out_cos) {
+    c_mm_sincos_ps_tier(x, true, out_sin, out_cos);
+}
+
+cINLINE void c_mm_sincos_fast_ps(__m128 x, __m128* out_sin, __m128* out_cos) {
+    c_mm_sincos_ps_tier(x, false, out_sin, out_cos);
+}
+
+#if defined(__AVX2__)
+// 8 wide version of c_sincosf_tier
+cINLINE void c_mm256_sincos_ps_tier(__m256 x, b8 precise, __m256* out_sin, __m256* out_cos) {
+    __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(FAST_TRIG_TWO_OVER_PI)));
+    __m256 qf = _mm256_cvtepi32_ps(q);
+    __m256 r;
+    if (precise) {
+        r = _mm256_sub_ps(x, _mm256_mul_ps(qf, _mm256_set1_ps(FAST_TRIG_PIO2_1)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(qf, _mm256_set1_ps(FAST_TRIG_PIO2_2)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(qf, _mm256_set1_ps(FAST_TRIG_PIO2_3)));
+    } else {
+        r = _mm256_sub_ps(x, _mm256_mul_ps(qf, _mm256_set1_ps(FAST_TRIG_PIO2_1 + FAST_TRIG_PIO2_2)));
+    }
+    __m256 r2 = _mm256_mul_ps(r, r);
+    __m256 r4 = _mm256_mul_ps(r2, r2);
+
+    __m256 s, c;
+    if (precise) {
+        s = _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(FAST_TRIG_SIN_P2)), _mm256_set1_ps(FAST_TRIG_SIN_P1));
+        s = _mm256_add_ps(_mm256_mul_ps(r2, s), _mm256_set1_ps(FAST_TRIG_SIN_P0));
+        c = _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(FAST_TRIG_COS_P2)), _mm256_set1_ps(FAST_TRIG_COS_P1));
+        c = _mm256_add_ps(_mm256_mul_ps(r2, c), _mm256_set1_ps(FAST_TRIG_COS_P0));
+    } else {
+        s = _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(FAST_TRIG_SIN_FAST_P1)), _mm256_set1_ps(FAST_TRIG_SIN_FAST_P0));
+        c = _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(FAST_TRIG_COS_FAST_P1)), _mm256_set1_ps(FAST_TRIG_COS_FAST_P0));
+    }
+    s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(r, r2), s), r);
+    c = _mm256_add_ps(_mm256_mul_ps(r4, c), _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)));
+
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i two = _mm256_set1_epi32(2);
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    __m256 sin_result = _mm256_blendv_ps(s, c, swap);
+    __m256 cos_result = _mm256_blendv_ps(c, s, swap);
+    __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+    __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+    *out_sin = _mm256_xor_ps(sin_result, sin_sign);
+    *out_cos = _mm256_xor_ps(cos_result, cos_sign);
+}
+
+cINLINE void c_mm256_sincos_ps(__m256 x, __m256* out_sin, __m256* out_cos) {
+    c_mm256_sincos_ps_tier(x, true, out_sin, out_cos);
+}
+
+cINLINE void c_mm256_sincos_fast_ps(__m256 x, __m256* out_sin, __m256* out_cos) {
+    c_mm256_sincos_ps_tier(x, false, out_sin, out_cos);
+}
+#endif
+#endif
+
+/**
+ * Sine and cosine of an array of angles, with the widest instructions the build allows
+ * @param angles the angles in radians
+ * @param count number of angles
+ * @param precise selects the accuracy tier
+ * @param out_sin receives count sines, may be 0
+ * @param out_cos receives count cosines, may be 0
+ */
+void c_sincosf_array(const f32* angles, u32 count, b8 precise, f32* out_sin, f32* out_cos);
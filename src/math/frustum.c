@@ -0,0 +1,184 @@
+#include "frustum.h"
+
+#include "cmath.h"
+
+static plane_3d plane_normalized(f32 x, f32 y, f32 z, f32 w) {
+    f32 length = c_sqrtf(x * x + y * y + z * z);
+    f32 inverse = length > 0.0f ? 1.0f / length : 0.0f;
+    return (plane_3d){{{x * inverse, y * inverse, z * inverse}}, w * inverse};
+}
+
+frustum frustum_from_matrix(mat4 view_projection) {
+    // clip = p * m with row vectors, so clip.x is the dot of p with the column 0 of m.
+    // A point is inside when -w <= x, y, z <= w
+    const f32* m = view_projection.data;
+    frustum f;
+    f.sides[FRUSTUM_SIDE_LEFT] = plane_normalized(m[3] + m[0], m[7] + m[4], m[11] + m[8], m[15] + m[12]);
+    f.sides[FRUSTUM_SIDE_RIGHT] = plane_normalized(m[3] - m[0], m[7] - m[4], m[11] - m[8], m[15] - m[12]);
+    f.sides[FRUSTUM_SIDE_BOTTOM] = plane_normalized(m[3] + m[1], m[7] + m[5], m[11] + m[9], m[15] + m[13]);
+    f.sides[FRUSTUM_SIDE_TOP] = plane_normalized(m[3] - m[1], m[7] - m[5], m[11] - m[9], m[15] - m[13]);
+    f.sides[FRUSTUM_SIDE_NEAR] = plane_normalized(m[3] + m[2], m[7] + m[6], m[11] + m[10], m[15] + m[14]);
+    f.sides[FRUSTUM_SIDE_FAR] = plane_normalized(m[3] - m[2], m[7] - m[6], m[11] - m[10], m[15] - m[14]);
+    return f;
+}
+
+b8 frustum_intersects_sphere(const frustum* f, vec3 center, f32 radius) {
+    for (u32 i = 0; i < FRUSTUM_SIDE_COUNT; ++i) {
+        const plane_3d* p = &f->sides[i];
+        if (vec3_dot(p->normal, center) + p->distance < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+b8 frustum_intersects_aabb(const frustum* f, extents_3d box) {
+    vec3 center = vec3_scale(vec3_add(box.min, box.max), 0.5f);
+    vec3 half_extent = vec3_scale(vec3_subtract(box.max, box.min), 0.5f);
+    for (u32 i = 0; i < FRUSTUM_SIDE_COUNT; ++i) {
+        const plane_3d* p = &f->sides[i];
+        // how far the box reaches along the normal
+        f32 reach = c_absf(p->normal.x) * half_extent.x + c_absf(p->normal.y) * half_extent.y +
+                    c_absf(p->normal.z) * half_extent.z;
+        if (vec3_dot(p->normal, center) + p->distance < -reach) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Append the indices of the lanes whose bit is set in mask, without branching
+cINLINE u32 append_visible(u32* out_visible, u32 visible_count, u32 first, u32 mask, u32 lanes) {
+    for (u32 k = 0; k < lanes; ++k) {
+        out_visible[visible_count] = first + k;
+        visible_count += (mask >> k) & 1;
+    }
+    return visible_count;
+}
+
+u32 frustum_cull_spheres_batch(const frustum* f, const frustum_cull_spheres* spheres, u32 count, u32* out_visible) {
+    u32 visible_count = 0;
+    u32 i = 0;
+#if defined(cUSE_SIMD) && defined(__AVX__)
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(spheres->center_x + i);
+        __m256 y = _mm256_loadu_ps(spheres->center_y + i);
+        __m256 z = _mm256_loadu_ps(spheres->center_z + i);
+        __m256 negative_radius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(spheres->radius + i));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (u32 s = 0; s < FRUSTUM_SIDE_COUNT; ++s) {
+            const plane_3d* p = &f->sides[s];
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p->normal.x), x), _mm256_set1_ps(p->distance));
+            distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p->normal.y), y), distance);
+            distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p->normal.z), z), distance);
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negative_radius, _CMP_GE_OQ));
+        }
+        visible_count = append_visible(out_visible, visible_count, i, (u32)_mm256_movemask_ps(inside), 8);
+    }
+#endif
+#if defined(cUSE_SIMD)
+    __m128 normal_x[FRUSTUM_SIDE_COUNT];
+    __m128 normal_y[FRUSTUM_SIDE_COUNT];
+    __m128 normal_z[FRUSTUM_SIDE_COUNT];
+    __m128 distance[FRUSTUM_SIDE_COUNT];
+    for (u32 s = 0; s < FRUSTUM_SIDE_COUNT; ++s) {
+        normal_x[s] = _mm_set1_ps(f->sides[s].normal.x);
+        normal_y[s] = _mm_set1_ps(f->sides[s].normal.y);
+        normal_z[s] = _mm_set1_ps(f->sides[s].normal.z);
+        distance[s] = _mm_set1_ps(f->sides[s].distance);
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(spheres->center_x + i);
+        __m128 y = _mm_loadu_ps(spheres->center_y + i);
+        __m128 z = _mm_loadu_ps(spheres->center_z + i);
+        __m128 negative_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres->radius + i));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (u32 s = 0; s < FRUSTUM_SIDE_COUNT; ++s) {
+            __m128 d = c_mm_madd_ps(normal_x[s], x, distance[s]);
+            d = c_mm_madd_ps(normal_y[s], y, d);
+            d = c_mm_madd_ps(normal_z[s], z, d);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negative_radius));
+        }
+        visible_count = append_visible(out_visible, visible_count, i, (u32)_mm_movemask_ps(inside), 4);
+    }
+#endif
+    for (; i < count; ++i) {
+        vec3 center = {{spheres->center_x[i], spheres->center_y[i], spheres->center_z[i]}};
+        out_visible[visible_count] = i;
+        visible_count += frustum_intersects_sphere(f, center, spheres->radius[i]) ? 1 : 0;
+    }
+    return visible_count;
+}
+
+u32 frustum_cull_boxes_batch(const frustum* f, const frustum_cull_boxes* boxes, u32 count, u32* out_visible) {
+    u32 visible_count = 0;
+    u32 i = 0;
+#if defined(cUSE_SIMD) && defined(__AVX__)
+    const __m256 sign_mask8 = _mm256_set1_ps(-0.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(boxes->center_x + i);
+        __m256 y = _mm256_loadu_ps(boxes->center_y + i);
+        __m256 z = _mm256_loadu_ps(boxes->center_z + i);
+        __m256 ex = _mm256_loadu_ps(boxes->half_extent_x + i);
+        __m256 ey = _mm256_loadu_ps(boxes->half_extent_y + i);
+        __m256 ez = _mm256_loadu_ps(boxes->half_extent_z + i);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (u32 s = 0; s < FRUSTUM_SIDE_COUNT; ++s) {
+            const plane_3d* p = &f->sides[s];
+            __m256 nx = _mm256_set1_ps(p->normal.x);
+            __m256 ny = _mm256_set1_ps(p->normal.y);
+            __m256 nz = _mm256_set1_ps(p->normal.z);
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(nx, x), _mm256_set1_ps(p->distance));
+            distance = _mm256_add_ps(_mm256_mul_ps(ny, y), distance);
+            distance = _mm256_add_ps(_mm256_mul_ps(nz, z), distance);
+            __m256 reach = _mm256_mul_ps(_mm256_andnot_ps(sign_mask8, nx), ex);
+            reach = _mm256_add_ps(_mm256_mul_ps(_mm256_andnot_ps(sign_mask8, ny), ey), reach);
+            reach = _mm256_add_ps(_mm256_mul_ps(_mm256_andnot_ps(sign_mask8, nz), ez), reach);
+            // distance >= -reach
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        visible_count = append_visible(out_visible, visible_count, i, (u32)_mm256_movemask_ps(inside), 8);
+    }
+#endif
+#if defined(cUSE_SIMD)
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    __m128 normal_x[FRUSTUM_SIDE_COUNT];
+    __m128 normal_y[FRUSTUM_SIDE_COUNT];
+    __m128 normal_z[FRUSTUM_SIDE_COUNT];
+    __m128 distance[FRUSTUM_SIDE_COUNT];
+    for (u32 s = 0; s < FRUSTUM_SIDE_COUNT; ++s) {
+        normal_x[s] = _mm_set1_ps(f->sides[s].normal.x);
+        normal_y[s] = _mm_set1_ps(f->sides[s].normal.y);
+        normal_z[s] = _mm_set1_ps(f->sides[s].normal.z);
+        distance[s] = _mm_set1_ps(f->sides[s].distance);
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(boxes->center_x + i);
+        __m128 y = _mm_loadu_ps(boxes->center_y + i);
+        __m128 z = _mm_loadu_ps(boxes->center_z + i);
+        __m128 ex = _mm_loadu_ps(boxes->half_extent_x + i);
+        __m128 ey = _mm_loadu_ps(boxes->half_extent_y + i);
+        __m128 ez = _mm_loadu_ps(boxes->half_extent_z + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (u32 s = 0; s < FRUSTUM_SIDE_COUNT; ++s) {
+            __m128 d = c_mm_madd_ps(normal_x[s], x, distance[s]);
+            d = c_mm_madd_ps(normal_y[s], y, d);
+            d = c_mm_madd_ps(normal_z[s], z, d);
+            d = c_mm_madd_ps(_mm_andnot_ps(sign_mask, normal_x[s]), ex, d);
+            d = c_mm_madd_ps(_mm_andnot_ps(sign_mask, normal_y[s]), ey, d);
+            d = c_mm_madd_ps(_mm_andnot_ps(sign_mask, normal_z[s]), ez, d);
+            // distance + reach >= 0
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, _mm_setzero_ps()));
+        }
+        visible_count = append_visible(out_visible, visible_count, i, (u32)_mm_movemask_ps(inside), 4);
+    }
+#endif
+    for (; i < count; ++i) {
+        vec3 center = {{boxes->center_x[i], boxes->center_y[i], boxes->center_z[i]}};
+        vec3 half_extent = {{boxes->half_extent_x[i], boxes->half_extent_y[i], boxes->half_extent_z[i]}};
+        extents_3d box = {vec3_subtract(center, half_extent), vec3_add(center, half_extent)};
+        out_visible[visible_count] = i;
+        visible_count += frustum_intersects_aabb(f, box) ? 1 : 0;
+    }
+    return visible_count;
+}
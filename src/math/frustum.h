@@ -0,0 +1,62 @@
+#pragma once
+
+#include "define.h"
+#include "math_types.h"
+
+/*
+ * View frustum extraction and visibility tests.
+ *
+ * The batched tests take their bounding volumes as one array per component and test 4
+ * objects per iteration against the 6 planes with cUSE_SIMD (8 when compiled with AVX).
+ * They write the indices of the visible objects, in order, and return how many there are.
+ * A volume touching a plane counts as visible.
+ */
+
+/**
+ * Extract the planes of the volume seen through a view and a projection (Gribb & Hartmann)
+ * @param view_projection mat4_multiply(view, projection), the same product the shader applies
+ * @return the frustum, its planes normalized and facing inwards
+ */
+frustum frustum_from_matrix(mat4 view_projection);
+
+b8 frustum_intersects_sphere(const frustum* f, vec3 center, f32 radius);
+b8 frustum_intersects_aabb(const frustum* f, extents_3d box);
+
+// Bounding spheres of many objects
+typedef struct frustum_cull_spheres {
+    const f32* center_x;
+    const f32* center_y;
+    const f32* center_z;
+    const f32* radius;
+} frustum_cull_spheres;
+
+// Axis aligned boxes of many objects, as centers and half sizes
+typedef struct frustum_cull_boxes {
+    const f32* center_x;
+    const f32* center_y;
+    const f32* center_z;
+    const f32* half_extent_x;
+    const f32* half_extent_y;
+    const f32* half_extent_z;
+} frustum_cull_boxes;
+
+/**
+ * Test many bounding spheres against the frustum
+ * @param f the frustum
+ * @param spheres the spheres
+ * @param count number of spheres
+ * @param out_visible receives the indices of the visible spheres, room for count indices
+ * @return the number of visible spheres
+ */
+u32 frustum_cull_spheres_batch(const frustum* f, const frustum_cull_spheres* spheres, u32 count, u32* out_visible);
+
+/**
+ * Test many boxes against the frustum. A box is kept if it is not entirely behind one of the
+ * planes, which keeps a few boxes near the corners of the frustum that are outside of it
+ * @param f the frustum
+ * @param boxes the boxes
+ * @param count number of boxes
+ * @param out_visible receives the indices of the visible boxes, room for count indices
+ * @return the number of visible boxes
+ */
+u32 frustum_cull_boxes_batch(const frustum* f, const frustum_cull_boxes* boxes, u32 count, u32* out_visible);
@@ -4,6 +4,16 @@
 
 #include "define.h"
 
+// cUSE_SIMD (CMake option CENGINE_USE_SIMD) selects the SSE implementation of the vec4, quat and
+// mat4 functions. The scalar code stays the reference and is used where SSE is not available
+#if defined(cUSE_SIMD) && !(defined(__SSE2__) || defined(_M_X64))
+#undef cUSE_SIMD
+#endif
+
+#if defined(cUSE_SIMD)
+#include <immintrin.h>
+#endif
+
 typedef union vec2_u {
     f32 elements[2];
     struct {
@@ -33,7 +43,7 @@ typedef union vec3_u {
 
 typedef union vec4_u {
 #if defined(cUSE_SIMD)
-    alignas(16) _m128 data;
+    alignas(16) __m128 data;
 #endif
 
     alignas(16) f32 elements[4];
@@ -62,10 +72,53 @@ typedef union mat4_u {
     alignas(16) f32 data[16];
 
 #if defined(cUSE_SIMD)
-    alignas(16) _m128 rows[4];
+    alignas(16) __m128 rows[4];
 #endif
 } mat4;
 
+// Affine transform in 12 floats: the mat4 without its constant last column (0, 0, 0, 1), transposed.
+// Row i holds column i of the mat4, so this is the transform in the column vector convention,
+// p' = m * (p, 1), which is also how a shader reads 3 vec4s
+typedef union mat3x4_u {
+    alignas(16) f32 data[12];
+
+#if defined(cUSE_SIMD)
+    alignas(16) __m128 rows[3];
+#endif
+} mat3x4;
+
+// Axis aligned box
+typedef struct extents_3d {
+    vec3 min;
+    vec3 max;
+} extents_3d;
+
+// Points p with dot(normal, p) + distance >= 0 are in front of the plane
+typedef struct plane_3d {
+    vec3 normal;
+    f32 distance;
+} plane_3d;
+
+typedef struct sphere_3d {
+    vec3 center;
+    f32 radius;
+} sphere_3d;
+
+typedef enum frustum_side {
+    FRUSTUM_SIDE_LEFT,
+    FRUSTUM_SIDE_RIGHT,
+    FRUSTUM_SIDE_BOTTOM,
+    FRUSTUM_SIDE_TOP,
+    FRUSTUM_SIDE_NEAR,
+    FRUSTUM_SIDE_FAR,
+    FRUSTUM_SIDE_COUNT
+} frustum_side;
+
+// The planes face inwards
+typedef struct frustum {
+    plane_3d sides[FRUSTUM_SIDE_COUNT];
+} frustum;
+
 typedef struct vertex_3d {
     vec3 position;
     vec2 texcoord;
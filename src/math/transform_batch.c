@@ -0,0 +1,378 @@
+#include "transform_batch.h"
+
+#include "cmath.h"
+#include "core/logger.h"
+#include "core/cmemory.h"
+#include "platform/platform.h"
+
+#include <stdatomic.h>
+
+// below this many transforms per thread, waking the workers costs more than it saves
+#define TRANSFORM_BATCH_MIN_PER_THREAD 2048
+// how often an idle worker checks if the batch is being destroyed
+#define TRANSFORM_BATCH_WORKER_WAIT_MS 100
+
+#define TRANSFORM_BATCH_COMPONENT_COUNT 10
+
+typedef struct transform_batch_job {
+    const transform_batch* batch;
+    mat4* out_models;
+    u32 first;
+    u32 count;
+} transform_batch_job;
+
+typedef struct transform_batch_worker {
+    struct transform_batch_workers* workers;
+    platform_thread thread;
+    platform_semaphore start;
+    transform_batch_job job;
+} transform_batch_worker;
+
+typedef struct transform_batch_workers {
+    transform_batch_worker* workers;
+    u32 started_count;
+    platform_semaphore done;
+    atomic_bool running;
+} transform_batch_workers;
+
+// Compute a single model matrix, the same way as the SIMD path
+static void compute_one(const transform_batch* batch, u32 i, mat4* out_model) {
+    f32 x = batch->rotation_x[i];
+    f32 y = batch->rotation_y[i];
+    f32 z = batch->rotation_z[i];
+    f32 w = batch->rotation_w[i];
+    f32 inverse_length = 1.0f / c_sqrtf(x * x + y * y + z * z + w * w);
+    x *= inverse_length;
+    y *= inverse_length;
+    z *= inverse_length;
+    w *= inverse_length;
+
+    f32 sx = batch->scale_x[i];
+    f32 sy = batch->scale_y[i];
+    f32 sz = batch->scale_z[i];
+    f32* m = out_model->data;
+    m[0] = sx * (1.0f - 2.0f * y * y - 2.0f * z * z);
+    m[1] = sx * (2.0f * x * y + 2.0f * z * w);
+    m[2] = sx * (2.0f * x * z - 2.0f * y * w);
+    m[3] = 0.0f;
+    m[4] = sy * (2.0f * x * y - 2.0f * z * w);
+    m[5] = sy * (1.0f - 2.0f * x * x - 2.0f * z * z);
+    m[6] = sy * (2.0f * y * z + 2.0f * x * w);
+    m[7] = 0.0f;
+    m[8] = sz * (2.0f * x * z + 2.0f * y * w);
+    m[9] = sz * (2.0f * y * z - 2.0f * x * w);
+    m[10] = sz * (1.0f - 2.0f * x * x - 2.0f * y * y);
+    m[11] = 0.0f;
+    m[12] = batch->position_x[i];
+    m[13] = batch->position_y[i];
+    m[14] = batch->position_z[i];
+    m[15] = 1.0f;
+}
+
+#if defined(cUSE_SIMD)
+/**
+ * Compute the matrices of 4 consecutive transforms: every component is computed for the 4
+ * objects at once, then the rows are transposed into the 4 matrices
+ * @param batch the batch
+ * @param i index of the first transform, a multiple of 4
+ * @param out_models receives the 4 matrices
+ */
+static void compute_four(const transform_batch* batch, u32 i, mat4* out_models) {
+    __m128 x = _mm_load_ps(batch->rotation_x + i);
+    __m128 y = _mm_load_ps(batch->rotation_y + i);
+    __m128 z = _mm_load_ps(batch->rotation_z + i);
+    __m128 w = _mm_load_ps(batch->rotation_w + i);
+
+    __m128 length_squared = _mm_mul_ps(x, x);
+    length_squared = c_mm_madd_ps(y, y, length_squared);
+    length_squared = c_mm_madd_ps(z, z, length_squared);
+    length_squared = c_mm_madd_ps(w, w, length_squared);
+    // full precision on purpose, _mm_rsqrt_ps would visibly shear the matrices
+    __m128 inverse_length = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length_squared));
+    x = _mm_mul_ps(x, inverse_length);
+    y = _mm_mul_ps(y, inverse_length);
+    z = _mm_mul_ps(z, inverse_length);
+    w = _mm_mul_ps(w, inverse_length);
+
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 x2 = _mm_add_ps(x, x);
+    __m128 y2 = _mm_add_ps(y, y);
+    __m128 z2 = _mm_add_ps(z, z);
+    __m128 xx = _mm_mul_ps(x2, x);
+    __m128 yy = _mm_mul_ps(y2, y);
+    __m128 zz = _mm_mul_ps(z2, z);
+    __m128 xy = _mm_mul_ps(x2, y);
+    __m128 xz = _mm_mul_ps(x2, z);
+    __m128 yz = _mm_mul_ps(y2, z);
+    __m128 xw = _mm_mul_ps(x2, w);
+    __m128 yw = _mm_mul_ps(y2, w);
+    __m128 zw = _mm_mul_ps(z2, w);
+
+    __m128 sx = _mm_load_ps(batch->scale_x + i);
+    __m128 sy = _mm_load_ps(batch->scale_y + i);
+    __m128 sz = _mm_load_ps(batch->scale_z + i);
+    __m128 zero = _mm_setzero_ps();
+
+    // element (row, column) of the 4 matrices
+    __m128 m00 = _mm_mul_ps(sx, _mm_sub_ps(_mm_sub_ps(one, yy), zz));
+    __m128 m01 = _mm_mul_ps(sx, _mm_add_ps(xy, zw));
+    __m128 m02 = _mm_mul_ps(sx, _mm_sub_ps(xz, yw));
+    __m128 m03 = zero;
+    __m128 m10 = _mm_mul_ps(sy, _mm_sub_ps(xy, zw));
+    __m128 m11 = _mm_mul_ps(sy, _mm_sub_ps(_mm_sub_ps(one, xx), zz));
+    __m128 m12 = _mm_mul_ps(sy, _mm_add_ps(yz, xw));
+    __m128 m13 = zero;
+    __m128 m20 = _mm_mul_ps(sz, _mm_add_ps(xz, yw));
+    __m128 m21 = _mm_mul_ps(sz, _mm_sub_ps(yz, xw));
+    __m128 m22 = _mm_mul_ps(sz, _mm_sub_ps(_mm_sub_ps(one, xx), yy));
+    __m128 m23 = zero;
+    __m128 m30 = _mm_load_ps(batch->position_x + i);
+    __m128 m31 = _mm_load_ps(batch->position_y + i);
+    __m128 m32 = _mm_load_ps(batch->position_z + i);
+    __m128 m33 = one;
+
+    _MM_TRANSPOSE4_PS(m00, m01, m02, m03);
+    _MM_TRANSPOSE4_PS(m10, m11, m12, m13);
+    _MM_TRANSPOSE4_PS(m20, m21, m22, m23);
+    _MM_TRANSPOSE4_PS(m30, m31, m32, m33);
+
+    // after the transposes, mN0..mN3 are row N of the matrices 0..3
+    out_models[0].rows[0] = m00;
+    out_models[0].rows[1] = m10;
+    out_models[0].rows[2] = m20;
+    out_models[0].rows[3] = m30;
+    out_models[1].rows[0] = m01;
+    out_models[1].rows[1] = m11;
+    out_models[1].rows[2] = m21;
+    out_models[1].rows[3] = m31;
+    out_models[2].rows[0] = m02;
+    out_models[2].rows[1] = m12;
+    out_models[2].rows[2] = m22;
+    out_models[2].rows[3] = m32;
+    out_models[3].rows[0] = m03;
+    out_models[3].rows[1] = m13;
+    out_models[3].rows[2] = m23;
+    out_models[3].rows[3] = m33;
+}
+#endif
+
+void transform_batch_compute_range(const transform_batch* batch, u32 first, u32 count, mat4* out_models) {
+    u32 i = first;
+    u32 end = first + count;
+    if (end > batch->count) {
+        end = batch->count;
+    }
+#if defined(cUSE_SIMD)
+    // scalar up to the first group of 4, then 4 at a time
+    for (; i < end && (i & 3) != 0; ++i) {
+        compute_one(batch, i, &out_models[i - first]);
+    }
+    for (; i + 4 <= end; i += 4) {
+        compute_four(batch, i, &out_models[i - first]);
+    }
+#endif
+    for (; i < end; ++i) {
+        compute_one(batch, i, &out_models[i - first]);
+    }
+}
+
+static u32 transform_batch_worker_run(void* params) {
+    transform_batch_worker* worker = params;
+    transform_batch_workers* workers = worker->workers;
+    while (atomic_load_explicit(&workers->running, memory_order_acquire)) {
+        if (!platform_semaphore_wait(&worker->start, TRANSFORM_BATCH_WORKER_WAIT_MS)) {
+            continue;
+        }
+        if (!atomic_load_explicit(&workers->running, memory_order_acquire)) {
+            break;
+        }
+        transform_batch_job* job = &worker->job;
+        transform_batch_compute_range(job->batch, job->first, job->count, job->out_models);
+        platform_semaphore_signal(&workers->done);
+    }
+    return 0;
+}
+
+static void transform_batch_start_workers(transform_batch* batch, u32 worker_count) {
+    transform_batch_workers* workers = callocate(sizeof(transform_batch_workers), MEMORY_TAG_JOB);
+    workers->workers = callocate(sizeof(transform_batch_worker) * worker_count, MEMORY_TAG_JOB);
+    if (!platform_semaphore_create(0, &workers->done)) {
+        LOG_ERROR("Failed to create the transform batch semaphore, the batch runs on the calling thread");
+        cfree(workers->workers, sizeof(transform_batch_worker) * worker_count, MEMORY_TAG_JOB);
+        cfree(workers, sizeof(transform_batch_workers), MEMORY_TAG_JOB);
+        return;
+    }
+
+    atomic_store(&workers->running, true);
+    for (u32 i = 0; i < worker_count; ++i) {
+        transform_batch_worker* worker = &workers->workers[i];
+        worker->workers = workers;
+        if (!platform_semaphore_create(0, &worker->start)) {
+            break;
+        }
+        if (!platform_thread_create(transform_batch_worker_run, worker, &worker->thread)) {
+            platform_semaphore_destroy(&worker->start);
+            break;
+        }
+        workers->started_count++;
+    }
+    if (workers->started_count < worker_count) {
+        LOG_WARN("Started %u of %u transform batch workers", workers->started_count, worker_count);
+    }
+
+    batch->workers = workers;
+    batch->worker_count = worker_count;
+}
+
+static void transform_batch_stop_workers(transform_batch* batch) {
+    transform_batch_workers* workers = batch->workers;
+    if (!workers) {
+        return;
+    }
+    atomic_store(&workers->running, false);
+    for (u32 i = 0; i < workers->started_count; ++i) {
+        platform_semaphore_signal(&workers->workers[i].start);
+    }
+    for (u32 i = 0; i < workers->started_count; ++i) {
+        platform_thread_join(&workers->workers[i].thread);
+        platform_semaphore_destroy(&workers->workers[i].start);
+    }
+    platform_semaphore_destroy(&workers->done);
+    cfree(workers->workers, sizeof(transform_batch_worker) * batch->worker_count, MEMORY_TAG_JOB);
+    cfree(workers, sizeof(transform_batch_workers), MEMORY_TAG_JOB);
+    batch->workers = 0;
+    batch->worker_count = 0;
+}
+
+b8 transform_batch_create(u32 capacity, u32 worker_count, transform_batch* out_batch) {
+    czero_memory(out_batch, sizeof(transform_batch));
+    if (capacity == 0) {
+        LOG_ERROR("transform_batch_create requires a capacity greater than 0");
+        return false;
+    }
+
+    out_batch->capacity = (capacity + 3) & ~3u;
+    // every component array in one block, with room to align the first one
+    u64 array_size = sizeof(f32) * out_batch->capacity;
+    out_batch->memory_size = array_size * TRANSFORM_BATCH_COMPONENT_COUNT + 16;
+    out_batch->memory = callocate(out_batch->memory_size, MEMORY_TAG_ARRAY);
+
+    f32* arrays[TRANSFORM_BATCH_COMPONENT_COUNT];
+    u8* block = (u8*)(((u64)out_batch->memory + 15) & ~(u64)15);
+    for (u32 i = 0; i < TRANSFORM_BATCH_COMPONENT_COUNT; ++i) {
+        arrays[i] = (f32*)(block + array_size * i);
+    }
+    out_batch->position_x = arrays[0];
+    out_batch->position_y = arrays[1];
+    out_batch->position_z = arrays[2];
+    out_batch->rotation_x = arrays[3];
+    out_batch->rotation_y = arrays[4];
+    out_batch->rotation_z = arrays[5];
+    out_batch->rotation_w = arrays[6];
+    out_batch->scale_x = arrays[7];
+    out_batch->scale_y = arrays[8];
+    out_batch->scale_z = arrays[9];
+
+    if (worker_count > 0) {
+        transform_batch_start_workers(out_batch, worker_count);
+    }
+    return true;
+}
+
+void transform_batch_destroy(transform_batch* batch) {
+    transform_batch_stop_workers(batch);
+    if (batch->memory) {
+        cfree(batch->memory, batch->memory_size, MEMORY_TAG_ARRAY);
+    }
+    czero_memory(batch, sizeof(transform_batch));
+}
+
+u32 transform_batch_add(transform_batch* batch, vec3 position, quat rotation, vec3 scale) {
+    if (batch->count >= batch->capacity) {
+        LOG_WARN_ONCE("Transform batch is full (%u transforms)", batch->capacity);
+        return INVALID_ID;
+    }
+    u32 index = batch->count++;
+    transform_batch_set(batch, index, position, rotation, scale);
+    return index;
+}
+
+u32 transform_batch_remove(transform_batch* batch, u32 index) {
+    if (index >= batch->count) {
+        LOG_WARN("transform_batch_remove: index %u out of range (%u transforms)", index, batch->count);
+        return INVALID_ID;
+    }
+    u32 last = --batch->count;
+    if (index == last) {
+        return INVALID_ID;
+    }
+    f32* arrays[TRANSFORM_BATCH_COMPONENT_COUNT] = {
+        batch->position_x, batch->position_y, batch->position_z,
+        batch->rotation_x, batch->rotation_y, batch->rotation_z, batch->rotation_w,
+        batch->scale_x, batch->scale_y, batch->scale_z};
+    for (u32 i = 0; i < TRANSFORM_BATCH_COMPONENT_COUNT; ++i) {
+        arrays[i][index] = arrays[i][last];
+    }
+    return last;
+}
+
+void transform_batch_clear(transform_batch* batch) {
+    batch->count = 0;
+}
+
+void transform_batch_set(transform_batch* batch, u32 index, vec3 position, quat rotation, vec3 scale) {
+    transform_batch_set_position(batch, index, position);
+    transform_batch_set_rotation(batch, index, rotation);
+    transform_batch_set_scale(batch, index, scale);
+}
+
+void transform_batch_set_position(transform_batch* batch, u32 index, vec3 position) {
+    batch->position_x[index] = position.x;
+    batch->position_y[index] = position.y;
+    batch->position_z[index] = position.z;
+}
+
+void transform_batch_set_rotation(transform_batch* batch, u32 index, quat rotation) {
+    batch->rotation_x[index] = rotation.x;
+    batch->rotation_y[index] = rotation.y;
+    batch->rotation_z[index] = rotation.z;
+    batch->rotation_w[index] = rotation.w;
+}
+
+void transform_batch_set_scale(transform_batch* batch, u32 index, vec3 scale) {
+    batch->scale_x[index] = scale.x;
+    batch->scale_y[index] = scale.y;
+    batch->scale_z[index] = scale.z;
+}
+
+void transform_batch_compute(transform_batch* batch, mat4* out_models) {
+    transform_batch_workers* workers = batch->workers;
+    u32 thread_count = workers ? workers->started_count + 1 : 1;
+    u32 max_threads = batch->count / TRANSFORM_BATCH_MIN_PER_THREAD;
+    if (thread_count > max_threads) {
+        thread_count = max_threads > 0 ? max_threads : 1;
+    }
+    if (thread_count == 1) {
+        transform_batch_compute_range(batch, 0, batch->count, out_models);
+        return;
+    }
+
+    // slices start on groups of 4, the calling thread takes the last one
+    u32 slice = ((batch->count / thread_count) + 3) & ~3u;
+    u32 helper_count = thread_count - 1;
+    for (u32 i = 0; i < helper_count; ++i) {
+        transform_batch_job* job = &workers->workers[i].job;
+        job->batch = batch;
+        job->first = slice * i;
+        job->count = slice;
+        job->out_models = out_models + job->first;
+        platform_semaphore_signal(&workers->workers[i].start);
+    }
+    u32 own_first = slice * helper_count;
+    transform_batch_compute_range(batch, own_first, batch->count - own_first, out_models + own_first);
+
+    for (u32 i = 0; i < helper_count; ++i) {
+        while (!platform_semaphore_wait(&workers->done, TRANSFORM_BATCH_WORKER_WAIT_MS)) {
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "define.h"
+#include "math_types.h"
+
+/*
+ * Positions, rotations and scales of many objects stored as separate arrays (one array
+ * per component), turned into model matrices in a single pass.
+ *
+ * The model matrix of an object is scale * rotation * translation, the same as composing
+ * the scale, quat_to_mat4 and mat4_translation matrices with mat4_multiply. With cUSE_SIMD,
+ * four objects are computed at a time. The work can be split across worker threads owned
+ * by the batch.
+ */
+
+typedef struct transform_batch {
+    u32 count;
+    // rounded up to a multiple of 4
+    u32 capacity;
+
+    // one array per component, each holding capacity floats aligned on 16 bytes
+    f32* position_x;
+    f32* position_y;
+    f32* position_z;
+    f32* rotation_x;
+    f32* rotation_y;
+    f32* rotation_z;
+    f32* rotation_w;
+    f32* scale_x;
+    f32* scale_y;
+    f32* scale_z;
+
+    void* memory;
+    u64 memory_size;
+
+    // 0 when the batch is computed on the calling thread only
+    u32 worker_count;
+    struct transform_batch_workers* workers;
+} transform_batch;
+
+/**
+ * Create a batch
+ * @param capacity maximum number of transforms
+ * @param worker_count number of threads helping transform_batch_compute, 0 for none
+ * @param out_batch the batch to be filled
+ * @return true on success. Failing to start the workers is not an error, the batch runs without them
+ */
+b8 transform_batch_create(u32 capacity, u32 worker_count, transform_batch* out_batch);
+
+void transform_batch_destroy(transform_batch* batch);
+
+/**
+ * Append a transform
+ * @return the index of the transform, INVALID_ID when the batch is full
+ */
+u32 transform_batch_add(transform_batch* batch, vec3 position, quat rotation, vec3 scale);
+
+/**
+ * Remove a transform by moving the last one in its place
+ * @param batch the batch
+ * @param index the transform to remove
+ * @return the previous index of the transform that moved to index, INVALID_ID if none moved
+ */
+u32 transform_batch_remove(transform_batch* batch, u32 index);
+
+void transform_batch_clear(transform_batch* batch);
+
+void transform_batch_set(transform_batch* batch, u32 index, vec3 position, quat rotation, vec3 scale);
+void transform_batch_set_position(transform_batch* batch, u32 index, vec3 position);
+void transform_batch_set_rotation(transform_batch* batch, u32 index, quat rotation);
+void transform_batch_set_scale(transform_batch* batch, u32 index, vec3 scale);
+
+/**
+ * Compute the model matrices of a range of transforms on the calling thread
+ * @param batch the batch
+ * @param first index of the first transform
+ * @param count number of transforms
+ * @param out_models receives count matrices, out_models[0] being the matrix of first
+ */
+void transform_batch_compute_range(const transform_batch* batch, u32 first, u32 count, mat4* out_models);
+
+/**
+ * Compute the model matrices of every transform, split across the workers if the batch has
+ * any and is large enough. Returns once all the matrices are written
+ * @param batch the batch
+ * @param out_models receives batch->count matrices
+ */
+void transform_batch_compute(transform_batch* batch, mat4* out_models);
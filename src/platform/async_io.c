@@ -0,0 +1,519 @@
+#define LOG_CHANNEL LOG_CHANNEL_PLATFORM
+
+#include "async_io.h"
+
+#include "platform.h"
+#include "core/logger.h"
+#include "core/cmemory.h"
+
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+// reads are split in chunks of at most this size (a single read can't transfer more than 2GB)
+#define ASYNC_IO_MAX_CHUNK (1024 * 1024 * 1024)
+// how long an idle worker sleeps before checking if it should stop
+#define ASYNC_IO_WORKER_WAIT_MS 100
+
+typedef enum async_request_state {
+    ASYNC_REQUEST_FREE = 0,
+    ASYNC_REQUEST_IN_FLIGHT,
+    ASYNC_REQUEST_COMPLETE,
+} async_request_state;
+
+typedef struct async_read_request {
+    _Atomic u32 state;
+    u32 id;
+    i32 fd;
+    b8 failed;
+    u8* dest;
+    u64 offset;
+    u64 size;
+    u64 bytes_read;
+    PFN_async_read_complete callback;
+    void* user_data;
+    struct iovec iov; // the chunk being read by io_uring
+} async_read_request;
+
+typedef struct io_uring_queue {
+    i32 ring_fd;
+    u32 sq_entries;
+    _Atomic u32* sq_head;
+    _Atomic u32* sq_tail;
+    u32 sq_mask;
+    u32* sq_array;
+    struct io_uring_sqe* sqes;
+    _Atomic u32* cq_head;
+    _Atomic u32* cq_tail;
+    u32 cq_mask;
+    struct io_uring_cqe* cqes;
+
+    void* sq_ring;
+    u64 sq_ring_size;
+    void* cq_ring;
+    u64 cq_ring_size;
+    u64 sqes_size;
+    // entries written to the submission queue but not consumed by the kernel yet
+    u32 unsubmitted;
+} io_uring_queue;
+
+typedef struct async_io_state {
+    async_io_backend backend;
+    u32 capacity;
+    u32 pending_count;
+    u32 next_id;
+
+    async_read_request* requests;
+    u32* free_indices;
+    u32 free_count;
+
+    io_uring_queue uring;
+
+    // thread pool: the main thread pushes request indices, the workers claim them. Its own
+    // threads, as a read can block for milliseconds where the transform_batch workers are
+    // joined within the frame
+    u32 worker_count;
+    platform_thread* workers;
+    u32* jobs;
+    u32 job_tail;
+    _Atomic u32 job_head;
+    platform_semaphore jobs_available;
+    atomic_bool running;
+} async_io_state;
+
+static async_io_state* state_ptr = 0;
+
+static u32 round_up_power_of_2(u32 value) {
+    u32 result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// io_uring
+
+static b8 uring_create(io_uring_queue* q, u32 entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    // the completion queue is twice as large, it can't overflow with at most 'entries' reads in flight
+    i32 fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        LOG_DEBUG("io_uring_setup failed: %s", strerror(errno));
+        return false;
+    }
+
+    q->ring_fd = fd;
+    q->sq_entries = params.sq_entries;
+    q->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    q->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    b8 single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap && q->cq_ring_size > q->sq_ring_size) {
+        q->sq_ring_size = q->cq_ring_size;
+    }
+
+    q->sq_ring = mmap(0, q->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (q->sq_ring == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    if (single_mmap) {
+        q->cq_ring = q->sq_ring;
+    } else {
+        q->cq_ring = mmap(0, q->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (q->cq_ring == MAP_FAILED) {
+            munmap(q->sq_ring, q->sq_ring_size);
+            close(fd);
+            return false;
+        }
+    }
+
+    q->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    q->sqes = mmap(0, q->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (q->sqes == MAP_FAILED) {
+        if (!single_mmap) {
+            munmap(q->cq_ring, q->cq_ring_size);
+        }
+        munmap(q->sq_ring, q->sq_ring_size);
+        close(fd);
+        return false;
+    }
+
+    u8* sq = q->sq_ring;
+    q->sq_head = (_Atomic u32*)(sq + params.sq_off.head);
+    q->sq_tail = (_Atomic u32*)(sq + params.sq_off.tail);
+    q->sq_mask = *(u32*)(sq + params.sq_off.ring_mask);
+    q->sq_array = (u32*)(sq + params.sq_off.array);
+
+    u8* cq = q->cq_ring;
+    q->cq_head = (_Atomic u32*)(cq + params.cq_off.head);
+    q->cq_tail = (_Atomic u32*)(cq + params.cq_off.tail);
+    q->cq_mask = *(u32*)(cq + params.cq_off.ring_mask);
+    q->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    q->unsubmitted = 0;
+    return true;
+}
+
+static void uring_destroy(io_uring_queue* q) {
+    munmap(q->sqes, q->sqes_size);
+    if (q->cq_ring != q->sq_ring) {
+        munmap(q->cq_ring, q->cq_ring_size);
+    }
+    munmap(q->sq_ring, q->sq_ring_size);
+    close(q->ring_fd);
+}
+
+// Hand the queued entries to the kernel, optionally waiting for min_complete completions
+static b8 uring_enter(io_uring_queue* q, u32 min_complete) {
+    u32 flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    if (q->unsubmitted == 0 && min_complete == 0) {
+        return true;
+    }
+    i32 result = syscall(__NR_io_uring_enter, q->ring_fd, q->unsubmitted, min_complete, flags, 0, 0);
+    if (result < 0) {
+        // the kernel is busy, the entries stay queued and are submitted on the next call
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+            return true;
+        }
+        LOG_ERROR("io_uring_enter failed: %s", strerror(errno));
+        return false;
+    }
+    q->unsubmitted -= result;
+    return true;
+}
+
+// Queue the next chunk of a request
+static b8 uring_queue_read(io_uring_queue* q, async_read_request* request, u32 index) {
+    u32 tail = atomic_load_explicit(q->sq_tail, memory_order_relaxed);
+    u32 head = atomic_load_explicit(q->sq_head, memory_order_acquire);
+    if (tail - head >= q->sq_entries) {
+        LOG_ERROR("io_uring submission queue is full");
+        return false;
+    }
+
+    u64 remaining = request->size - request->bytes_read;
+    request->iov.iov_base = request->dest + request->bytes_read;
+    request->iov.iov_len = remaining < ASYNC_IO_MAX_CHUNK ? remaining : ASYNC_IO_MAX_CHUNK;
+
+    u32 slot = tail & q->sq_mask;
+    struct io_uring_sqe* sqe = &q->sqes[slot];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = request->fd;
+    sqe->addr = (u64)&request->iov;
+    sqe->len = 1;
+    sqe->off = request->offset + request->bytes_read;
+    sqe->user_data = index;
+    q->sq_array[slot] = slot;
+
+    atomic_store_explicit(q->sq_tail, tail + 1, memory_order_release);
+    q->unsubmitted++;
+    return uring_enter(q, 0);
+}
+
+// Move the io_uring completions to their requests, queueing the rest of the partial reads
+static void uring_reap(io_uring_queue* q) {
+    u32 head = atomic_load_explicit(q->cq_head, memory_order_relaxed);
+    u32 tail = atomic_load_explicit(q->cq_tail, memory_order_acquire);
+    while (head != tail) {
+        struct io_uring_cqe* cqe = &q->cqes[head & q->cq_mask];
+        u32 index = (u32)cqe->user_data;
+        i32 result = cqe->res;
+        head++;
+
+        async_read_request* request = &state_ptr->requests[index];
+        b8 done = true;
+        if (result == -EINTR || result == -EAGAIN) {
+            done = !uring_queue_read(q, request, index);
+        } else if (result < 0) {
+            request->failed = true;
+        } else if (result > 0) {
+            request->bytes_read += result;
+            if (request->bytes_read < request->size) {
+                done = !uring_queue_read(q, request, index);
+            }
+        }
+        // a read of 0 bytes is the end of the file
+
+        if (done) {
+            if (request->bytes_read < request->size && result > 0) {
+                request->failed = true;
+            }
+            atomic_store_explicit(&request->state, ASYNC_REQUEST_COMPLETE, memory_order_release);
+        }
+    }
+    atomic_store_explicit(q->cq_head, head, memory_order_release);
+    // submit what was queued above
+    uring_enter(q, 0);
+}
+
+// thread pool
+
+static void read_blocking(async_read_request* request) {
+    while (request->bytes_read < request->size) {
+        u64 remaining = request->size - request->bytes_read;
+        ssize_t result = pread(request->fd, request->dest + request->bytes_read,
+                               remaining < ASYNC_IO_MAX_CHUNK ? remaining : ASYNC_IO_MAX_CHUNK,
+                               request->offset + request->bytes_read);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            request->failed = true;
+            break;
+        }
+        if (result == 0) {
+            break;
+        }
+        request->bytes_read += result;
+    }
+}
+
+static u32 async_io_worker(void* params) {
+    async_io_state* state = params;
+    while (atomic_load_explicit(&state->running, memory_order_acquire)) {
+        if (!platform_semaphore_wait(&state->jobs_available, ASYNC_IO_WORKER_WAIT_MS)) {
+            continue;
+        }
+        if (!atomic_load_explicit(&state->running, memory_order_acquire)) {
+            break;
+        }
+
+        // every signal matches exactly one pushed job
+        u32 job = atomic_fetch_add_explicit(&state->job_head, 1, memory_order_relaxed);
+        async_read_request* request = &state->requests[state->jobs[job & (state->capacity - 1)]];
+        read_blocking(request);
+        atomic_store_explicit(&request->state, ASYNC_REQUEST_COMPLETE, memory_order_release);
+    }
+    return 0;
+}
+
+// Invoke (or drop) the callbacks of the completed requests and release them
+static u32 dispatch_completed(b8 invoke_callbacks) {
+    u32 count = 0;
+    for (u32 i = 0; i < state_ptr->capacity && state_ptr->pending_count > 0; ++i) {
+        async_read_request* request = &state_ptr->requests[i];
+        if (atomic_load_explicit(&request->state, memory_order_acquire) != ASYNC_REQUEST_COMPLETE) {
+            continue;
+        }
+
+        // release the request first so the callback can submit a new read
+        close(request->fd);
+        u32 id = request->id;
+        b8 success = !request->failed && request->bytes_read == request->size;
+        u64 bytes_read = request->bytes_read;
+        PFN_async_read_complete callback = request->callback;
+        void* user_data = request->user_data;
+        atomic_store_explicit(&request->state, ASYNC_REQUEST_FREE, memory_order_relaxed);
+        state_ptr->free_indices[state_ptr->free_count++] = i;
+        state_ptr->pending_count--;
+
+        if (invoke_callbacks && callback) {
+            callback(id, success, bytes_read, user_data);
+        }
+        count++;
+    }
+    return count;
+}
+
+b8 initialize_async_io(u64* memory_requirement, void* state, async_io_config config) {
+    u32 capacity = round_up_power_of_2(config.max_in_flight ? config.max_in_flight : 1);
+    u32 worker_count = config.worker_count ? config.worker_count : 1;
+    *memory_requirement = sizeof(async_io_state)
+                          + sizeof(async_read_request) * capacity
+                          + sizeof(platform_thread) * worker_count
+                          + sizeof(u32) * capacity * 2;
+    if (!state) {
+        return false;
+    }
+
+    czero_memory(state, *memory_requirement);
+    state_ptr = state;
+    state_ptr->capacity = capacity;
+    state_ptr->worker_count = worker_count;
+    state_ptr->next_id = 0;
+
+    u8* block = (u8*)state + sizeof(async_io_state);
+    state_ptr->requests = (async_read_request*)block;
+    block += sizeof(async_read_request) * capacity;
+    state_ptr->workers = (platform_thread*)block;
+    block += sizeof(platform_thread) * worker_count;
+    state_ptr->free_indices = (u32*)block;
+    block += sizeof(u32) * capacity;
+    state_ptr->jobs = (u32*)block;
+
+    // hand out the low indices first
+    for (u32 i = 0; i < capacity; ++i) {
+        state_ptr->free_indices[i] = capacity - 1 - i;
+    }
+    state_ptr->free_count = capacity;
+
+    if (config.backend != ASYNC_IO_BACKEND_THREAD_POOL) {
+        if (uring_create(&state_ptr->uring, capacity)) {
+            state_ptr->backend = ASYNC_IO_BACKEND_IO_URING;
+            LOG_INFO("Async I/O initialized (io_uring, %u reads in flight)", capacity);
+            return true;
+        }
+        if (config.backend == ASYNC_IO_BACKEND_IO_URING) {
+            LOG_ERROR("io_uring is not available");
+            state_ptr = 0;
+            return false;
+        }
+        LOG_INFO("io_uring is not available, using a thread pool for async I/O");
+    }
+
+    state_ptr->backend = ASYNC_IO_BACKEND_THREAD_POOL;
+    if (!platform_semaphore_create(0, &state_ptr->jobs_available)) {
+        LOG_ERROR("Failed to create the async I/O semaphore");
+        state_ptr = 0;
+        return false;
+    }
+    atomic_store(&state_ptr->running, true);
+    for (u32 i = 0; i < worker_count; ++i) {
+        if (!platform_thread_create(async_io_worker, state_ptr, &state_ptr->workers[i])) {
+            LOG_ERROR("Failed to create async I/O worker %u", i);
+            state_ptr->worker_count = i;
+            shutdown_async_io();
+            return false;
+        }
+    }
+
+    LOG_INFO("Async I/O initialized (%u workers, %u reads in flight)", worker_count, capacity);
+    return true;
+}
+
+void shutdown_async_io() {
+    if (!state_ptr) {
+        return;
+    }
+
+    // the destinations may be freed after the shutdown, so let the reads finish
+    while (true) {
+        if (state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+            uring_reap(&state_ptr->uring);
+        }
+        dispatch_completed(false);
+        if (state_ptr->pending_count == 0) {
+            break;
+        }
+        if (state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+            if (!uring_enter(&state_ptr->uring, 1)) {
+                break;
+            }
+        } else {
+            platform_sleep_ms(1);
+        }
+    }
+
+    if (state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+        uring_destroy(&state_ptr->uring);
+    } else {
+        atomic_store(&state_ptr->running, false);
+        for (u32 i = 0; i < state_ptr->worker_count; ++i) {
+            platform_semaphore_signal(&state_ptr->jobs_available);
+        }
+        for (u32 i = 0; i < state_ptr->worker_count; ++i) {
+            platform_thread_join(&state_ptr->workers[i]);
+        }
+        platform_semaphore_destroy(&state_ptr->jobs_available);
+    }
+
+    state_ptr = 0;
+}
+
+async_io_backend async_io_get_backend() {
+    return state_ptr ? state_ptr->backend : ASYNC_IO_BACKEND_AUTO;
+}
+
+u32 filesystem_read_async(const char* path, u64 offset, u64 size, void* dest, PFN_async_read_complete callback, void* user_data) {
+    if (!state_ptr || !path || (!dest && size > 0)) {
+        return INVALID_ID;
+    }
+    if (state_ptr->free_count == 0) {
+        LOG_WARN("Too many async reads in flight, can't read %s", path);
+        return INVALID_ID;
+    }
+
+    i32 fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open file %s for an async read", path);
+        return INVALID_ID;
+    }
+
+    u32 index = state_ptr->free_indices[--state_ptr->free_count];
+    async_read_request* request = &state_ptr->requests[index];
+    request->id = state_ptr->next_id++;
+    if (state_ptr->next_id == INVALID_ID) {
+        state_ptr->next_id = 0;
+    }
+    request->fd = fd;
+    request->failed = false;
+    request->dest = dest;
+    request->offset = offset;
+    request->size = size;
+    request->bytes_read = 0;
+    request->callback = callback;
+    request->user_data = user_data;
+    atomic_store_explicit(&request->state, ASYNC_REQUEST_IN_FLIGHT, memory_order_relaxed);
+    state_ptr->pending_count++;
+
+    if (size == 0) {
+        atomic_store_explicit(&request->state, ASYNC_REQUEST_COMPLETE, memory_order_relaxed);
+    } else if (state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+        if (!uring_queue_read(&state_ptr->uring, request, index)) {
+            // reported as a failed read by the next poll
+            request->failed = true;
+            atomic_store_explicit(&request->state, ASYNC_REQUEST_COMPLETE, memory_order_relaxed);
+        }
+    } else {
+        state_ptr->jobs[state_ptr->job_tail & (state_ptr->capacity - 1)] = index;
+        state_ptr->job_tail++;
+        platform_semaphore_signal(&state_ptr->jobs_available);
+    }
+
+    return request->id;
+}
+
+u32 async_io_poll() {
+    if (!state_ptr || state_ptr->pending_count == 0) {
+        return 0;
+    }
+    if (state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+        uring_reap(&state_ptr->uring);
+    }
+    return dispatch_completed(true);
+}
+
+u32 async_io_pending_count() {
+    return state_ptr ? state_ptr->pending_count : 0;
+}
+
+b8 async_io_wait_all(u64 timeout_ms) {
+    if (!state_ptr) {
+        return true;
+    }
+
+    f64 deadline = platform_get_absolute_time() + timeout_ms / 1000.0;
+    while (true) {
+        async_io_poll();
+        if (state_ptr->pending_count == 0) {
+            return true;
+        }
+        if (platform_get_absolute_time() >= deadline) {
+            return false;
+        }
+        if (state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+            // every read in the kernel completes, so blocking for one can't hang
+            uring_enter(&state_ptr->uring, 1);
+        } else {
+            platform_sleep_ms(1);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "define.h"
+
+/*
+ * Asynchronous file reads.
+ *
+ * Reads are submitted with filesystem_read_async and run in the background, through
+ * io_uring when the kernel allows it and a pool of worker threads otherwise. Their
+ * callbacks are only invoked from async_io_poll, called once per frame by the main loop.
+ * Submission and polling must both happen on the main thread.
+ */
+
+typedef enum async_io_backend {
+    // io_uring, or the thread pool if io_uring is unavailable
+    ASYNC_IO_BACKEND_AUTO = 0,
+    ASYNC_IO_BACKEND_IO_URING,
+    ASYNC_IO_BACKEND_THREAD_POOL,
+} async_io_backend;
+
+typedef struct async_io_config {
+    async_io_backend backend;
+    // maximum number of reads in flight, rounded up to a power of 2
+    u32 max_in_flight;
+    // number of workers of the thread pool backend
+    u32 worker_count;
+} async_io_config;
+
+/**
+ * Called from async_io_poll once a read is done
+ * @param request_id the id returned by filesystem_read_async
+ * @param success true if the whole size was read
+ * @param bytes_read number of bytes written to the destination (less than size at the end of the file)
+ * @param user_data the pointer given to filesystem_read_async
+ */
+typedef void (*PFN_async_read_complete)(u32 request_id, b8 success, u64 bytes_read, void* user_data);
+
+b8 initialize_async_io(u64* memory_requirement, void* state, async_io_config config);
+
+// Wait for the reads in flight (their callbacks are not called) and stop the backend
+void shutdown_async_io();
+
+// The backend really in use, after the AUTO fallback
+async_io_backend async_io_get_backend();
+
+/**
+ * Start reading a part of a file in the background.
+ * The file is opened right away, the read itself is asynchronous.
+ * @param path path to the file to read
+ * @param offset position of the first byte to read in the file
+ * @param size number of bytes to read
+ * @param dest where the data is written. Must stay valid until the callback has been invoked
+ * @param callback invoked from async_io_poll once the read is done, may be 0
+ * @param user_data passed to the callback
+ * @return the id of the request, INVALID_ID if the file can't be opened or too many reads are in flight
+ */
+u32 filesystem_read_async(const char* path, u64 offset, u64 size, void* dest, PFN_async_read_complete callback, void* user_data);
+
+/**
+ * Invoke the callbacks of the reads that completed since the last call
+ * @return the number of callbacks invoked
+ */
+u32 async_io_poll();
+
+// Number of reads submitted whose callback has not been invoked yet
+u32 async_io_pending_count();
+
+/**
+ * Block until every pending read completed and its callback has been invoked
+ * @param timeout_ms maximum time to wait, in milliseconds
+ * @return false on timeout
+ */
+b8 async_io_wait_all(u64 timeout_ms);
@@ -0,0 +1,330 @@
+#define LOG_CHANNEL LOG_CHANNEL_PLATFORM
+
+#include "cpu_info.h"
+
+#include "core/logger.h"
+#include "core/cmemory.h"
+#include "core/cstring.h"
+#include "platform.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CPU_INFO_X86 1
+#endif
+
+// cpus tracked when counting cores and packages
+#define CPU_INFO_MAX_CPUS 1024
+
+typedef enum cpu_info_status {
+    CPU_INFO_NOT_QUERIED = 0,
+    CPU_INFO_WRITING = 1,
+    CPU_INFO_READY = 2,
+} cpu_info_status;
+
+static platform_cpu_info cpu_info;
+// cpu_info is only read once this is CPU_INFO_READY, stored with release ordering
+static atomic_uint cpu_info_status_value = CPU_INFO_NOT_QUERIED;
+
+#ifdef CPU_INFO_X86
+static u64 read_xcr0() {
+    u32 eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((u64)edx << 32) | eax;
+}
+
+static void query_cpuid(platform_cpu_info* info) {
+    u32 eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+        return;
+    }
+    u32 max_leaf = eax;
+    ccopy_memory(info->vendor, &ebx, 4);
+    ccopy_memory(info->vendor + 4, &edx, 4);
+    ccopy_memory(info->vendor + 8, &ecx, 4);
+    info->vendor[12] = 0;
+
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    u32 features = 0;
+    if (edx & bit_SSE2) features |= CPU_FEATURE_SSE2;
+    if (ecx & bit_SSE3) features |= CPU_FEATURE_SSE3;
+    if (ecx & bit_SSSE3) features |= CPU_FEATURE_SSSE3;
+    if (ecx & bit_SSE4_1) features |= CPU_FEATURE_SSE4_1;
+    if (ecx & bit_SSE4_2) features |= CPU_FEATURE_SSE4_2;
+    if (ecx & bit_POPCNT) features |= CPU_FEATURE_POPCNT;
+
+    // the wide registers can only be used if the OS saves them on context switches
+    b8 os_saves_ymm = false;
+    b8 os_saves_zmm = false;
+    if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+        u64 xcr0 = read_xcr0();
+        os_saves_ymm = (xcr0 & 0x6) == 0x6;
+        os_saves_zmm = os_saves_ymm && (xcr0 & 0xE0) == 0xE0;
+    }
+    if (os_saves_ymm) {
+        features |= CPU_FEATURE_AVX;
+        if (ecx & bit_FMA) features |= CPU_FEATURE_FMA;
+        if (ecx & bit_F16C) features |= CPU_FEATURE_F16C;
+    }
+
+    if (max_leaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if (ebx & bit_BMI) features |= CPU_FEATURE_BMI1;
+        if (ebx & bit_BMI2) features |= CPU_FEATURE_BMI2;
+        if (os_saves_ymm && (ebx & bit_AVX2)) features |= CPU_FEATURE_AVX2;
+        if (os_saves_zmm) {
+            if (ebx & bit_AVX512F) features |= CPU_FEATURE_AVX512F;
+            if (ebx & bit_AVX512DQ) features |= CPU_FEATURE_AVX512DQ;
+            if (ebx & bit_AVX512BW) features |= CPU_FEATURE_AVX512BW;
+            if (ebx & bit_AVX512VL) features |= CPU_FEATURE_AVX512VL;
+        }
+    }
+
+    u32 max_extended_leaf = __get_cpuid_max(0x80000000, 0);
+    if (max_extended_leaf >= 0x80000001) {
+        __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+        if (edx & (1 << 27)) features |= CPU_FEATURE_RDTSCP;
+    }
+    if (max_extended_leaf >= 0x80000004) {
+        u32* brand = (u32*)info->brand;
+        for (u32 i = 0; i < 3; ++i) {
+            __get_cpuid(0x80000002 + i, &brand[i * 4], &brand[i * 4 + 1], &brand[i * 4 + 2], &brand[i * 4 + 3]);
+        }
+        info->brand[48] = 0;
+    }
+    if (max_extended_leaf >= 0x80000007) {
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        if (edx & (1 << 8)) features |= CPU_FEATURE_INVARIANT_TSC;
+    }
+
+    info->features = features;
+}
+#endif
+
+// Read the first line of a sysfs file, false if it doesn't exist
+static b8 read_sysfs_line(const char* path, char* out_line, u32 capacity) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    b8 result = fgets(out_line, capacity, file) != 0;
+    fclose(file);
+    if (result) {
+        out_line[strcspn(out_line, "\n")] = 0;
+    }
+    return result;
+}
+
+static b8 read_sysfs_u32(const char* path, u32* out_value) {
+    char line[64];
+    if (!read_sysfs_line(path, line, sizeof(line))) {
+        return false;
+    }
+    *out_value = (u32)strtoul(line, 0, 10);
+    return true;
+}
+
+// Parse a sysfs size such as "48K" or "32M"
+static u64 parse_size(const char* text) {
+    char* end = 0;
+    u64 value = strtoull(text, &end, 10);
+    if (end && (*end == 'K' || *end == 'k')) {
+        value *= 1024;
+    } else if (end && (*end == 'M' || *end == 'm')) {
+        value *= 1024 * 1024;
+    }
+    return value;
+}
+
+/**
+ * Parse a sysfs cpu list such as "0-3,6,8-9"
+ * @param list the list to parse
+ * @param out_cpus filled with the cpu numbers
+ * @param capacity size of out_cpus
+ * @return the number of cpus in the list (only the first capacity are stored)
+ */
+static u32 parse_cpu_list(const char* list, u32* out_cpus, u32 capacity) {
+    u32 count = 0;
+    const char* p = list;
+    while (*p) {
+        char* end = 0;
+        u32 first = (u32)strtoul(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        u32 last = first;
+        p = end;
+        if (*p == '-') {
+            last = (u32)strtoul(p + 1, &end, 10);
+            p = end;
+        }
+        for (u32 cpu = first; cpu <= last; ++cpu) {
+            if (count < capacity) {
+                out_cpus[count] = cpu;
+            }
+            count++;
+        }
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return count;
+}
+
+static void query_topology(platform_cpu_info* info) {
+    i64 online = sysconf(_SC_NPROCESSORS_ONLN);
+    info->logical_core_count = online > 0 ? (u32)online : 1;
+    info->physical_core_count = info->logical_core_count;
+    info->package_count = 1;
+
+    char line[512];
+    if (!read_sysfs_line("/sys/devices/system/cpu/online", line, sizeof(line))) {
+        return;
+    }
+    u32 cpus[CPU_INFO_MAX_CPUS];
+    u32 cpu_count = parse_cpu_list(line, cpus, CPU_INFO_MAX_CPUS);
+    if (cpu_count > CPU_INFO_MAX_CPUS) {
+        cpu_count = CPU_INFO_MAX_CPUS;
+    }
+
+    // a physical core is counted once, on the first of its hardware threads
+    u32 physical_count = 0;
+    u32 max_package_id = 0;
+    char path[128];
+    for (u32 i = 0; i < cpu_count; ++i) {
+        string_format(path, "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", cpus[i]);
+        u32 first_sibling = cpus[i];
+        if (read_sysfs_line(path, line, sizeof(line))) {
+            parse_cpu_list(line, &first_sibling, 1);
+        }
+        if (first_sibling == cpus[i]) {
+            physical_count++;
+        }
+
+        u32 package_id = 0;
+        string_format(path, "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpus[i]);
+        if (read_sysfs_u32(path, &package_id) && package_id > max_package_id) {
+            max_package_id = package_id;
+        }
+    }
+
+    if (physical_count > 0) {
+        info->physical_core_count = physical_count;
+    }
+    info->package_count = max_package_id + 1;
+}
+
+static void query_caches(platform_cpu_info* info) {
+    char path[128];
+    char line[64];
+    for (u32 index = 0;; ++index) {
+        string_format(path, "/sys/devices/system/cpu/cpu0/cache/index%u/level", index);
+        u32 level = 0;
+        if (!read_sysfs_u32(path, &level)) {
+            break;
+        }
+
+        string_format(path, "/sys/devices/system/cpu/cpu0/cache/index%u/size", index);
+        if (!read_sysfs_line(path, line, sizeof(line))) {
+            continue;
+        }
+        u64 size = parse_size(line);
+
+        string_format(path, "/sys/devices/system/cpu/cpu0/cache/index%u/type", index);
+        if (!read_sysfs_line(path, line, sizeof(line))) {
+            continue;
+        }
+
+        if (level == 1 && string_equals(line, "Data")) {
+            info->l1_data_cache_size = size;
+        } else if (level == 1 && string_equals(line, "Instruction")) {
+            info->l1_instruction_cache_size = size;
+        } else if (level == 2) {
+            info->l2_cache_size = size;
+        } else if (level == 3) {
+            info->l3_cache_size = size;
+        }
+
+        u32 line_size = 0;
+        string_format(path, "/sys/devices/system/cpu/cpu0/cache/index%u/coherency_line_size", index);
+        if (read_sysfs_u32(path, &line_size) && line_size > 0) {
+            info->cache_line_size = line_size;
+        }
+    }
+}
+
+static void query_numa(platform_cpu_info* info) {
+    info->numa_node_count = 1;
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (!dir) {
+        return;
+    }
+    u32 count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != 0) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            count++;
+        }
+    }
+    closedir(dir);
+    if (count > 0) {
+        info->numa_node_count = count;
+    }
+}
+
+const platform_cpu_info* platform_get_cpu_info() {
+    if (atomic_load_explicit(&cpu_info_status_value, memory_order_acquire) != CPU_INFO_READY) {
+        platform_cpu_info info;
+        czero_memory(&info, sizeof(info));
+        info.cache_line_size = 64;
+#ifdef CPU_INFO_X86
+        query_cpuid(&info);
+#endif
+        query_topology(&info);
+        query_caches(&info);
+        query_numa(&info);
+
+        // threads racing here compute the same result, the first one publishes it and the
+        // others wait for it to be readable
+        u32 expected = CPU_INFO_NOT_QUERIED;
+        if (atomic_compare_exchange_strong_explicit(&cpu_info_status_value, &expected, CPU_INFO_WRITING,
+                                                    memory_order_relaxed, memory_order_relaxed)) {
+            cpu_info = info;
+            atomic_store_explicit(&cpu_info_status_value, CPU_INFO_READY, memory_order_release);
+        } else {
+            while (atomic_load_explicit(&cpu_info_status_value, memory_order_acquire) != CPU_INFO_READY) {
+                platform_thread_yield();
+            }
+        }
+    }
+    return &cpu_info;
+}
+
+b8 platform_cpu_has(u32 features) {
+    return (platform_get_cpu_info()->features & features) == features;
+}
+
+void platform_cpu_info_log() {
+    const platform_cpu_info* info = platform_get_cpu_info();
+    LOG_INFO("CPU: %s (%s)", info->brand[0] ? info->brand : "unknown", info->vendor[0] ? info->vendor : "unknown vendor");
+    LOG_INFO("CPU: %u logical / %u physical cores, %u package(s), %u NUMA node(s)",
+             info->logical_core_count, info->physical_core_count, info->package_count, info->numa_node_count);
+    LOG_INFO("CPU caches: L1d %lluK, L1i %lluK, L2 %lluK, L3 %lluK, %u byte lines",
+             info->l1_data_cache_size / 1024, info->l1_instruction_cache_size / 1024,
+             info->l2_cache_size / 1024, info->l3_cache_size / 1024, info->cache_line_size);
+    LOG_INFO("CPU features:%s%s%s%s%s%s%s%s",
+             (info->features & CPU_FEATURE_SSE2) ? " SSE2" : "",
+             (info->features & CPU_FEATURE_SSE4_2) ? " SSE4.2" : "",
+             (info->features & CPU_FEATURE_AVX) ? " AVX" : "",
+             (info->features & CPU_FEATURE_AVX2) ? " AVX2" : "",
+             (info->features & CPU_FEATURE_FMA) ? " FMA" : "",
+             (info->features & CPU_FEATURE_AVX512F) ? " AVX-512" : "",
+             (info->features & CPU_FEATURE_RDTSCP) ? " RDTSCP" : "",
+             (info->features & CPU_FEATURE_INVARIANT_TSC) ? " invariant-TSC" : "");
+}
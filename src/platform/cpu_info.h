@@ -0,0 +1,57 @@
+#pragma once
+
+#include "define.h"
+
+// Instruction set extensions supported by both the CPU and the OS
+typedef enum cpu_feature_flags {
+    CPU_FEATURE_SSE2 = 0x1,
+    CPU_FEATURE_SSE3 = 0x2,
+    CPU_FEATURE_SSSE3 = 0x4,
+    CPU_FEATURE_SSE4_1 = 0x8,
+    CPU_FEATURE_SSE4_2 = 0x10,
+    CPU_FEATURE_POPCNT = 0x20,
+    CPU_FEATURE_AVX = 0x40,
+    CPU_FEATURE_AVX2 = 0x80,
+    CPU_FEATURE_FMA = 0x100,
+    CPU_FEATURE_F16C = 0x200,
+    CPU_FEATURE_BMI1 = 0x400,
+    CPU_FEATURE_BMI2 = 0x800,
+    CPU_FEATURE_AVX512F = 0x1000,
+    CPU_FEATURE_AVX512DQ = 0x2000,
+    CPU_FEATURE_AVX512BW = 0x4000,
+    CPU_FEATURE_AVX512VL = 0x8000,
+    CPU_FEATURE_RDTSCP = 0x10000,
+    // the time stamp counter runs at a constant rate in every power state
+    CPU_FEATURE_INVARIANT_TSC = 0x20000,
+} cpu_feature_flags;
+
+typedef struct platform_cpu_info {
+    char vendor[13];
+    char brand[49];
+    u32 features; // cpu_feature_flags
+
+    u32 logical_core_count;
+    u32 physical_core_count;
+    u32 package_count;
+    u32 numa_node_count;
+
+    // cache sizes in bytes, 0 when unknown. l3 is shared by several cores
+    u32 cache_line_size;
+    u64 l1_data_cache_size;
+    u64 l1_instruction_cache_size;
+    u64 l2_cache_size;
+    u64 l3_cache_size;
+} platform_cpu_info;
+
+/**
+ * Get the features and the topology of the CPU. Queried on the first call
+ * (cpuid and sysfs), then cached.
+ * @return the CPU information, never 0
+ */
+const platform_cpu_info* platform_get_cpu_info();
+
+// true if every feature of the given cpu_feature_flags combination is supported
+b8 platform_cpu_has(u32 features);
+
+// Log the CPU information at the info level
+void platform_cpu_info_log();
@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_PLATFORM
+
 #include "filesystem.h"
 
 #include "core/logger.h"
@@ -7,6 +9,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <libgen.h>
 
@@ -165,3 +169,105 @@ b8 filesystem_get_executable_dir(char* buffer) {
     }
     return false;
 }
+
+static i32 map_hint_to_advice(file_map_hint hint) {
+    switch (hint) {
+        case FILE_MAP_HINT_SEQUENTIAL: return MADV_SEQUENTIAL;
+        case FILE_MAP_HINT_RANDOM: return MADV_RANDOM;
+        case FILE_MAP_HINT_WILLNEED: return MADV_WILLNEED;
+        case FILE_MAP_HINT_DONTNEED: return MADV_DONTNEED;
+        default: return MADV_NORMAL;
+    }
+}
+
+// size of the address range reserved for a mapping, the terminator included
+static u64 mapping_length(const file_mapping* mapping) {
+    return mapping->size + ((mapping->flags & FILE_MAP_FLAG_NULL_TERMINATE) ? 1 : 0);
+}
+
+b8 filesystem_map(const char* path, file_map_hint hint, file_map_flags flags, file_mapping* out_mapping) {
+    out_mapping->data = 0;
+    out_mapping->size = 0;
+    out_mapping->flags = flags;
+    out_mapping->is_valid = false;
+
+    i32 fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open file %s for mapping", path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        LOG_ERROR("Failed to map %s: not a regular file", path);
+        close(fd);
+        return false;
+    }
+
+    out_mapping->size = st.st_size;
+    u64 length = mapping_length(out_mapping);
+
+    i32 map_flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (flags & FILE_MAP_FLAG_POPULATE) {
+        map_flags |= MAP_POPULATE;
+    }
+#endif
+
+    void* data = 0;
+    if (length > out_mapping->size) {
+        // reserve zeroed pages first and map the file over them. The tail of the last
+        // file page is zero filled by the kernel, and when the size is a multiple of the
+        // page size the terminator lands in the reserved page after it
+        data = mmap(0, length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            LOG_ERROR("Failed to reserve %llu bytes to map %s", length, path);
+            close(fd);
+            return false;
+        }
+        if (out_mapping->size > 0 && mmap(data, out_mapping->size, PROT_READ, map_flags | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            LOG_ERROR("Failed to map %s", path);
+            munmap(data, length);
+            close(fd);
+            return false;
+        }
+    } else if (length > 0) {
+        data = mmap(0, length, PROT_READ, map_flags, fd, 0);
+        if (data == MAP_FAILED) {
+            LOG_ERROR("Failed to map %s", path);
+            close(fd);
+            return false;
+        }
+    }
+
+    // the mapping keeps its own reference on the file
+    close(fd);
+
+    out_mapping->data = data;
+    out_mapping->is_valid = true;
+    if (hint != FILE_MAP_HINT_NORMAL) {
+        filesystem_map_advise(out_mapping, hint);
+    }
+    return true;
+}
+
+b8 filesystem_map_advise(file_mapping* mapping, file_map_hint hint) {
+    if (!mapping || !mapping->is_valid) {
+        return false;
+    }
+    if (!mapping->data || mapping->size == 0) {
+        return true;
+    }
+    return madvise(mapping->data, mapping->size, map_hint_to_advice(hint)) == 0;
+}
+
+void filesystem_unmap(file_mapping* mapping) {
+    if (mapping && mapping->is_valid) {
+        if (mapping->data) {
+            munmap(mapping->data, mapping_length(mapping));
+        }
+        mapping->data = 0;
+        mapping->size = 0;
+        mapping->is_valid = false;
+    }
+}
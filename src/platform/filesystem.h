@@ -12,6 +12,34 @@ typedef enum file_modes {
     FILE_MODE_WRITE = 0x2,
 } file_modes;
 
+// access pattern hints given to the kernel for a mapped file (madvise)
+typedef enum file_map_hint {
+    FILE_MAP_HINT_NORMAL = 0,
+    FILE_MAP_HINT_SEQUENTIAL,
+    FILE_MAP_HINT_RANDOM,
+    FILE_MAP_HINT_WILLNEED, // start reading the pages ahead
+    FILE_MAP_HINT_DONTNEED, // the pages can be dropped, they will be read again if touched
+} file_map_hint;
+
+typedef enum file_map_flags {
+    FILE_MAP_FLAG_NONE = 0x0,
+    // prefault the whole file when mapping it instead of faulting page by page
+    FILE_MAP_FLAG_POPULATE = 0x1,
+    // guarantee a zero byte right after the content, so text can be used as a C string
+    FILE_MAP_FLAG_NULL_TERMINATE = 0x2,
+} file_map_flags;
+
+/**
+ * A read-only view of a whole file mapped in memory.
+ * The file must not be truncated while it is mapped.
+ */
+typedef struct file_mapping {
+    void* data; // 0 for an empty file without FILE_MAP_FLAG_NULL_TERMINATE
+    u64 size;
+    file_map_flags flags;
+    b8 is_valid;
+} file_mapping;
+
 /**
  * check if a file exists in the filesystem
  * @param path path to the file to check
@@ -89,4 +117,24 @@ b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* o
 
 b8 filesystem_get_executable_path(char* out_path);
 
-b8 filesystem_get_executable_dir(char* out_path);
\ No newline at end of file
+b8 filesystem_get_executable_dir(char* out_path);
+
+/**
+ * Map a whole file read-only in memory. The content is read lazily by the kernel
+ * unless FILE_MAP_FLAG_POPULATE is given.
+ * @param path path to the file to map
+ * @param hint the expected access pattern
+ * @param flags combination of file_map_flags
+ * @param out_mapping the mapping to be filled
+ * @return true if the file was mapped successfully, false otherwise
+ */
+b8 filesystem_map(const char* path, file_map_hint hint, file_map_flags flags, file_mapping* out_mapping);
+
+/**
+ * Give a new access pattern hint for a mapped file, e.g. FILE_MAP_HINT_DONTNEED once
+ * its content has been uploaded
+ * @return true if the hint was applied
+ */
+b8 filesystem_map_advise(file_mapping* mapping, file_map_hint hint);
+
+void filesystem_unmap(file_mapping* mapping);
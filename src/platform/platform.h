@@ -14,9 +14,25 @@ typedef struct platform_state {
     i32 height;
 } platform_state;
 
-b8 initialize_platform(u64* memory_requirement, void* state);
+typedef enum platform_backend_type {
+    PLATFORM_BACKEND_XCB = 0,
+    // no window, no input device and no X server. Resizes are synthetic (platform_headless_resize)
+    PLATFORM_BACKEND_HEADLESS = 1,
+} platform_backend_type;
+
+typedef struct platform_system_config {
+    platform_backend_type backend;
+} platform_system_config;
+
+b8 initialize_platform(u64* memory_requirement, void* state, platform_system_config config);
 void shutdown_platform();
 
+// true if the platform runs without a window (PLATFORM_BACKEND_HEADLESS)
+b8 platform_is_headless();
+
+// Headless only: fire a window resize event on the next platform_pump_messages
+void platform_headless_resize(u16 width, u16 height);
+
 b8 create_window(platform_state* state);
 
 b8 platform_pump_messages(platform_state* state);
@@ -31,6 +47,74 @@ void* platform_set_memory(void* dest, i32 value, u64 size);
 void platform_console_write(const char* message, u8 color);
 void platform_console_write_error(const char* message, u8 color);
 
+/**
+ * Copy message into dest wrapped with the console color sequences used by platform_console_write,
+ * so several messages can be written with a single platform_console_write_raw call
+ * @return the number of bytes written to dest, 0 if it does not fit in capacity
+ */
+u64 platform_console_colorize(char* dest, u64 capacity, const char* message, u64 length, u8 color);
+
+// Write an already formatted block of text to the console (stderr if is_error) and flush it
+void platform_console_write_raw(const char* block, u64 length, b8 is_error);
+
 f64 platform_get_absolute_time();
 
-void platform_sleep_ms(u64 ms);
\ No newline at end of file
+void platform_sleep_ms(u64 ms);
+
+// Sleep until platform_get_absolute_time reaches absolute_time (returns right away if it is in the past)
+void platform_sleep_until(f64 absolute_time);
+
+// Hint to the CPU that the caller is spin-waiting (pause instruction)
+void platform_cpu_relax();
+
+/*
+ * High resolution ticks for profiling: the CPU time stamp counter when it is invariant,
+ * CLOCK_MONOTONIC nanoseconds otherwise. The tick rate is calibrated against
+ * CLOCK_MONOTONIC once, by initialize_platform. Until then the ticks are CLOCK_MONOTONIC
+ * nanoseconds, so don't compare ticks read on both sides of the calibration.
+ */
+
+// Read the tick counter. Cheap, but the CPU may reorder it with the surrounding instructions
+u64 platform_get_ticks();
+
+// Read the tick counter once the previous instructions have completed (rdtscp), for the end of a measure
+u64 platform_get_ticks_ordered();
+
+// Number of ticks per second
+u64 platform_get_tick_frequency();
+
+// true if the ticks come from the time stamp counter
+b8 platform_ticks_use_tsc();
+
+u64 platform_ticks_to_ns(u64 ticks);
+f64 platform_ticks_to_seconds(u64 ticks);
+
+// Measure the tick rate (blocks for a few milliseconds). Called by initialize_platform
+void platform_ticks_calibrate();
+
+// Threading
+typedef u32 (*PFN_thread_start)(void* params);
+
+typedef struct platform_thread {
+    void* internal_data;
+} platform_thread;
+
+typedef struct platform_semaphore {
+    void* internal_data;
+} platform_semaphore;
+
+b8 platform_thread_create(PFN_thread_start start, void* params, platform_thread* out_thread);
+// Wait for the thread to exit and release it
+void platform_thread_join(platform_thread* thread);
+void platform_thread_yield();
+
+b8 platform_semaphore_create(u32 initial_count, platform_semaphore* out_semaphore);
+void platform_semaphore_destroy(platform_semaphore* semaphore);
+void platform_semaphore_signal(platform_semaphore* semaphore);
+/**
+ * Wait for the semaphore to be signaled
+ * @param semaphore the semaphore to wait on
+ * @param timeout_ms maximum time to wait, in milliseconds
+ * @return true if the semaphore was signaled, false on timeout
+ */
+b8 platform_semaphore_wait(platform_semaphore* semaphore, u64 timeout_ms);
@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_PLATFORM
+
 #include "platform/platform.h"
 #include "renderer/vulkan/vulkan_platform.h"
 
@@ -8,6 +10,7 @@
 #include "core/logger.h"
 #include "containers/darray.h"
 #include "core/cmemory.h"
+#include "platform/cpu_info.h"
 
 #include <xcb/xcb.h>
 #include <X11/keysym.h>
@@ -15,11 +18,21 @@
 #include <X11/XKBlib.h>
 #include <X11/Xlib-xcb.h>
 #include <sys/time.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <errno.h>
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PLATFORM_HAS_TSC 1
+#endif
+
 #define VK_USE_PLATFORM_XCB_KHR
 #include <vulkan/vulkan.h>
 #include "renderer/vulkan/vulkan_types.inl"
@@ -27,6 +40,13 @@
 
 typedef struct internal_state {
     b8 initialized;
+    platform_backend_type backend;
+
+    // headless: resize delivered on the next pump
+    b8 resize_pending;
+    u16 pending_width;
+    u16 pending_height;
+
     Display* display;
     xcb_connection_t* connection;
     xcb_screen_t* screen;
@@ -45,7 +65,7 @@ typedef struct internal_state {
 
 static internal_state* state_ptr;
 
-b8 initialize_platform(u64* memory_requirement, void* state) {
+b8 initialize_platform(u64* memory_requirement, void* state, platform_system_config config) {
     *memory_requirement = sizeof(internal_state);
     if (state == 0) {
         return false;
@@ -54,9 +74,16 @@ b8 initialize_platform(u64* memory_requirement, void* state) {
     state_ptr = state;
     czero_memory(state_ptr, sizeof(internal_state));
     state_ptr->initialized = true;
+    state_ptr->backend = config.backend;
+
+    platform_ticks_calibrate();
+
+    if (state_ptr->backend == PLATFORM_BACKEND_HEADLESS) {
+        LOG_INFO("Using the headless platform, no window will be created");
+    } else {
+        LOG_INFO("Using XCB for the windowing system");
+    }
 
-    LOG_INFO("Using XCB for the windowing system");
-    
     return true;
 }
 
@@ -73,6 +100,35 @@ void shutdown_platform() {
         
         state_ptr->initialized = false;
     }
+    state_ptr = 0;
+}
+
+b8 platform_is_headless() {
+    return state_ptr && state_ptr->backend == PLATFORM_BACKEND_HEADLESS;
+}
+
+void platform_headless_resize(u16 width, u16 height) {
+    if (!platform_is_headless()) {
+        LOG_WARN("platform_headless_resize is only available with the headless platform");
+        return;
+    }
+    state_ptr->window_width = width;
+    state_ptr->window_height = height;
+    state_ptr->pending_width = width;
+    state_ptr->pending_height = height;
+    state_ptr->resize_pending = true;
+}
+
+static b8 headless_pump_messages() {
+    if (state_ptr->resize_pending) {
+        state_ptr->resize_pending = false;
+        event_context context;
+        context.data.u16[0] = state_ptr->pending_width;
+        context.data.u16[1] = state_ptr->pending_height;
+        event_fire(EVENT_CODE_WINDOW_RESIZE, 0, context);
+    }
+    // no window to close, quitting goes through EVENT_CODE_APPLICATION_QUIT
+    return true;
 }
 
 keys translate_keycode(u32 x_keycode);
@@ -95,6 +151,13 @@ b8 create_window(platform_state* platform_state) {
     state_ptr->start_y = y;
     state_ptr->window_width = window_width;
     state_ptr->window_height = window_height;
+
+    if (state_ptr->backend == PLATFORM_BACKEND_HEADLESS) {
+        // like the first configure notify of a real window
+        platform_headless_resize(window_width, window_height);
+        platform_state->internal_state = state_ptr;
+        return true;
+    }
     
     // Connecter au serveur X
     state_ptr->display = XOpenDisplay(NULL);
@@ -133,7 +196,7 @@ b8 create_window(platform_state* platform_state) {
     // Envoyer la couleur d'arrière-plan et nos événements
     u32 value_list[] = {state_ptr->screen->black_pixel, event_values};
 
-    xcb_void_cookie_t window_cookie = xcb_create_window(
+    xcb_create_window(
         state_ptr->connection,
         XCB_COPY_FROM_PARENT,
         state_ptr->window,
@@ -211,19 +274,43 @@ b8 create_window(platform_state* platform_state) {
 
 b8 platform_pump_messages(platform_state* platform_state) {
     internal_state* state = platform_state->internal_state;
+    if (state->backend == PLATFORM_BACKEND_HEADLESS) {
+        return headless_pump_messages();
+    }
 
     xcb_generic_event_t* event;
     xcb_client_message_event_t *cm;
 
     b8 quit_flagged = false;
+
+    // a run of motions collapses into its last position, the input system derives the
+    // delta from it. It is flushed before any other event so the order is preserved
+    b8 motion_pending = false;
+    i16 motion_x = 0;
+    i16 motion_y = 0;
+    f64 motion_timestamp = 0;
+    // only the final size of an interactive resize is reported, once per pump
+    b8 resize_pending = false;
+    u16 resize_width = 0;
+    u16 resize_height = 0;
+
     while ((event = xcb_poll_for_event(state->connection))) {
         //event = xcb_poll_for_event(state->connection);
         if (event == 0) {
             break;
         }
 
+        // the input system keeps the time each event was dequeued
+        f64 timestamp = platform_get_absolute_time();
+
+        u8 event_type = event->response_type & ~0x80;
+        if (motion_pending && event_type != XCB_MOTION_NOTIFY) {
+            input_process_mouse_move(motion_x, motion_y, motion_timestamp);
+            motion_pending = false;
+        }
+
         // handle the event
-        switch (event->response_type & ~0x80) {
+        switch (event_type) {
             case XCB_KEY_PRESS:
             case XCB_KEY_RELEASE: {
                 xcb_key_press_event_t *kb_event = (xcb_key_press_event_t*)event;
@@ -237,7 +324,7 @@ b8 platform_pump_messages(platform_state* platform_state) {
 
                 keys key = translate_keycode(key_sym);
 
-                input_process_key(key, pressed);
+                input_process_key(key, pressed, timestamp);
             } break;
             case XCB_BUTTON_PRESS:
             case XCB_BUTTON_RELEASE: {
@@ -254,27 +341,34 @@ b8 platform_pump_messages(platform_state* platform_state) {
                     case XCB_BUTTON_INDEX_3:
                         mouse_button = BUTTON_RIGHT;
                     break;
+                    // X11 reports the wheel as buttons 4 and 5, one press per notch
+                    case XCB_BUTTON_INDEX_4:
+                    case XCB_BUTTON_INDEX_5:
+                        if (pressed) {
+                            input_process_mouse_wheel(mouse_event->detail == XCB_BUTTON_INDEX_4 ? 1 : -1, timestamp);
+                        }
+                    break;
                 }
 
                 // Pass over to the input subsystem
                 if (mouse_button != BUTTON_MAX_BUTTONS) {
-                    input_process_button(mouse_button, pressed);
+                    input_process_button(mouse_button, pressed, timestamp);
                 }
             } break;
             case XCB_MOTION_NOTIFY: {
                 xcb_motion_notify_event_t *move_event = (xcb_motion_notify_event_t *)event;
-                input_process_mouse_move(move_event->event_x, move_event->event_y);
+                motion_pending = true;
+                motion_x = move_event->event_x;
+                motion_y = move_event->event_y;
+                motion_timestamp = timestamp;
             } break;
 
             // resizing
             case XCB_CONFIGURE_NOTIFY: {
                 xcb_configure_notify_event_t *configure_event = (xcb_configure_notify_event_t *)event;
-
-                event_context context;
-                context.data.u16[0] = configure_event->width;
-                context.data.u16[1] = configure_event->height;
-
-                event_fire(EVENT_CODE_WINDOW_RESIZE, 0, context);
+                resize_pending = true;
+                resize_width = configure_event->width;
+                resize_height = configure_event->height;
             } break;
 
             // client message
@@ -287,12 +381,22 @@ b8 platform_pump_messages(platform_state* platform_state) {
             } break;
 
             default:
-                LOG_WARN("An unhandled X11 event was received: %d", event->response_type);
+                LOG_WARN_EVERY_N(256, "An unhandled X11 event was received: %d", event->response_type);
                 break;
         }
         free(event);
     }
 
+    if (motion_pending) {
+        input_process_mouse_move(motion_x, motion_y, motion_timestamp);
+    }
+    if (resize_pending) {
+        event_context context;
+        context.data.u16[0] = resize_width;
+        context.data.u16[1] = resize_height;
+        event_fire(EVENT_CODE_WINDOW_RESIZE, 0, context);
+    }
+
     return !quit_flagged;
 }
 
@@ -316,14 +420,41 @@ void* platform_set_memory(void* dest, i32 value, u64 size) {
     return memset(dest, value, size);
 }
 
+static const char* console_color_strings[] = {"0;41;30", "0;31", "0;33", "0;32", "0;34", "0;30"};
+
 void platform_console_write(const char* message, u8 color) {
-    const char* color_strings[] = {"0;41;30", "0;31", "0;33", "0;32", "0;34", "0;30"};
-    printf("\033[%sm%s\033[0m", color_strings[color], message);
+    printf("\033[%sm%s\033[0m", console_color_strings[color], message);
 }
 
 void platform_console_write_error(const char* message, u8 color) {
-    const char* color_strings[] = {"0;41;30", "0;31", "0;33", "0;32", "0;34", "0;30"};
-    fprintf(stderr, "\033[%sm%s\033[0m", color_strings[color], message);
+    fprintf(stderr, "\033[%sm%s\033[0m", console_color_strings[color], message);
+}
+
+u64 platform_console_colorize(char* dest, u64 capacity, const char* message, u64 length, u8 color) {
+    const char* color_string = console_color_strings[color];
+    u64 color_length = strlen(color_string);
+    // "\033[" + color + "m" + message + "\033[0m"
+    u64 total = 2 + color_length + 1 + length + 4;
+    if (total > capacity) {
+        return 0;
+    }
+
+    char* p = dest;
+    memcpy(p, "\033[", 2);
+    p += 2;
+    memcpy(p, color_string, color_length);
+    p += color_length;
+    *p++ = 'm';
+    memcpy(p, message, length);
+    p += length;
+    memcpy(p, "\033[0m", 4);
+    return total;
+}
+
+void platform_console_write_raw(const char* block, u64 length, b8 is_error) {
+    FILE* stream = is_error ? stderr : stdout;
+    fwrite(block, 1, length, stream);
+    fflush(stream);
 }
 
 f64 platform_get_absolute_time() {
@@ -332,6 +463,105 @@ f64 platform_get_absolute_time() {
     return now.tv_sec + now.tv_nsec * 1e-9;
 }
 
+// how long the tick rate is measured for
+#define TICK_CALIBRATION_NS (20 * 1000 * 1000)
+
+typedef struct tick_clock {
+    b8 use_tsc;
+    u64 frequency;
+    // ticks to nanoseconds as a 32.32 fixed point factor
+    u64 ns_per_tick_fixed;
+} tick_clock;
+
+// CLOCK_MONOTONIC nanoseconds until initialize_platform calibrates the time stamp counter
+static tick_clock ticks = {false, 1000000000ull, 1ull << 32};
+
+static u64 monotonic_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u64)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+#ifdef PLATFORM_HAS_TSC
+// Read the time stamp counter and CLOCK_MONOTONIC as close together as possible
+static void read_tsc_pair(u64* out_tsc, u64* out_ns) {
+    u64 best_window = (u64)-1;
+    for (u32 i = 0; i < 5; ++i) {
+        u64 before = __rdtsc();
+        u64 ns = monotonic_ns();
+        u64 after = __rdtsc();
+        if (after - before < best_window) {
+            best_window = after - before;
+            *out_tsc = before + (after - before) / 2;
+            *out_ns = ns;
+        }
+    }
+}
+#endif
+
+void platform_ticks_calibrate() {
+    tick_clock result = {0};
+    result.frequency = 1000000000ull;
+
+#ifdef PLATFORM_HAS_TSC
+    // a TSC that changes rate with the power states can't measure time
+    if (platform_cpu_has(CPU_FEATURE_INVARIANT_TSC)) {
+        u64 tsc_start, ns_start, tsc_end, ns_end;
+        read_tsc_pair(&tsc_start, &ns_start);
+        platform_sleep_until(platform_get_absolute_time() + TICK_CALIBRATION_NS * 1e-9);
+        read_tsc_pair(&tsc_end, &ns_end);
+
+        u64 elapsed_ns = ns_end - ns_start;
+        if (tsc_end > tsc_start && elapsed_ns > 0) {
+            result.use_tsc = true;
+            result.frequency = (u64)((__uint128_t)(tsc_end - tsc_start) * 1000000000ull / elapsed_ns);
+        }
+    }
+#endif
+
+    result.ns_per_tick_fixed = (u64)(((__uint128_t)1000000000ull << 32) / result.frequency);
+    ticks = result;
+}
+
+u64 platform_get_ticks() {
+#ifdef PLATFORM_HAS_TSC
+    if (ticks.use_tsc) {
+        return __rdtsc();
+    }
+#endif
+    return monotonic_ns();
+}
+
+u64 platform_get_ticks_ordered() {
+#ifdef PLATFORM_HAS_TSC
+    if (ticks.use_tsc) {
+        if (platform_cpu_has(CPU_FEATURE_RDTSCP)) {
+            u32 aux;
+            return __rdtscp(&aux);
+        }
+        _mm_lfence();
+        return __rdtsc();
+    }
+#endif
+    return monotonic_ns();
+}
+
+u64 platform_get_tick_frequency() {
+    return ticks.frequency;
+}
+
+b8 platform_ticks_use_tsc() {
+    return ticks.use_tsc;
+}
+
+u64 platform_ticks_to_ns(u64 tick_count) {
+    return (u64)(((__uint128_t)tick_count * ticks.ns_per_tick_fixed) >> 32);
+}
+
+f64 platform_ticks_to_seconds(u64 tick_count) {
+    return (f64)tick_count / (f64)platform_get_tick_frequency();
+}
+
 void platform_sleep_ms(u64 ms) {
     struct timespec ts;
     ts.tv_sec = ms / 1000;
@@ -339,6 +569,120 @@ void platform_sleep_ms(u64 ms) {
     nanosleep(&ts, 0);
 }
 
+void platform_sleep_until(f64 absolute_time) {
+    // same clock as platform_get_absolute_time, absolute so an interrupted sleep just resumes
+    struct timespec ts;
+    ts.tv_sec = (time_t)absolute_time;
+    ts.tv_nsec = (long)((absolute_time - (f64)ts.tv_sec) * 1e9);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, 0) == EINTR) {
+    }
+}
+
+void platform_cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+typedef struct linux_thread_start {
+    PFN_thread_start start;
+    void* params;
+} linux_thread_start;
+
+static void* linux_thread_entry(void* params) {
+    linux_thread_start start = *(linux_thread_start*)params;
+    free(params);
+    return (void*)(u64)start.start(start.params);
+}
+
+b8 platform_thread_create(PFN_thread_start start, void* params, platform_thread* out_thread) {
+    if (!start || !out_thread) {
+        return false;
+    }
+
+    // freed by the thread once it has read it
+    linux_thread_start* start_params = malloc(sizeof(linux_thread_start));
+    start_params->start = start;
+    start_params->params = params;
+
+    pthread_t* thread = malloc(sizeof(pthread_t));
+    i32 result = pthread_create(thread, 0, linux_thread_entry, start_params);
+    if (result != 0) {
+        LOG_ERROR("Failed to create thread: %s", strerror(result));
+        free(start_params);
+        free(thread);
+        out_thread->internal_data = 0;
+        return false;
+    }
+
+    out_thread->internal_data = thread;
+    return true;
+}
+
+void platform_thread_join(platform_thread* thread) {
+    if (thread && thread->internal_data) {
+        pthread_join(*(pthread_t*)thread->internal_data, 0);
+        free(thread->internal_data);
+        thread->internal_data = 0;
+    }
+}
+
+void platform_thread_yield() {
+    sched_yield();
+}
+
+b8 platform_semaphore_create(u32 initial_count, platform_semaphore* out_semaphore) {
+    sem_t* semaphore = malloc(sizeof(sem_t));
+    if (sem_init(semaphore, 0, initial_count) != 0) {
+        LOG_ERROR("Failed to create semaphore");
+        free(semaphore);
+        out_semaphore->internal_data = 0;
+        return false;
+    }
+
+    out_semaphore->internal_data = semaphore;
+    return true;
+}
+
+void platform_semaphore_destroy(platform_semaphore* semaphore) {
+    if (semaphore && semaphore->internal_data) {
+        sem_destroy(semaphore->internal_data);
+        free(semaphore->internal_data);
+        semaphore->internal_data = 0;
+    }
+}
+
+void platform_semaphore_signal(platform_semaphore* semaphore) {
+    if (semaphore && semaphore->internal_data) {
+        sem_post(semaphore->internal_data);
+    }
+}
+
+b8 platform_semaphore_wait(platform_semaphore* semaphore, u64 timeout_ms) {
+    if (!semaphore || !semaphore->internal_data) {
+        return false;
+    }
+
+    // sem_timedwait uses an absolute CLOCK_REALTIME deadline
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000 * 1000;
+    if (deadline.tv_nsec >= 1000 * 1000 * 1000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000 * 1000 * 1000;
+    }
+
+    while (sem_timedwait(semaphore->internal_data, &deadline) != 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void platform_get_required_extension_names(const char*** extensions) {
     darray_push(*extensions, &"VK_KHR_xcb_surface");
 }
@@ -346,6 +690,10 @@ void platform_get_required_extension_names(const char*** extensions) {
 b8 platform_create_vulkan_surface(platform_state* platform_state, vulkan_context* context) {
     LOG_DEBUG("Creating surface for Vulkan. Current platform: Linux with XCB (X11)");
     internal_state *state = (internal_state *)platform_state->internal_state;
+    if (state->backend == PLATFORM_BACKEND_HEADLESS) {
+        LOG_ERROR("The headless platform has no window to create a Vulkan surface on");
+        return false;
+    }
 
     VkXcbSurfaceCreateInfoKHR create_info = {VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR};
     create_info.connection = state->connection;
@@ -0,0 +1,63 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
+#include "null_backend.h"
+
+#include "core/logger.h"
+
+b8 null_backend_initialize(struct renderer_backend* backend, const char* application_name, struct platform_state* platform_state) {
+    LOG_INFO("Null renderer backend initialized, nothing will be drawn");
+    return true;
+}
+
+void null_backend_shutdown(struct renderer_backend* backend) {
+}
+
+void null_backend_resized(struct renderer_backend* backend, u16 width, u16 height) {
+}
+
+b8 null_backend_begin_frame(struct renderer_backend* backend, f32 delta_time) {
+    return true;
+}
+
+void null_backend_update_global_state(mat4 projection, mat4 view, vec3 view_position, vec4 ambient_colour, i32 mode) {
+}
+
+b8 null_backend_end_frame(struct renderer_backend* backend, f32 delta_time) {
+    return true;
+}
+
+void null_backend_draw_geometry(geometry_render_data data) {
+}
+
+void null_backend_create_texture(const u8* pixels, struct texture* texture) {
+    // same bookkeeping as a real upload
+    texture->internal_data = 0;
+    texture->generation++;
+}
+
+void null_backend_destroy_texture(struct texture* texture) {
+    texture->internal_data = 0;
+}
+
+b8 null_backend_create_material(struct material* material) {
+    material->internal_id = 0;
+    return true;
+}
+
+void null_backend_destroy_material(struct material* material) {
+    material->internal_id = INVALID_ID;
+}
+
+b8 null_backend_create_geometry(geometry* geometry, u32 vertex_count, const vertex_3d* vertices, u32 index_count,
+                                const u32* indices) {
+    if (!vertex_count || !vertices) {
+        LOG_ERROR("null_backend_create_geometry: vertex count is 0 or vertices is null");
+        return false;
+    }
+    geometry->internal_id = 0;
+    return true;
+}
+
+void null_backend_destroy_geometry(geometry* geometry) {
+    geometry->internal_id = INVALID_ID;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "define.h"
+#include "renderer/renderer_backend.h"
+#include "resources/resource_types.h"
+
+// Renderer backend that draws nothing, used with the headless platform to run the frame
+// loop without a GPU or a window
+
+b8 null_backend_initialize(struct renderer_backend* backend, const char* application_name, struct platform_state* platform_state);
+void null_backend_shutdown(struct renderer_backend* backend);
+
+void null_backend_resized(struct renderer_backend* backend, u16 width, u16 height);
+
+b8 null_backend_begin_frame(struct renderer_backend* backend, f32 delta_time);
+void null_backend_update_global_state(mat4 projection, mat4 view, vec3 view_position, vec4 ambient_colour, i32 mode);
+b8 null_backend_end_frame(struct renderer_backend* backend, f32 delta_time);
+
+void null_backend_draw_geometry(geometry_render_data data);
+
+void null_backend_create_texture(const u8* pixels, struct texture* texture);
+void null_backend_destroy_texture(struct texture* texture);
+
+b8 null_backend_create_material(struct material* material);
+void null_backend_destroy_material(struct material* material);
+
+b8 null_backend_create_geometry(geometry* geometry, u32 vertex_count, const vertex_3d* vertices, u32 index_count,
+                                const u32* indices);
+void null_backend_destroy_geometry(geometry* geometry);
@@ -1,7 +1,10 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "renderer_backend.h"
 
 #include "core/logger.h"
 #include "vulkan/vulkan_backend.h"
+#include "null/null_backend.h"
 
 b8 renderer_backend_create(renderer_backend_type type, struct platform_state* platform_state, renderer_backend* out_backend) {
     out_backend->platform_state = platform_state;
@@ -26,6 +29,25 @@ b8 renderer_backend_create(renderer_backend_type type, struct platform_state* pl
             out_backend->create_geometry = vulkan_backend_create_geometry;
             out_backend->destroy_geometry = vulkan_backend_destroy_geometry;
         } break;
+        case RENDERER_BACKEND_NULL: {
+            LOG_INFO("Renderer backend: null");
+            out_backend->initialize = null_backend_initialize;
+            out_backend->shutdown = null_backend_shutdown;
+            out_backend->begin_frame = null_backend_begin_frame;
+            out_backend->update_global_state = null_backend_update_global_state;
+            out_backend->end_frame = null_backend_end_frame;
+            out_backend->resized = null_backend_resized;
+            out_backend->draw_geometry = null_backend_draw_geometry;
+
+            out_backend->create_texture = null_backend_create_texture;
+            out_backend->destroy_texture = null_backend_destroy_texture;
+
+            out_backend->create_material = null_backend_create_material;
+            out_backend->destroy_material = null_backend_destroy_material;
+
+            out_backend->create_geometry = null_backend_create_geometry;
+            out_backend->destroy_geometry = null_backend_destroy_geometry;
+        } break;
         /*case RENDERER_BACKEND_OPENGL: {
             return renderer_backend_opengl_create(platform_state, out_backend);
         } break;
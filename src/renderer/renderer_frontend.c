@@ -1,10 +1,16 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "renderer_frontend.h"
 
+#include "platform/platform.h"
+
 #include "renderer_backend.h"
 
 #include "core/logger.h"
 #include "core/cmemory.h"
 #include "math/cmath.h"
+#include "math/bounds.h"
+#include "math/frustum.h"
 
 #include "resources/resource_types.h"
 
@@ -57,7 +63,9 @@ b8 renderer_initialize(const char* application_name, struct platform_state* plat
     LOG_INFO("Initializing renderer...");
     state_ptr->backend.frame_number = 0;
 
-    renderer_backend_create(RENDERER_BACKEND_VULKAN, platform_state, &state_ptr->backend);
+    // without a window there is nothing to present to
+    renderer_backend_type backend_type = platform_is_headless() ? RENDERER_BACKEND_NULL : RENDERER_BACKEND_VULKAN;
+    renderer_backend_create(backend_type, platform_state, &state_ptr->backend);
 
     if (!state_ptr->backend.initialize(&state_ptr->backend, application_name, platform_state)) {
         LOG_FATAL("Failed to initialize renderer backend. Shutting down...");
@@ -69,7 +77,7 @@ b8 renderer_initialize(const char* application_name, struct platform_state* plat
     state_ptr->far_clip = 1000.0f;
 
     state_ptr->view = mat4_translation((vec3){0, 0, -30.0f});
-    state_ptr->view = mat4_inverse(state_ptr->view);
+    state_ptr->view = mat4_inverse_rigid(state_ptr->view);
 
     return true;
 }
@@ -124,9 +132,15 @@ b8 renderer_draw_frame(render_packet* packet) {
     if (renderer_begin_frame(packet->delta_time)) {
         state_ptr->backend.update_global_state(state_ptr->projection, state_ptr->view, vec3_zero(), vec4_one(), 0);
 
+        frustum view_frustum = frustum_from_matrix(mat4_multiply(state_ptr->view, state_ptr->projection));
         u32 count = packet->geometry_count;
         for (u32 i = 0; i < count; ++i) {
-            state_ptr->backend.draw_geometry(packet->geometries[i]);
+            geometry_render_data* data = &packet->geometries[i];
+            sphere_3d bounds = bounds_sphere_transform(data->geometry->bounding_sphere, data->model);
+            if (!frustum_intersects_sphere(&view_frustum, bounds.center, bounds.radius)) {
+                continue;
+            }
+            state_ptr->backend.draw_geometry(*data);
         }
 
         b8 result = renderer_end_frame(packet->delta_time);
@@ -9,6 +9,7 @@ typedef enum renderer_backend_type {
     RENDERER_BACKEND_VULKAN,
     RENDERER_BACKEND_OPENGL,
     RENDERER_BACKEND_DIRECTX,
+    RENDERER_BACKEND_NULL, // draws nothing, for the headless platform
 } renderer_backend_type;
 
 
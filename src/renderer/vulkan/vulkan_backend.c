@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "vulkan_backend.h"
 
 #include "vulkan_buffer.h"
@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "vulkan_buffer.h"
 
 #include "vulkan_command_buffer.h"
@@ -2,6 +2,8 @@
 // Created by raph on 26/01/25.
 //
 
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "vulkan_fence.h"
 
 #include "core/logger.h"
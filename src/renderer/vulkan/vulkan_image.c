@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "vulkan_image.h"
 
 #include "vulkan_device.h"
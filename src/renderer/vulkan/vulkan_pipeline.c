@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "vulkan_pipeline.h"
 #include "vulkan_utils.h"
 #include "core/cmemory.h"
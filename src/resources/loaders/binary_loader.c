@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RESOURCES
+
 #include "binary_loader.h"
 
 #include "core/cstring.h"
@@ -17,6 +19,24 @@ b8 binary_loader_load(struct resource_loader* self, const char* name, resource*
 
     out->full_path = string_duplicate(full_file_path);
 
+    // a missing file is reported once here, rather than by the map and again by its fallback
+    if (!filesystem_exists(full_file_path)) {
+        LOG_ERROR("Failed to open binary file '%s'", full_file_path);
+        return false;
+    }
+
+    // map the file so the data is a view of the page cache instead of a copy
+    if (filesystem_map(full_file_path, FILE_MAP_HINT_SEQUENTIAL, FILE_MAP_FLAG_NONE, &out->mapping)) {
+        if (out->mapping.size > 0) {
+            out->data = out->mapping.data;
+            out->data_size = out->mapping.size;
+            out->name = name;
+            return true;
+        }
+        // nothing to view in an empty file, give an owned empty buffer like before
+        filesystem_unmap(&out->mapping);
+    }
+
     // load the file
     file_handle file;
     if (!filesystem_open(full_file_path, FILE_MODE_READ, true, &file)) {
@@ -66,7 +86,12 @@ void binary_loader_unload(struct resource_loader* self, resource* resource) {
         cfree(resource->full_path, sizeof(char) * path_length + 1, MEMORY_TAG_STRING);
     }
 
-    if (resource->data) {
+    if (resource->mapping.is_valid) {
+        filesystem_unmap(&resource->mapping);
+        resource->data = 0;
+        resource->data_size = 0;
+        resource->loader_id = INVALID_ID;
+    } else if (resource->data) {
         cfree(resource->data, resource->data_size, MEMORY_TAG_UNKNOWN);
         resource->data = 0;
         resource->data_size = 0;
@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RESOURCES
+
 #include "image_loader.h"
 
 #include "core/logger.h"
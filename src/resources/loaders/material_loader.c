@@ -1,14 +1,15 @@
+#define LOG_CHANNEL LOG_CHANNEL_RESOURCES
+
 #include "material_loader.h"
 
 #include "core/logger.h"
 #include "core/cmemory.h"
 #include "core/cstring.h"
+#include "core/text_reader.h"
 #include "resources/resource_types.h"
 #include "systems/resource_system.h"
 #include "math/cmath.h"
 
-#include "platform/filesystem.h"
-
 b8 material_loader_load(struct resource_loader* self, const char* name, resource* out) {
     if (!self || !name || !out) {
         return false;
@@ -21,8 +22,8 @@ b8 material_loader_load(struct resource_loader* self, const char* name, resource
     out->full_path = string_duplicate(full_file_path);
 
     // load the file
-    file_handle file;
-    if (!filesystem_open(full_file_path, FILE_MODE_READ, false, &file)) {
+    text_reader reader;
+    if (!text_reader_open(full_file_path, &reader)) {
         LOG_ERROR("Failed to open material configuration file '%s'", full_file_path);
         return false;
     }
@@ -34,61 +35,45 @@ b8 material_loader_load(struct resource_loader* self, const char* name, resource
     string_ncopy(resource_data->name, name, MATERIAL_NAME_MAX_LENGTH);
 
     // Read file
-    char line_buffer[1024] = "";
-    char* p = &line_buffer[0];
-    u64 line_length = 0;
-    u32 line_number = 1;
-    while (filesystem_read_line(&file, 1023, &p, &line_length)) {
-        char* trimmed = string_trim(line_buffer);
-        line_length = string_length(trimmed);
+    text_slice line;
+    while (text_reader_next_line(&reader, &line)) {
+        line = text_slice_trim(line);
 
         // skip empty lines and comments
-        if (line_length == 0 || trimmed[0] == '#') {
-            line_number++;
+        if (line.length == 0 || line.data[0] == '#') {
             continue;
         }
 
         // parse the line
-        i32 equal_index = string_index_of(trimmed, '=');
-        if (equal_index == -1) {
-            LOG_WARN("Invalid line in material configuration file '%s' at line %i: '%s'", full_file_path, line_number, trimmed);
-            line_number++;
+        text_slice var_name;
+        text_slice var_value;
+        if (!text_slice_split(line, '=', &var_name, &var_value)) {
+            LOG_WARN("Invalid line in material configuration file '%s' at line %u: '%.*s'", full_file_path, reader.line_number, (i32)line.length, line.data);
             continue;
         }
-
-        // assume the key max length is 64
-        char raw_var_name[64] = "";
-        czero_memory(raw_var_name, sizeof(char) * 64);
-        string_mid(raw_var_name, trimmed, 0, equal_index);
-        char* trimmed_var_name = string_trim(raw_var_name);
-
-        // assume a max of 511 - 65 = 446 for the value
-        char raw_value[446];
-        czero_memory(raw_value, sizeof(char) * 446);
-        string_mid(raw_value, trimmed, equal_index + 1, -1);
-        char* trimmed_var_value = string_trim(raw_value);
+        var_name = text_slice_trim(var_name);
+        var_value = text_slice_trim(var_value);
 
         // process the variable
-        if (string_equals_case(trimmed_var_name, "version")) {
+        if (text_slice_equals_case(var_name, "version")) {
             // TODO: versioning
-        } else if (string_equals_case(trimmed_var_name, "name")) {
-            string_ncopy(resource_data->name, trimmed_var_value, MATERIAL_NAME_MAX_LENGTH);
-        } else if (string_equals_case(trimmed_var_name, "diffuse_map_name")) {
-            string_ncopy(resource_data->diffuse_map_name, trimmed_var_value, TEXTURE_NAME_MAX_LENGTH);
-        } else if (string_equals_case(trimmed_var_name, "diffuse_color")) {
-            if (!string_to_vec4(trimmed_var_value, &resource_data->diffuse_color)) {
-                LOG_WARN("Invalid diffuse color in material configuration file '%s' at line %i: '%s'", full_file_path, line_number, trimmed_var_value);
+        } else if (text_slice_equals_case(var_name, "name")) {
+            text_slice_copy(var_value, resource_data->name, MATERIAL_NAME_MAX_LENGTH);
+        } else if (text_slice_equals_case(var_name, "diffuse_map_name")) {
+            text_slice_copy(var_value, resource_data->diffuse_map_name, TEXTURE_NAME_MAX_LENGTH);
+        } else if (text_slice_equals_case(var_name, "diffuse_color")) {
+            char value[128];
+            text_slice_copy(var_value, value, sizeof(value));
+            if (!string_to_vec4(value, &resource_data->diffuse_color)) {
+                LOG_WARN("Invalid diffuse color in material configuration file '%s' at line %u: '%s'", full_file_path, reader.line_number, value);
             }
         }
 
         // TODO more fields
-
-        czero_memory(line_buffer, sizeof(char) * line_length);
-        line_number++;
     }
 
     // close file
-    filesystem_close(&file);
+    text_reader_close(&reader);
 
     out->data = resource_data;
     out->data_size = sizeof(material_config);
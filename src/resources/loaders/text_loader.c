@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RESOURCES
+
 #include "text_loader.h"
 
 #include "platform/filesystem.h"
@@ -17,6 +19,21 @@ b8 text_loader_load(struct resource_loader* self, const char* name, resource* ou
 
     out->full_path = string_duplicate(full_file_path);
 
+    // a missing file is reported once here, rather than by the map and again by its fallback
+    if (!filesystem_exists(full_file_path)) {
+        LOG_ERROR("Failed to open text file '%s'", full_file_path);
+        return false;
+    }
+
+    // map the file so the text is a view of the page cache instead of a copy. The
+    // mapping is null terminated so it can still be used as a C string
+    if (filesystem_map(full_file_path, FILE_MAP_HINT_SEQUENTIAL, FILE_MAP_FLAG_NULL_TERMINATE, &out->mapping)) {
+        out->data = out->mapping.data;
+        out->data_size = out->mapping.size;
+        out->name = name;
+        return true;
+    }
+
     // load the file
     file_handle file;
     if (!filesystem_open(full_file_path, FILE_MODE_READ, false, &file)) {
@@ -67,7 +84,12 @@ void text_loader_unload(struct resource_loader* self, resource* resource) {
         cfree(resource->full_path, sizeof(char) * string_length(resource->full_path) + 1, MEMORY_TAG_STRING);
     }
 
-    if (resource->data) {
+    if (resource->mapping.is_valid) {
+        filesystem_unmap(&resource->mapping);
+        resource->data = 0;
+        resource->data_size = 0;
+        resource->loader_id = INVALID_ID;
+    } else if (resource->data) {
         cfree(resource->data, resource->data_size + 1, MEMORY_TAG_ARRAY);
         resource->data = 0;
         resource->data_size = 0;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "math/math_types.h"
+#include "platform/filesystem.h"
 
 
 typedef enum resource_type {
@@ -18,6 +19,8 @@ typedef struct resource {
     char* full_path;
     u64 data_size;
     void* data; // resource loader will allocate and fill this
+    // valid when data is a read-only view into a mapped file instead of an owned copy
+    file_mapping mapping;
 } resource;
 
 typedef struct image_resource_data {
@@ -83,6 +86,10 @@ typedef struct geometry {
 
     char name[GEOMETRY_MAXIMUM_NAME_LENGTH];
 
+    // bounds of the vertices in model space, kept once the vertices are uploaded
+    extents_3d extents;
+    sphere_3d bounding_sphere;
+
     material* material;
 } geometry;
 
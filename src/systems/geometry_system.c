@@ -1,8 +1,11 @@
+#define LOG_CHANNEL LOG_CHANNEL_RESOURCES
+
 #include "geometry_system.h"
 
 #include "core/cmemory.h"
 #include "core/cstring.h"
 #include "core/logger.h"
+#include "math/bounds.h"
 #include "systems/material_system.h"
 #include "renderer/renderer_frontend.h"
 
@@ -105,9 +108,6 @@ geometry* geometry_system_acquire_from_config(geometry_config config, b8 auto_re
 void geometry_system_release(geometry* geometry) {
     if (geometry && geometry->id != INVALID_ID) {
         geometry_reference* ref = &state_ptr->registered_geometries[geometry->id];
-
-        // take a copy of the id;
-        u32 id = geometry->id;
         if (ref->geometry.id == geometry->id) {
             if (ref->reference_count > 0) {
                 ref->reference_count--;
@@ -280,6 +280,7 @@ b8 create_default_geometry(geometry_system_state* state) {
         LOG_FATAL("Failed to create default geometry");
         return false;
     }
+    bounds_from_vertices(verts, 4, &state->default_geometry.extents, &state->default_geometry.bounding_sphere);
 
     state->default_geometry.material = material_system_get_default_material();
 
@@ -298,6 +299,7 @@ b8 create_geometry(geometry_system_state* state, geometry_config config, geometr
 
         return false;
     }
+    bounds_from_vertices(config.vertices, config.vertex_count, &g->extents, &g->bounding_sphere);
 
     // Acquire the material
     if (string_length(config.material_name) > 0) {
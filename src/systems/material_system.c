@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RESOURCES
+
 #include "material_system.h"
 
 #include "core/logger.h"
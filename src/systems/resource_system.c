@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RESOURCES
+
 #include "resource_system.h"
 
 #include "core/logger.h"
@@ -149,6 +151,7 @@ b8 load(const char* name, resource_loader* loader, resource* out_resource) {
     }
 
     out_resource->loader_id = loader->id;
+    out_resource->mapping.is_valid = false;
     return loader->load(loader, name, out_resource);
 }
 
@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_RESOURCES
+
 #include "texture_system.h"
 
 #include "core/logger.h"
@@ -131,10 +133,10 @@ texture* texture_system_acquire(const char *name, b8 auto_release) {
 
             // also use the handle as the texture id.
             t->id = ref.handle;
-            LOG_TRACE("Texture '%s' does not yet exist. Create and ref_count is now %i", name, ref.reference_count);
+            LOG_TRACE_BIN("Texture '%s' does not yet exist. Create and ref_count is now %llu", name, ref.reference_count);
 
         } else {
-            LOG_TRACE("Texture '%s' already exists, ref_count increased to %i", name, ref.reference_count);
+            LOG_TRACE_BIN("Texture '%s' already exists, ref_count increased to %llu", name, ref.reference_count);
         }
 
         hashtable_set(&state_ptr->registered_texture_table, name, &ref);
@@ -172,9 +174,9 @@ void texture_system_release(const char *name) {
             // Reset the reference
             ref.handle = INVALID_ID;
             ref.auto_release = false;
-            LOG_TRACE("Released texture '%s' and ref_count is now %i", name_copy, ref.reference_count);
+            LOG_TRACE_BIN("Released texture '%s' and ref_count is now %llu", name_copy, ref.reference_count);
         } else {
-            LOG_TRACE("Released texture '%s', now ref_count is %i", name_copy, ref.reference_count);
+            LOG_TRACE_BIN("Released texture '%s', now ref_count is %llu", name_copy, ref.reference_count);
         }
 
         hashtable_set(&state_ptr->registered_texture_table, name_copy, &ref);
@@ -0,0 +1,64 @@
+#include "clock_tests.h"
+
+#include <core/clock.h>
+#include <platform/platform.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+// Test the tick conversions against the calibrated frequency
+u8 test_clock_tick_conversions() {
+    // the tests don't initialize the platform, which calibrates the ticks
+    platform_ticks_calibrate();
+    u64 frequency = platform_get_tick_frequency();
+    expect_to_be_true(frequency >= 1000000);
+    if (!platform_ticks_use_tsc()) {
+        // the fallback ticks are CLOCK_MONOTONIC nanoseconds
+        expect_should_be(1000000000ull, frequency);
+    }
+
+    // one second of ticks, within the rounding of the fixed point factor
+    u64 ns = platform_ticks_to_ns(frequency);
+    expect_to_be_true(ns > 999999000ull && ns < 1000001000ull);
+    expect_float_to_be(1.0, platform_ticks_to_seconds(frequency));
+    // an hour doesn't overflow
+    u64 hour_ns = platform_ticks_to_ns(frequency * 3600);
+    expect_to_be_true(hour_ns / 1000000000ull >= 3599 && hour_ns / 1000000000ull <= 3600);
+
+    u64 first = platform_get_ticks();
+    u64 second = platform_get_ticks_ordered();
+    expect_to_be_true(second >= first);
+    return true;
+}
+
+// Test that a clock in tick mode measures the same time as the absolute time
+u8 test_clock_tick_mode() {
+    clock c;
+    clock_start_ticks(&c);
+    expect_to_be_true(c.use_ticks);
+    f64 start = platform_get_absolute_time();
+    platform_sleep_ms(20);
+    clock_update(&c);
+    f64 elapsed = platform_get_absolute_time() - start;
+
+    expect_to_be_true(c.elasped_time >= 0.019);
+    // the clock was updated before the absolute time was read again
+    expect_to_be_true(c.elasped_time <= elapsed + 0.001);
+    u64 ns = clock_elapsed_ns(&c);
+    expect_to_be_true(ns >= 19000000ull && ns <= (u64)(elapsed * 1e9) + 1000000ull);
+
+    // a stopped clock keeps its last value
+    clock_stop(&c);
+    clock_update(&c);
+    expect_should_be(ns, clock_elapsed_ns(&c));
+
+    // starting in seconds mode leaves the tick mode
+    clock_start(&c);
+    expect_to_be_false(c.use_ticks);
+    return true;
+}
+
+// Register all clock tests
+void clock_register_tests() {
+    test_manager_register_test(test_clock_tick_conversions, "Clock tick conversions");
+    test_manager_register_test(test_clock_tick_mode, "Clock integer tick mode");
+}
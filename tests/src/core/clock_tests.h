@@ -0,0 +1,3 @@
+#pragma once
+
+void clock_register_tests();
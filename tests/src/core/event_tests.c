@@ -0,0 +1,318 @@
+#include "event_tests.h"
+
+#include <core/event.h>
+#include "../test_manager.h"
+#include "../expect.h"
+#include <core/logger.h>
+#include <core/cmemory.h>
+#include <core/cstring.h>
+
+static u64 event_state_size;
+static void* event_state;
+
+// records the order in which the listeners were called
+static u32 call_order[64];
+static u32 call_count;
+
+static void setup_event_system() {
+    initialize_event(&event_state_size, 0);
+    event_state = callocate(event_state_size, MEMORY_TAG_APPLICATION);
+    initialize_event(&event_state_size, event_state);
+    call_count = 0;
+}
+
+static void teardown_event_system() {
+    event_shutdown();
+    cfree(event_state, event_state_size, MEMORY_TAG_APPLICATION);
+    event_state = 0;
+}
+
+static b8 on_record(u16 code, void* sender, void* listener_inst, event_context data) {
+    call_order[call_count++] = *(u32*)listener_inst;
+    return false;
+}
+
+static b8 on_record_and_handle(u16 code, void* sender, void* listener_inst, event_context data) {
+    call_order[call_count++] = *(u32*)listener_inst;
+    return true;
+}
+
+// Test registering and firing a single listener
+u8 test_event_register_fire() {
+    setup_event_system();
+
+    u32 id = 1;
+    expect_to_be_true(event_register(EVENT_CODE_DEBUG0, &id, on_record));
+    // duplicates are refused
+    expect_to_be_false(event_register(EVENT_CODE_DEBUG0, &id, on_record));
+
+    event_context context = {};
+    expect_to_be_false(event_fire(EVENT_CODE_DEBUG0, 0, context));
+    expect_should_be(1, call_count);
+    expect_should_be(1, call_order[0]);
+
+    // nothing registered on this code
+    expect_to_be_false(event_fire(EVENT_CODE_DEBUG1, 0, context));
+    expect_should_be(1, call_count);
+
+    teardown_event_system();
+    return true;
+}
+
+// Test that listeners are called by descending priority, then registration order
+u8 test_event_priority_order() {
+    setup_event_system();
+
+    u32 ids[4] = {0, 1, 2, 3};
+    event_register(EVENT_CODE_DEBUG0, &ids[0], on_record);
+    event_register_priority(EVENT_CODE_DEBUG0, &ids[1], on_record, EVENT_PRIORITY_LOW);
+    event_register_priority(EVENT_CODE_DEBUG0, &ids[2], on_record, EVENT_PRIORITY_HIGH);
+    event_register(EVENT_CODE_DEBUG0, &ids[3], on_record);
+
+    event_context context = {};
+    event_fire(EVENT_CODE_DEBUG0, 0, context);
+
+    expect_should_be(4, call_count);
+    expect_should_be(2, call_order[0]);
+    expect_should_be(0, call_order[1]);
+    expect_should_be(3, call_order[2]);
+    expect_should_be(1, call_order[3]);
+
+    teardown_event_system();
+    return true;
+}
+
+// Test that a handled event is not propagated to lower priority listeners
+u8 test_event_handled_stops_propagation() {
+    setup_event_system();
+
+    u32 ids[2] = {0, 1};
+    event_register(EVENT_CODE_DEBUG0, &ids[0], on_record);
+    event_register_priority(EVENT_CODE_DEBUG0, &ids[1], on_record_and_handle, EVENT_PRIORITY_HIGH);
+
+    event_context context = {};
+    expect_to_be_true(event_fire(EVENT_CODE_DEBUG0, 0, context));
+    expect_should_be(1, call_count);
+    expect_should_be(1, call_order[0]);
+
+    teardown_event_system();
+    return true;
+}
+
+// Test unregistering keeps the remaining listeners in order
+u8 test_event_unregister() {
+    setup_event_system();
+
+    u32 ids[3] = {0, 1, 2};
+    event_register(EVENT_CODE_DEBUG0, &ids[0], on_record);
+    event_register(EVENT_CODE_DEBUG0, &ids[1], on_record);
+    event_register(EVENT_CODE_DEBUG0, &ids[2], on_record);
+
+    expect_to_be_true(event_unregister(EVENT_CODE_DEBUG0, &ids[1], on_record));
+    expect_to_be_false(event_unregister(EVENT_CODE_DEBUG0, &ids[1], on_record));
+    expect_to_be_false(event_unregister(EVENT_CODE_DEBUG1, &ids[0], on_record));
+
+    event_context context = {};
+    event_fire(EVENT_CODE_DEBUG0, 0, context);
+    expect_should_be(2, call_count);
+    expect_should_be(0, call_order[0]);
+    expect_should_be(2, call_order[1]);
+
+    teardown_event_system();
+    return true;
+}
+
+// Test that sparse, large event codes can be used side by side
+u8 test_event_sparse_codes() {
+    setup_event_system();
+
+    u32 ids[3] = {0, 1, 2};
+    u16 codes[3] = {EVENT_CODE_APPLICATION_QUIT, 0x1000, 0xFFFE};
+    for (u32 i = 0; i < 3; ++i) {
+        expect_to_be_true(event_register(codes[i], &ids[i], on_record));
+    }
+
+    event_context context = {};
+    for (u32 i = 0; i < 3; ++i) {
+        event_fire(codes[2 - i], 0, context);
+    }
+    expect_should_be(3, call_count);
+    expect_should_be(2, call_order[0]);
+    expect_should_be(1, call_order[1]);
+    expect_should_be(0, call_order[2]);
+
+    teardown_event_system();
+    return true;
+}
+
+static b8 on_check_payload(u16 code, void* sender, void* listener_inst, event_context data) {
+    const char* expected = listener_inst;
+    call_count++;
+    if (data.data.payload.size != string_length(expected) + 1) {
+        return false;
+    }
+    return string_equals(data.data.payload.data, expected);
+}
+
+// Test firing a payload bigger than event_context
+u8 test_event_fire_payload() {
+    setup_event_system();
+
+    const char* path = "assets/textures/a_very_long_texture_name_that_does_not_fit_in_sixteen_bytes.png";
+    event_register(EVENT_CODE_DEBUG0, (void*)path, on_check_payload);
+
+    expect_to_be_true(event_fire_payload(EVENT_CODE_DEBUG0, 0, path, string_length(path) + 1));
+    expect_should_be(1, call_count);
+
+    // nobody listens to this code, nothing is fired
+    expect_to_be_false(event_fire_payload(EVENT_CODE_DEBUG1, 0, path, string_length(path) + 1));
+
+    event_frame_reset();
+
+    teardown_event_system();
+    return true;
+}
+
+// Test that the payload arena refuses payloads once full, until the frame is reset
+u8 test_event_payload_arena_reset() {
+    setup_event_system();
+
+    u32 id = 0;
+    event_register(EVENT_CODE_DEBUG0, &id, on_record);
+
+    // larger than a quarter of the 64 KiB arena: the fourth payload of the frame is dropped
+    u64 size = 17 * 1024;
+    u8* payload = callocate(size, MEMORY_TAG_ARRAY);
+    for (u32 i = 0; i < 3; ++i) {
+        event_fire_payload(EVENT_CODE_DEBUG0, 0, payload, size);
+    }
+    expect_should_be(3, call_count);
+    event_fire_payload(EVENT_CODE_DEBUG0, 0, payload, size);
+    expect_should_be(3, call_count);
+
+    event_frame_reset();
+    event_fire_payload(EVENT_CODE_DEBUG0, 0, payload, size);
+    expect_should_be(4, call_count);
+
+    cfree(payload, size, MEMORY_TAG_ARRAY);
+    teardown_event_system();
+    return true;
+}
+
+static u32 late_ids[20];
+
+// registers enough listeners on its own code to move the listener arrays
+static b8 on_register_more(u16 code, void* sender, void* listener_inst, event_context data) {
+    call_order[call_count++] = *(u32*)listener_inst;
+    if (call_count == 1) {
+        for (u32 i = 0; i < 20; ++i) {
+            late_ids[i] = 100 + i;
+            event_register_priority(code, &late_ids[i], on_record, EVENT_PRIORITY_LOW);
+        }
+    }
+    return false;
+}
+
+// Test a listener registering other listeners on the code being fired
+u8 test_event_register_during_fire() {
+    setup_event_system();
+
+    u32 ids[2] = {0, 1};
+    event_register(EVENT_CODE_DEBUG0, &ids[0], on_register_more);
+    event_register(EVENT_CODE_DEBUG0, &ids[1], on_record);
+
+    event_context context = {};
+    event_fire(EVENT_CODE_DEBUG0, 0, context);
+    // the new listeners have a lower priority, they run in the same fire
+    expect_should_be(22, call_count);
+    expect_should_be(0, call_order[0]);
+    expect_should_be(1, call_order[1]);
+    expect_should_be(100, call_order[2]);
+    expect_should_be(119, call_order[21]);
+
+    call_count = 0;
+    event_fire(EVENT_CODE_DEBUG0, 0, context);
+    expect_should_be(22, call_count);
+
+    teardown_event_system();
+    return true;
+}
+
+// Test that codes whose listeners are gone give their place to new codes
+u8 test_event_code_entries_reused() {
+    setup_event_system();
+
+    u32 id = 0;
+    for (u32 code = 0; code < 256; ++code) {
+        expect_to_be_true(event_register(0x2000 + code, &id, on_record));
+    }
+    // the table is full
+    expect_to_be_false(event_register(0x3000, &id, on_record));
+
+    expect_to_be_true(event_unregister(0x2005, &id, on_record));
+    expect_to_be_true(event_register(0x3000, &id, on_record));
+
+    event_context context = {};
+    event_fire(0x3000, 0, context);
+    event_fire(0x2005, 0, context);
+    event_fire(0x2006, 0, context);
+    expect_should_be(2, call_count);
+
+    teardown_event_system();
+    return true;
+}
+
+#ifdef cEVENT_PROFILING_ENABLED
+// Test the profiling counters of a code
+u8 test_event_profiling_counters() {
+    setup_event_system();
+
+    u32 ids[2] = {0, 1};
+    event_register(EVENT_CODE_DEBUG0, &ids[0], on_record);
+    event_register_priority(EVENT_CODE_DEBUG0, &ids[1], on_record_and_handle, EVENT_PRIORITY_LOW);
+
+    event_context context = {};
+    for (u32 i = 0; i < 5; ++i) {
+        event_fire(EVENT_CODE_DEBUG0, 0, context);
+    }
+    // fires without listeners don't take an entry
+    event_fire(EVENT_CODE_DEBUG1, 0, context);
+
+    event_code_stats stats;
+    expect_to_be_true(event_profiling_get_code_stats(EVENT_CODE_DEBUG0, &stats));
+    expect_should_be(5, stats.fire_count);
+    expect_should_be(5, stats.handled_count);
+    expect_should_be(2, stats.listener_count);
+
+    expect_to_be_false(event_profiling_get_code_stats(EVENT_CODE_DEBUG1, &stats));
+    // so firing many codes nobody listens to doesn't fill the code table
+    for (u32 code = 0; code < 300; ++code) {
+        event_fire(0x4000 + code, 0, context);
+    }
+    u32 id = 2;
+    expect_to_be_true(event_register(EVENT_CODE_DEBUG1, &id, on_record));
+
+    event_profiling_reset();
+    expect_to_be_true(event_profiling_get_code_stats(EVENT_CODE_DEBUG0, &stats));
+    expect_should_be(0, stats.fire_count);
+
+    teardown_event_system();
+    return true;
+}
+#endif
+
+// Register all event tests
+void event_register_tests() {
+    test_manager_register_test(test_event_register_fire, "Event register and fire");
+    test_manager_register_test(test_event_priority_order, "Event dispatch priority order");
+    test_manager_register_test(test_event_handled_stops_propagation, "Event handled stops propagation");
+    test_manager_register_test(test_event_unregister, "Event unregister");
+    test_manager_register_test(test_event_sparse_codes, "Event sparse code registry");
+    test_manager_register_test(test_event_fire_payload, "Event fire with payload");
+    test_manager_register_test(test_event_payload_arena_reset, "Event payload arena reset");
+    test_manager_register_test(test_event_register_during_fire, "Event register during fire");
+    test_manager_register_test(test_event_code_entries_reused, "Event code entries reused");
+#ifdef cEVENT_PROFILING_ENABLED
+    test_manager_register_test(test_event_profiling_counters, "Event profiling counters");
+#endif
+}
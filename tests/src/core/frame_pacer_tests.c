@@ -0,0 +1,53 @@
+#include "frame_pacer_tests.h"
+
+#include <core/frame_pacer.h>
+#include <platform/platform.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+// Test that the frames are paced to the target
+u8 test_frame_pacer_target() {
+    frame_pacer pacer;
+    frame_pacer_create(200, &pacer);
+
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < 20; ++i) {
+        frame_pacer_wait(&pacer);
+    }
+    f64 elapsed = platform_get_absolute_time() - start;
+
+    // 20 frames of 5 ms at least. A busy machine can take any longer, so there is no upper bound
+    expect_to_be_true(elapsed >= 0.0995);
+
+    f64 average, jitter, min, max;
+    expect_to_be_true(frame_pacer_get_stats(&pacer, &average, &jitter, &min, &max));
+    expect_should_be(20, pacer.frame_count);
+    expect_to_be_true(average > 0.0049);
+    expect_to_be_true(min <= average && average <= max);
+    expect_to_be_true(jitter >= 0.0 && jitter <= max - min);
+
+    frame_pacer_report(&pacer);
+    expect_to_be_false(frame_pacer_get_stats(&pacer, &average, &jitter, &min, &max));
+    return true;
+}
+
+// Test that an uncapped pacer doesn't wait
+u8 test_frame_pacer_uncapped() {
+    frame_pacer pacer;
+    frame_pacer_create(0, &pacer);
+
+    f64 start = platform_get_absolute_time();
+    for (u32 i = 0; i < 1000; ++i) {
+        frame_pacer_wait(&pacer);
+    }
+    // a wide bound for a busy machine, 1000 paced frames at 60 fps would take 16 s
+    expect_to_be_true(platform_get_absolute_time() - start < 1.0);
+    expect_should_be(0, pacer.missed_count);
+    return true;
+}
+
+// Register all frame pacer tests
+void frame_pacer_register_tests() {
+    test_manager_register_test(test_frame_pacer_target, "Frame pacer paces to the target");
+    test_manager_register_test(test_frame_pacer_uncapped, "Frame pacer uncapped does not wait");
+}
@@ -0,0 +1,143 @@
+#include "input_tests.h"
+
+#include <core/input.h>
+#include "../test_manager.h"
+#include "../expect.h"
+#include <core/cmemory.h>
+#include <platform/platform.h>
+
+#include <stdio.h>
+
+static u64 input_state_size;
+static void* input_state;
+
+static void setup_input_system() {
+    initialize_input(&input_state_size, 0);
+    input_state = callocate(input_state_size, MEMORY_TAG_APPLICATION);
+    initialize_input(&input_state_size, input_state);
+}
+
+static void teardown_input_system() {
+    shutdown_input();
+    cfree(input_state, input_state_size, MEMORY_TAG_APPLICATION);
+    input_state = 0;
+}
+
+// Test that presses shorter than a frame are still seen
+u8 test_input_presses_within_frame() {
+    setup_input_system();
+
+    input_process_key(KEY_T, true, 1.0);
+    input_process_key(KEY_T, false, 1.001);
+    input_process_key(KEY_T, true, 1.002);
+    input_process_key(KEY_T, false, 1.003);
+    input_process_button(BUTTON_LEFT, true, 1.004);
+
+    // the snapshot only shows the final state
+    expect_to_be_true(input_is_key_up(KEY_T));
+    expect_should_be(2, input_key_press_count(KEY_T));
+    expect_should_be(1, input_button_press_count(BUTTON_LEFT));
+    expect_should_be(0, input_key_press_count(KEY_A));
+
+    input_event events[8];
+    expect_should_be(5, input_get_frame_events(events, 8));
+    expect_should_be(INPUT_EVENT_KEY, events[0].type);
+    expect_float_to_be(1.002, events[2].timestamp);
+    expect_should_be(INPUT_EVENT_BUTTON, events[4].type);
+
+    update_input(0.016);
+    expect_should_be(0, input_key_press_count(KEY_T));
+    expect_should_be(0, input_frame_event_count());
+    expect_to_be_true(input_was_button_down(BUTTON_LEFT));
+
+    teardown_input_system();
+    return true;
+}
+
+// Test that the previous state follows the current state across frames
+u8 test_input_previous_state() {
+    setup_input_system();
+
+    input_process_key(KEY_A, true, 0.0);
+    input_process_mouse_move(10, 20, 0.0);
+    expect_to_be_true(input_was_key_up(KEY_A));
+    update_input(0.016);
+    expect_to_be_true(input_was_key_down(KEY_A));
+
+    i32 x, y;
+    input_get_previous_mouse_pos(&x, &y);
+    expect_should_be(10, x);
+    expect_should_be(20, y);
+
+    // more events than the ring holds: the previous state is still right
+    for (i16 i = 0; i < INPUT_EVENT_BUFFER_SIZE + 10; ++i) {
+        input_process_mouse_move(i, i + 1, 0.1);
+    }
+    input_process_key(KEY_A, false, 0.2);
+    expect_should_be(INPUT_EVENT_BUFFER_SIZE, input_frame_event_count());
+    update_input(0.016);
+    expect_to_be_true(input_was_key_up(KEY_A));
+    input_get_previous_mouse_pos(&x, &y);
+    expect_should_be(INPUT_EVENT_BUFFER_SIZE + 9, x);
+
+    teardown_input_system();
+    return true;
+}
+
+// Test that a recording replays the same events and frame times
+u8 test_input_record_replay() {
+    const char* path = "input_test.crec";
+    setup_input_system();
+    expect_to_be_true(input_recording_start(path));
+
+    input_process_key(KEY_W, true, platform_get_absolute_time());
+    input_process_mouse_move(100, 50, platform_get_absolute_time());
+    update_input(0.016);
+    input_process_key(KEY_W, false, platform_get_absolute_time());
+    input_process_mouse_wheel(-1, platform_get_absolute_time());
+    update_input(0.033);
+    update_input(0.020);
+    input_recording_stop();
+    teardown_input_system();
+
+    setup_input_system();
+    expect_to_be_true(input_replay_start(path));
+    expect_to_be_true(input_is_replaying());
+
+    f64 delta = 0;
+    expect_to_be_true(input_replay_next_frame(&delta));
+    expect_float_to_be(0.016, delta);
+    // live input is ignored while replaying
+    input_process_key(KEY_S, true, 0.0);
+    expect_to_be_true(input_is_key_up(KEY_S));
+    expect_to_be_true(input_is_key_down(KEY_W));
+    i32 x, y;
+    input_get_mouse_pos(&x, &y);
+    expect_should_be(100, x);
+    expect_should_be(50, y);
+    update_input(delta);
+
+    expect_to_be_true(input_replay_next_frame(&delta));
+    expect_float_to_be(0.033, delta);
+    expect_to_be_true(input_is_key_up(KEY_W));
+    expect_should_be(2, input_frame_event_count());
+    update_input(delta);
+
+    expect_to_be_true(input_replay_next_frame(&delta));
+    expect_should_be(0, input_frame_event_count());
+    update_input(delta);
+
+    expect_to_be_false(input_replay_next_frame(&delta));
+    expect_to_be_false(input_is_replaying());
+
+    teardown_input_system();
+    remove(path);
+    return true;
+}
+
+// Register all input tests
+void input_register_tests() {
+    test_manager_register_test(test_input_presses_within_frame, "Input presses within a frame are counted");
+    test_manager_register_test(test_input_previous_state, "Input previous state follows the event ring");
+    test_manager_register_test(test_input_record_replay, "Input recording replays events and frame times");
+}
@@ -0,0 +1,273 @@
+#include "logger_tests.h"
+
+#include <core/logger.h>
+#include <core/logger_binary.h>
+#include <core/cmemory.h>
+#include <core/cstring.h>
+#include <platform/filesystem.h>
+
+#include <stdio.h>
+#include <string.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+// Test that the async writer keeps up when the ring wraps many times
+u8 test_logger_async_ring_wrap() {
+    // a tiny ring forces the producers to wait for the writer
+    expect_to_be_true(logging_start_async(16));
+    // already running
+    expect_to_be_false(logging_start_async(16));
+
+    for (u32 i = 0; i < 200; ++i) {
+        LOG_TRACE("async logger test message %u", i);
+    }
+    logging_flush();
+    logging_stop_async();
+
+    return true;
+}
+
+// Test that the ring size is validated
+u8 test_logger_async_invalid_size() {
+    expect_to_be_false(logging_start_async(100));
+    return true;
+}
+
+// Test that a message too long for a ring record is written whole, in order, to the log file
+u8 test_logger_async_long_message() {
+    if (!LOG_ENABLED(LOG_LEVEL_INFO)) {
+        return BYPASS;
+    }
+
+    static char long_text[2001];
+    for (u32 i = 0; i < 2000; ++i) {
+        long_text[i] = 'a' + i % 26;
+    }
+    static char expected[2200];
+    string_format(expected, "[INFO] long message start\n[INFO] %s\n[INFO] long message end\n", long_text);
+
+    expect_to_be_true(logging_start_async(16));
+    LOG_INFO("long message start");
+    LOG_INFO("%s", long_text);
+    LOG_INFO("long message end");
+    logging_stop_async();
+
+    file_handle handle;
+    expect_to_be_true(filesystem_open("console.log", FILE_MODE_READ, true, &handle));
+    u64 size = 0;
+    expect_to_be_true(filesystem_size(&handle, &size));
+    char* text = callocate(size + 1, MEMORY_TAG_STRING);
+    u64 read = 0;
+    expect_to_be_true(filesystem_read_all_bytes(&handle, (u8*)text, &read));
+    filesystem_close(&handle);
+    b8 found = strstr(text, expected) != 0;
+    cfree(text, size + 1, MEMORY_TAG_STRING);
+    expect_to_be_true(found);
+
+    return true;
+}
+
+// Collects the decoded lines of a binary log
+typedef struct decoded_lines {
+    u32 count;
+    log_level levels[8];
+    char text[8][256];
+} decoded_lines;
+
+static void collect_line(log_level level, f64 time, const char* text, u64 length, void* user_data) {
+    decoded_lines* lines = user_data;
+    if (lines->count < 8) {
+        lines->levels[lines->count] = level;
+        string_ncopy(lines->text[lines->count], text, 255);
+        lines->count++;
+    }
+}
+
+static u64 encode_message(const log_binary_site* site, u8* dest, u64 capacity, ...) {
+    va_list args;
+    va_start(args, capacity);
+    u64 size = log_binary_encode_message(site, 1.5, args, dest, capacity);
+    va_end(args);
+    return size;
+}
+
+// Test that the argument types are found from the format string
+u8 test_logger_binary_parse_format() {
+    u8 types[LOG_BINARY_MAX_ARGS];
+    u8 count = 0;
+
+    expect_to_be_true(log_binary_parse_format("a %d %llu %5.2f %s %p %c %% %zu", types, &count));
+    expect_should_be(7, count);
+    expect_should_be(LOG_BINARY_ARG_I32, types[0]);
+    expect_should_be(LOG_BINARY_ARG_I64, types[1]);
+    expect_should_be(LOG_BINARY_ARG_F64, types[2]);
+    expect_should_be(LOG_BINARY_ARG_STRING, types[3]);
+    expect_should_be(LOG_BINARY_ARG_POINTER, types[4]);
+    expect_should_be(LOG_BINARY_ARG_I32, types[5]);
+    expect_should_be(LOG_BINARY_ARG_I64, types[6]);
+
+    expect_to_be_true(log_binary_parse_format("no arguments", types, &count));
+    expect_should_be(0, count);
+
+    // can't be deferred
+    expect_to_be_false(log_binary_parse_format("%*d", types, &count));
+    expect_to_be_false(log_binary_parse_format("%Lf", types, &count));
+    expect_to_be_false(log_binary_parse_format("%n", types, &count));
+    expect_to_be_false(log_binary_parse_format("unterminated %", types, &count));
+
+    return true;
+}
+
+// Test that an encoded message decodes back to the text printf would produce
+u8 test_logger_binary_round_trip() {
+    log_binary_site site = {"Texture '%s' ref_count %i, %.2f%% at %llu", "texture_system.c", 42, LOG_LEVEL_TRACE};
+    site.id = 3;
+    expect_to_be_true(log_binary_parse_format(site.format, site.arg_types, &site.arg_count));
+
+    u8 data[1024];
+    u64 size = log_binary_encode_header(data);
+    size += log_binary_encode_site(&site, data + size, sizeof(data) - size);
+    size += encode_message(&site, data + size, sizeof(data) - size, "cobblestone", 2, 87.5, 123456789012ull);
+    size += encode_message(&site, data + size, sizeof(data) - size, (const char*)0, -1, 0.0, 0ull);
+
+    decoded_lines lines = {0};
+    expect_to_be_true(log_binary_decode(data, size, collect_line, &lines));
+    expect_should_be(2, lines.count);
+    expect_should_be(LOG_LEVEL_TRACE, lines.levels[0]);
+    expect_to_be_true(string_equals(lines.text[0], "Texture 'cobblestone' ref_count 2, 87.50% at 123456789012"));
+    expect_to_be_true(string_equals(lines.text[1], "Texture '(null)' ref_count -1, 0.00% at 0"));
+
+    // truncated data decodes the complete records and reports the error
+    czero_memory(&lines, sizeof(lines));
+    expect_to_be_false(log_binary_decode(data, size - 3, collect_line, &lines));
+    expect_should_be(1, lines.count);
+
+    return true;
+}
+
+// Test that a 64 bit argument keeps its width, and the arguments after it their values
+u8 test_logger_binary_wide_argument() {
+    log_binary_site site = {"ref_count %llu of '%s', %i left", "texture_system.c", 7, LOG_LEVEL_TRACE};
+    site.id = 1;
+    expect_to_be_true(log_binary_parse_format(site.format, site.arg_types, &site.arg_count));
+    expect_should_be(LOG_BINARY_ARG_I64, site.arg_types[0]);
+
+    u8 data[256];
+    u64 size = log_binary_encode_header(data);
+    size += log_binary_encode_site(&site, data + size, sizeof(data) - size);
+    size += encode_message(&site, data + size, sizeof(data) - size, 0x100000002ull, "cobblestone", -3);
+
+    decoded_lines lines = {0};
+    expect_to_be_true(log_binary_decode(data, size, collect_line, &lines));
+    expect_should_be(1, lines.count);
+    expect_to_be_true(string_equals(lines.text[0], "ref_count 4294967298 of 'cobblestone', -3 left"));
+
+    return true;
+}
+
+// Test the LOG_*_BIN macros through a binary log file
+u8 test_logger_binary_file() {
+    if (!LOG_ENABLED(LOG_LEVEL_TRACE)) {
+        // trace statements are compiled out
+        return BYPASS;
+    }
+
+    const char* path = "logger_binary_test.clog";
+    expect_to_be_true(logging_binary_open(path));
+    for (i32 i = 0; i < 3; ++i) {
+        LOG_TRACE_BIN("binary message %i of %s", i, "test");
+    }
+    logging_binary_close();
+
+    // the sites are written again in a new file, this time through the async ring
+    expect_to_be_true(logging_start_async(16));
+    expect_to_be_true(logging_binary_open(path));
+    for (i32 i = 0; i < 2; ++i) {
+        LOG_TRACE_BIN("binary message %i of %s", i, "test");
+    }
+    logging_binary_close();
+    logging_stop_async();
+
+    file_handle handle;
+    expect_to_be_true(filesystem_open(path, FILE_MODE_READ, true, &handle));
+    u8 data[1024];
+    u64 size = 0;
+    expect_to_be_true(filesystem_read_all_bytes(&handle, data, &size));
+    filesystem_close(&handle);
+    remove(path);
+
+    decoded_lines lines = {0};
+    expect_to_be_true(log_binary_decode(data, size, collect_line, &lines));
+    expect_should_be(2, lines.count);
+    expect_to_be_true(string_equals(lines.text[1], "binary message 1 of test"));
+
+    return true;
+}
+
+// Test that a rate-limited site writes one call every n and counts the others
+u8 test_logger_limit_every_n() {
+    // sites are linked in the report list, they must outlive the test
+    static log_limit_site site = {"every n %d", __FILE__, __LINE__};
+    u32 logged = 0;
+    for (u32 i = 0; i < 10; ++i) {
+        logged += log_limit_should_log(&site, 4);
+    }
+    // calls 0, 4 and 8
+    expect_should_be(3, logged);
+    expect_should_be(10, site.count);
+
+    static log_limit_site once = {"once", __FILE__, __LINE__};
+    logged = 0;
+    for (u32 i = 0; i < 5; ++i) {
+        logged += log_limit_should_log(&once, 0);
+    }
+    expect_should_be(1, logged);
+
+    // the report covers the suppressed calls once
+    logging_report_suppressed();
+    expect_should_be(7, site.reported);
+    expect_should_be(4, once.reported);
+    log_limit_should_log(&once, 0);
+    logging_report_suppressed();
+    expect_should_be(5, once.reported);
+
+    return true;
+}
+
+static i32 count_evaluation(i32* counter) {
+    return ++*counter;
+}
+
+// Test that a disabled level doesn't evaluate its arguments
+u8 test_logger_channel_level() {
+    i32 evaluated = 0;
+
+    logging_set_channel_level(LOG_CHANNEL, LOG_LEVEL_WARN);
+    LOG_TRACE("not written %d", count_evaluation(&evaluated));
+    LOG_DEBUG("not written %d", count_evaluation(&evaluated));
+    LOG_INFO("not written %d", count_evaluation(&evaluated));
+    LOG_TRACE_BIN("not written %d", count_evaluation(&evaluated));
+    expect_should_be(0, evaluated);
+
+    // other channels keep their own level
+    expect_should_be(LOG_LEVEL_TRACE, log_channel_levels[LOG_CHANNEL_RENDERER]);
+
+    logging_set_level(LOG_LEVEL_TRACE);
+    LOG_WARN("written %d", count_evaluation(&evaluated));
+    expect_should_be(LOG_LEVEL_MIN >= LOG_LEVEL_WARN ? 1 : 0, evaluated);
+
+    return true;
+}
+
+// Register all logger tests
+void logger_register_tests() {
+    test_manager_register_test(test_logger_async_ring_wrap, "Logger async ring wrap and flush");
+    test_manager_register_test(test_logger_async_invalid_size, "Logger async ring size validation");
+    test_manager_register_test(test_logger_async_long_message, "Logger async message longer than a record");
+    test_manager_register_test(test_logger_binary_parse_format, "Logger binary format argument types");
+    test_manager_register_test(test_logger_binary_round_trip, "Logger binary encode/decode round trip");
+    test_manager_register_test(test_logger_binary_wide_argument, "Logger binary 64 bit argument");
+    test_manager_register_test(test_logger_channel_level, "Logger channel level skips argument evaluation");
+    test_manager_register_test(test_logger_limit_every_n, "Logger rate-limited sites and suppressed report");
+    test_manager_register_test(test_logger_binary_file, "Logger binary log file through LOG_TRACE_BIN");
+}
@@ -0,0 +1,113 @@
+#include "text_reader_tests.h"
+
+#include <core/text_reader.h>
+#include <core/cstring.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <stdio.h>
+
+#define TEST_FILE_PATH "text_reader_test.txt"
+
+static b8 write_test_file(const char* text) {
+    file_handle file;
+    if (!filesystem_open(TEST_FILE_PATH, FILE_MODE_WRITE, true, &file)) {
+        return false;
+    }
+    u64 written = 0;
+    b8 result = filesystem_write(&file, string_length(text), text, &written);
+    filesystem_close(&file);
+    return result;
+}
+
+// Test line splitting of text in memory: line endings, empty lines and a last line without ending
+u8 test_text_reader_lines() {
+    const char* text = "first\r\n\nthird line  \nlast";
+    text_reader reader;
+    text_reader_from_memory(text, string_length(text), &reader);
+
+    text_slice line;
+    expect_to_be_true(text_reader_next_line(&reader, &line));
+    expect_to_be_true(text_slice_equals(line, "first"));
+    expect_to_be_true(text_reader_next_line(&reader, &line));
+    expect_should_be(0, line.length);
+    expect_to_be_true(text_reader_next_line(&reader, &line));
+    expect_to_be_true(text_slice_equals(line, "third line  "));
+    // the slice points into the text, nothing is copied
+    expect_to_be_true(line.data == text + 8);
+    expect_to_be_true(text_reader_next_line(&reader, &line));
+    expect_to_be_true(text_slice_equals(line, "last"));
+    expect_should_be(4, reader.line_number);
+    expect_to_be_false(text_reader_next_line(&reader, &line));
+    text_reader_close(&reader);
+    return true;
+}
+
+// Test trimming, splitting and tokenizing slices
+u8 test_text_reader_slices() {
+    text_slice line = text_slice_trim(text_slice_from_string("  diffuse_color = 1.0 0.5  0.25 1 \t"));
+    expect_to_be_true(text_slice_equals(line, "diffuse_color = 1.0 0.5  0.25 1"));
+
+    text_slice key;
+    text_slice value;
+    expect_to_be_true(text_slice_split(line, '=', &key, &value));
+    expect_to_be_true(text_slice_equals_case(text_slice_trim(key), "DIFFUSE_COLOR"));
+    expect_to_be_false(text_slice_equals(text_slice_trim(key), "diffuse"));
+    expect_to_be_false(text_slice_split(key, '=', &key, &value));
+
+    const char* expected[] = {"1.0", "0.5", "0.25", "1"};
+    text_slice cursor = value;
+    text_slice token;
+    u32 count = 0;
+    while (text_slice_next_token(&cursor, &token)) {
+        expect_to_be_true(text_slice_equals(token, expected[count]));
+        count++;
+    }
+    expect_should_be(4, count);
+
+    char copy[4];
+    expect_should_be(3, text_slice_copy(text_slice_trim(value), copy, sizeof(copy)));
+    expect_to_be_true(string_equals(copy, "1.0"));
+    return true;
+}
+
+// Test block reads with lines crossing block boundaries and lines longer than a block
+u8 test_text_reader_buffered() {
+    char long_line[100];
+    for (u32 i = 0; i < 99; ++i) {
+        long_line[i] = 'a' + (i % 26);
+    }
+    long_line[99] = 0;
+    char text[512];
+    string_format(text, "one\ntwo\r\n%s\nlast line", long_line);
+    expect_to_be_true(write_test_file(text));
+
+    const char* expected[] = {"one", "two", long_line, "last line"};
+    for (u32 mode = 0; mode < 2; ++mode) {
+        text_reader reader;
+        if (mode == 0) {
+            expect_to_be_true(text_reader_open_buffered(TEST_FILE_PATH, 16, &reader));
+        } else {
+            expect_to_be_true(text_reader_open(TEST_FILE_PATH, &reader));
+            expect_to_be_true(reader.is_mapped);
+        }
+
+        text_slice line;
+        for (u32 i = 0; i < 4; ++i) {
+            expect_to_be_true(text_reader_next_line(&reader, &line));
+            expect_to_be_true(text_slice_equals(line, expected[i]));
+        }
+        expect_to_be_false(text_reader_next_line(&reader, &line));
+        text_reader_close(&reader);
+    }
+
+    remove(TEST_FILE_PATH);
+    return true;
+}
+
+// Register all text reader tests
+void text_reader_register_tests() {
+    test_manager_register_test(test_text_reader_lines, "Text reader splits lines");
+    test_manager_register_test(test_text_reader_slices, "Text reader slices trim, split and tokenize");
+    test_manager_register_test(test_text_reader_buffered, "Text reader reads blocks and mapped files");
+}
@@ -2,6 +2,24 @@
 #include "memory/linear_allocator_tests.h"
 #include "containers/hashtable_tests.h"
 #include "core/cstring_tests.h"
+#include "core/event_tests.h"
+#include "core/logger_tests.h"
+#include "core/input_tests.h"
+#include "core/frame_pacer_tests.h"
+#include "core/text_reader_tests.h"
+#include "core/clock_tests.h"
+#include "math/cmath_tests.h"
+#include "math/transform_batch_tests.h"
+#include "math/fast_trig_tests.h"
+#include "math/crandom_tests.h"
+#include "math/frustum_tests.h"
+#include "math/bounds_tests.h"
+#include "math/bvh_tests.h"
+#include "platform/platform_tests.h"
+#include "platform/filesystem_tests.h"
+#include "platform/async_io_tests.h"
+#include "platform/cpu_info_tests.h"
+#include "resources/loader_tests.h"
 
 #include <core/logger.h>
 
@@ -11,6 +29,24 @@ int main() {
     linear_allocator_register_tests();
     hashtable_register_tests();
     cstring_register_tests();
+    event_register_tests();
+    logger_register_tests();
+    input_register_tests();
+    frame_pacer_register_tests();
+    text_reader_register_tests();
+    clock_register_tests();
+    cmath_register_tests();
+    transform_batch_register_tests();
+    fast_trig_register_tests();
+    crandom_register_tests();
+    frustum_register_tests();
+    bounds_register_tests();
+    bvh_register_tests();
+    platform_register_tests();
+    filesystem_register_tests();
+    async_io_register_tests();
+    cpu_info_register_tests();
+    loader_register_tests();
 
     LOG_INFO("Starting tests...");
 
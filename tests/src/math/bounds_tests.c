@@ -0,0 +1,86 @@
+#include "bounds_tests.h"
+
+#include <math/cmath.h>
+#include <math/bounds.h>
+#include <math/crandom.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+#define BOUNDS_TEST_VERTEX_COUNT 1001
+
+// Test the box and sphere of random vertices against a plain loop, for every tail length
+u8 test_bounds_from_vertices() {
+    static vertex_3d vertices[BOUNDS_TEST_VERTEX_COUNT];
+    random_state state;
+    random_seed(&state, 49);
+    for (u32 i = 0; i < BOUNDS_TEST_VERTEX_COUNT; ++i) {
+        vertices[i].position = (vec3){{random_range_f32(&state, -3.0f, 5.0f),
+                                       random_range_f32(&state, 10.0f, 11.0f),
+                                       random_range_f32(&state, -100.0f, -50.0f)}};
+        // larger than any position, must not leak into the box
+        vertices[i].texcoord = (vec2){{1000.0f, -1000.0f}};
+    }
+
+    u32 counts[] = {1, 2, 3, 5, 8, BOUNDS_TEST_VERTEX_COUNT};
+    for (u32 c = 0; c < 6; ++c) {
+        extents_3d expected = {vertices[0].position, vertices[0].position};
+        for (u32 i = 1; i < counts[c]; ++i) {
+            vec3 p = vertices[i].position;
+            for (u32 k = 0; k < 3; ++k) {
+                expected.min.elements[k] = p.elements[k] < expected.min.elements[k] ? p.elements[k] : expected.min.elements[k];
+                expected.max.elements[k] = p.elements[k] > expected.max.elements[k] ? p.elements[k] : expected.max.elements[k];
+            }
+        }
+
+        extents_3d extents;
+        sphere_3d sphere;
+        bounds_from_vertices(vertices, counts[c], &extents, &sphere);
+        for (u32 k = 0; k < 3; ++k) {
+            expect_should_be(expected.min.elements[k], extents.min.elements[k]);
+            expect_should_be(expected.max.elements[k], extents.max.elements[k]);
+        }
+
+        // every vertex is inside the sphere and at least one is on it
+        f32 farthest = 0.0f;
+        for (u32 i = 0; i < counts[c]; ++i) {
+            f32 distance = vec3_distance(vertices[i].position, sphere.center);
+            expect_to_be_true(distance <= sphere.radius * 1.0001f);
+            farthest = distance > farthest ? distance : farthest;
+        }
+        expect_float_to_be(farthest, sphere.radius);
+    }
+
+    extents_3d empty;
+    sphere_3d empty_sphere;
+    bounds_from_vertices(vertices, 0, &empty, &empty_sphere);
+    expect_float_to_be(0.0f, empty.max.x);
+    expect_float_to_be(0.0f, empty_sphere.radius);
+    return true;
+}
+
+// Test moving a sphere with translations, rotations and scales
+u8 test_bounds_sphere_transform() {
+    sphere_3d sphere = {{{1.0f, 0.0f, 0.0f}}, 2.0f};
+    mat4 model = mat4_multiply(quat_to_mat4(quat_from_axis_angle((vec3){{0.0f, 1.0f, 0.0f}}, HALF_PI, true)),
+                               mat4_translation((vec3){{0.0f, 0.0f, 10.0f}}));
+    sphere_3d moved = bounds_sphere_transform(sphere, model);
+    vec3 expected_center = mat3x4_transform_point(mat3x4_from_mat4(model), sphere.center);
+    expect_float_to_be(expected_center.x, moved.center.x);
+    expect_float_to_be(expected_center.y, moved.center.y);
+    expect_float_to_be(expected_center.z, moved.center.z);
+    expect_float_to_be(2.0f, moved.radius);
+
+    mat4 scale = mat4_identity();
+    scale.data[0] = 0.5f;
+    scale.data[5] = 3.0f;
+    sphere_3d scaled = bounds_sphere_transform(sphere, scale);
+    expect_float_to_be(0.5f, scaled.center.x);
+    expect_float_to_be(6.0f, scaled.radius);
+    return true;
+}
+
+// Register all bounding volume tests
+void bounds_register_tests() {
+    test_manager_register_test(test_bounds_from_vertices, "Bounds of vertices");
+    test_manager_register_test(test_bounds_sphere_transform, "Bounds sphere transform");
+}
@@ -0,0 +1,290 @@
+#include "bvh_tests.h"
+
+#include <math/cmath.h>
+#include <math/bvh.h>
+#include <math/bounds.h>
+#include <math/crandom.h>
+#include <math/frustum.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+#define BVH_TEST_OBJECT_COUNT 1000
+
+static extents_3d boxes[BVH_TEST_OBJECT_COUNT];
+static u32 proxies[BVH_TEST_OBJECT_COUNT];
+static b8 found[BVH_TEST_OBJECT_COUNT];
+static u32 found_count;
+
+static void fill_boxes(u64 seed) {
+    random_state state;
+    random_seed(&state, seed);
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+        vec3 center = {{random_range_f32(&state, -100.0f, 100.0f),
+                        random_range_f32(&state, -20.0f, 20.0f),
+                        random_range_f32(&state, -100.0f, 100.0f)}};
+        vec3 half_extent = {{random_range_f32(&state, 0.1f, 3.0f),
+                             random_range_f32(&state, 0.1f, 3.0f),
+                             random_range_f32(&state, 0.1f, 3.0f)}};
+        boxes[i] = (extents_3d){vec3_subtract(center, half_extent), vec3_add(center, half_extent)};
+    }
+}
+
+static b8 contains(extents_3d outer, extents_3d inner) {
+    for (u32 i = 0; i < 3; ++i) {
+        if (inner.min.elements[i] < outer.min.elements[i] || inner.max.elements[i] > outer.max.elements[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static b8 overlaps(extents_3d a, extents_3d b) {
+    for (u32 i = 0; i < 3; ++i) {
+        if (a.min.elements[i] > b.max.elements[i] || b.min.elements[i] > a.max.elements[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Check the links, boxes and heights of every node under index, return the number of leaves
+static u32 validate_node(const bvh* tree, u32 index, u32 parent, b8* valid) {
+    const bvh_node* node = &tree->nodes[index];
+    if (node->parent != parent) {
+        *valid = false;
+    }
+    if (node->children[0] == INVALID_ID) {
+        if (node->height != 0) {
+            *valid = false;
+        }
+        return 1;
+    }
+    const bvh_node* c0 = &tree->nodes[node->children[0]];
+    const bvh_node* c1 = &tree->nodes[node->children[1]];
+    i32 height = 1 + (c0->height > c1->height ? c0->height : c1->height);
+    if (node->height != height || !contains(node->extents, c0->extents) || !contains(node->extents, c1->extents)) {
+        *valid = false;
+    }
+    return validate_node(tree, node->children[0], index, valid) + validate_node(tree, node->children[1], index, valid);
+}
+
+static b8 validate(const bvh* tree, u32 object_count) {
+    if (tree->root == INVALID_ID) {
+        return object_count == 0 && tree->node_count == 0;
+    }
+    b8 valid = true;
+    u32 leaf_count = validate_node(tree, tree->root, INVALID_ID, &valid);
+    return valid && leaf_count == object_count && tree->node_count == object_count * 2 - 1;
+}
+
+static b8 record_found(u32 proxy, u64 user_data, void* context) {
+    if (found[user_data]) {
+        // reported twice
+        *(b8*)context = false;
+    }
+    found[user_data] = true;
+    found_count++;
+    return true;
+}
+
+static void clear_found() {
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+        found[i] = false;
+    }
+    found_count = 0;
+}
+
+// Test inserting, moving and removing against the structure of the tree
+u8 test_bvh_updates() {
+    fill_boxes(50);
+    bvh tree;
+    // small capacity so the nodes grow
+    expect_to_be_true(bvh_create(16, 0.5f, &tree));
+    expect_to_be_true(validate(&tree, 0));
+
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+        proxies[i] = bvh_insert(&tree, boxes[i], i);
+    }
+    expect_to_be_true(validate(&tree, BVH_TEST_OBJECT_COUNT));
+    // a balanced tree of 1000 leaves is 10 high
+    expect_to_be_true(bvh_get_height(&tree) <= 20);
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+        expect_should_be(i, bvh_get_user_data(&tree, proxies[i]));
+        expect_to_be_true(contains(bvh_get_fat_extents(&tree, proxies[i]), boxes[i]));
+    }
+
+    // small moves stay in the fat box, large ones go elsewhere in the tree
+    vec3 small = {{0.2f, 0.0f, -0.2f}};
+    expect_to_be_false(bvh_move(&tree, proxies[0], (extents_3d){vec3_add(boxes[0].min, small), vec3_add(boxes[0].max, small)}));
+    random_state state;
+    random_seed(&state, 51);
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; i += 2) {
+        vec3 offset = {{random_range_f32(&state, -30.0f, 30.0f), 0.0f, random_range_f32(&state, -30.0f, 30.0f)}};
+        boxes[i] = (extents_3d){vec3_add(boxes[i].min, offset), vec3_add(boxes[i].max, offset)};
+        expect_to_be_true(bvh_move(&tree, proxies[i], boxes[i]));
+    }
+    expect_to_be_true(validate(&tree, BVH_TEST_OBJECT_COUNT));
+    expect_to_be_true(bvh_get_height(&tree) <= 20);
+
+    for (u32 i = 1; i < BVH_TEST_OBJECT_COUNT; i += 2) {
+        bvh_remove(&tree, proxies[i]);
+    }
+    expect_to_be_true(validate(&tree, BVH_TEST_OBJECT_COUNT / 2));
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; i += 2) {
+        bvh_remove(&tree, proxies[i]);
+    }
+    expect_to_be_true(validate(&tree, 0));
+
+    bvh_destroy(&tree);
+    return true;
+}
+
+// Test the overlap and frustum queries against testing every object
+u8 test_bvh_queries() {
+    fill_boxes(52);
+    bvh tree;
+    bvh_create(BVH_TEST_OBJECT_COUNT, 0.0f, &tree);
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+        proxies[i] = bvh_insert(&tree, boxes[i], i);
+    }
+
+    b8 once = true;
+    extents_3d area = {{{-30.0f, -5.0f, -10.0f}}, {{10.0f, 5.0f, 40.0f}}};
+    clear_found();
+    bvh_query_overlap(&tree, area, record_found, &once);
+    expect_to_be_true(once);
+    u32 expected_count = 0;
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+        b8 expected = overlaps(boxes[i], area);
+        expect_should_be(expected, found[i]);
+        expected_count += expected;
+    }
+    expect_should_be(expected_count, found_count);
+    expect_to_be_true(found_count > 10);
+
+    mat4 view = mat4_look_at((vec3){{0.0f, 10.0f, 60.0f}}, (vec3){{-20.0f, 0.0f, 0.0f}}, (vec3){{0.0f, 1.0f, 0.0f}});
+    mat4 projection = mat4_perspective(deg_to_rad(60.0f), 1.5f, 0.1f, 120.0f);
+    frustum f = frustum_from_matrix(mat4_multiply(view, projection));
+    clear_found();
+    bvh_query_frustum(&tree, &f, record_found, &once);
+    expect_to_be_true(once);
+    expected_count = 0;
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+        b8 expected = frustum_intersects_aabb(&f, boxes[i]);
+        expect_should_be(expected, found[i]);
+        expected_count += expected;
+    }
+    expect_should_be(expected_count, found_count);
+    expect_to_be_true(found_count > 10 && found_count < BVH_TEST_OBJECT_COUNT - 10);
+
+    bvh_destroy(&tree);
+    return true;
+}
+
+typedef struct closest_hit {
+    vec3 origin;
+    vec3 direction;
+    u64 closest;
+    f32 distance;
+} closest_hit;
+
+// Distance along the ray to a box, -1 when missed
+static f32 ray_box_distance(vec3 origin, vec3 direction, f32 max_distance, extents_3d box) {
+    f32 enter = 0.0f;
+    f32 leave = max_distance;
+    for (u32 i = 0; i < 3; ++i) {
+        f32 t0 = (box.min.elements[i] - origin.elements[i]) / direction.elements[i];
+        f32 t1 = (box.max.elements[i] - origin.elements[i]) / direction.elements[i];
+        f32 near_t = t0 < t1 ? t0 : t1;
+        f32 far_t = t0 < t1 ? t1 : t0;
+        enter = near_t > enter ? near_t : enter;
+        leave = far_t < leave ? far_t : leave;
+    }
+    return enter <= leave ? enter : -1.0f;
+}
+
+static f32 record_closest(u32 proxy, u64 user_data, f32 max_distance, void* context) {
+    closest_hit* hit = context;
+    found[user_data] = true;
+    found_count++;
+    f32 distance = ray_box_distance(hit->origin, hit->direction, max_distance, boxes[user_data]);
+    if (distance < 0.0f) {
+        return max_distance;
+    }
+    hit->closest = user_data;
+    hit->distance = distance;
+    // only look for closer boxes
+    return distance;
+}
+
+// Test that a ray finds the closest box, visiting few of them
+u8 test_bvh_raycast() {
+    fill_boxes(53);
+    bvh tree;
+    bvh_create(BVH_TEST_OBJECT_COUNT, 0.0f, &tree);
+    for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+        proxies[i] = bvh_insert(&tree, boxes[i], i);
+    }
+
+    random_state state;
+    random_seed(&state, 54);
+    for (u32 r = 0; r < 50; ++r) {
+        closest_hit hit = {
+            {{random_range_f32(&state, -100.0f, 100.0f), random_range_f32(&state, -20.0f, 20.0f), -120.0f}},
+            vec3_normalized((vec3){{random_range_f32(&state, -0.3f, 0.3f), random_range_f32(&state, -0.1f, 0.1f), 1.0f}}),
+            INVALID_ID,
+            1000.0f};
+        clear_found();
+        bvh_raycast(&tree, hit.origin, hit.direction, 1000.0f, record_closest, &hit);
+
+        u64 expected = INVALID_ID;
+        f32 expected_distance = 1000.0f;
+        for (u32 i = 0; i < BVH_TEST_OBJECT_COUNT; ++i) {
+            f32 distance = ray_box_distance(hit.origin, hit.direction, 1000.0f, boxes[i]);
+            if (distance >= 0.0f && distance < expected_distance) {
+                expected_distance = distance;
+                expected = i;
+            }
+        }
+        expect_should_be(expected, hit.closest);
+        expect_to_be_true(found_count < BVH_TEST_OBJECT_COUNT / 4);
+    }
+
+    bvh_destroy(&tree);
+    return true;
+}
+
+// Test boxes of geometries moved by model matrices, as a scene would insert them
+u8 test_bvh_geometry_bounds() {
+    extents_3d model_box = {{{-1.0f, -2.0f, -0.5f}}, {{1.0f, 2.0f, 0.5f}}};
+    mat4 model = mat4_multiply(quat_to_mat4(quat_from_axis_angle((vec3){{0.0f, 0.0f, 1.0f}}, HALF_PI, true)),
+                               mat4_translation((vec3){{10.0f, 0.0f, 0.0f}}));
+    extents_3d world = bounds_extents_transform(model_box, model);
+    // a quarter turn around z swaps the x and y sizes
+    expect_float_to_be(8.0f, world.min.x);
+    expect_float_to_be(12.0f, world.max.x);
+    expect_float_to_be(-1.0f, world.min.y);
+    expect_float_to_be(1.0f, world.max.y);
+    expect_float_to_be(-0.5f, world.min.z);
+
+    bvh tree;
+    bvh_create(4, 0.1f, &tree);
+    u32 proxy = bvh_insert(&tree, world, 7);
+    b8 once = true;
+    clear_found();
+    bvh_query_overlap(&tree, (extents_3d){{{11.9f, 0.0f, 0.0f}}, {{13.0f, 1.0f, 1.0f}}}, record_found, &once);
+    expect_should_be(1, found_count);
+    expect_to_be_true(found[7]);
+    bvh_remove(&tree, proxy);
+    expect_should_be(0, bvh_get_height(&tree));
+    bvh_destroy(&tree);
+    return true;
+}
+
+// Register all bounding volume hierarchy tests
+void bvh_register_tests() {
+    test_manager_register_test(test_bvh_updates, "BVH insert, move and remove");
+    test_manager_register_test(test_bvh_queries, "BVH overlap and frustum queries");
+    test_manager_register_test(test_bvh_raycast, "BVH raycast");
+    test_manager_register_test(test_bvh_geometry_bounds, "BVH with geometry bounds");
+}
@@ -0,0 +1,241 @@
+#include "cmath_tests.h"
+
+#include <math/cmath.h>
+#include <math/cmath_reference.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+// relative to the magnitude of the values, the SSE code doesn't round in the same order
+#define CMATH_TEST_TOLERANCE 0.0005f
+
+static b8 nearly_equal(f32 a, f32 b) {
+    f32 scale = c_absf(a) > c_absf(b) ? c_absf(a) : c_absf(b);
+    return c_absf(a - b) <= CMATH_TEST_TOLERANCE * (scale > 1.0f ? scale : 1.0f);
+}
+
+static b8 mat4_nearly_equal(const mat4* a, const mat4* b) {
+    for (u32 i = 0; i < 16; ++i) {
+        if (!nearly_equal(a->data[i], b->data[i])) {
+            LOG_ERROR("Element %u differs: %f != %f", i, a->data[i], b->data[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static b8 vec4_nearly_equal(const vec4* a, const vec4* b) {
+    for (u32 i = 0; i < 4; ++i) {
+        if (!nearly_equal(a->elements[i], b->elements[i])) {
+            LOG_ERROR("Element %u differs: %f != %f", i, a->elements[i], b->elements[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// A well conditioned transform: rotation, non uniform scale and translation
+static mat4 make_transform(f32 seed) {
+    mat4 rotation = mat4_euler_xyz(0.3f * seed, -0.7f * seed, 1.1f * seed);
+    mat4 scale = mat4_identity();
+    scale.data[0] = 1.5f + seed;
+    scale.data[5] = 0.5f;
+    scale.data[10] = 2.0f - 0.25f * seed;
+    mat4 translation = mat4_translation((vec3){{3.0f * seed, -2.0f, 5.0f - seed}});
+    return mat4_multiply(mat4_multiply(scale, rotation), translation);
+}
+
+// Arbitrary matrix without any particular structure
+static mat4 make_general(f32 seed) {
+    mat4 m;
+    for (u32 i = 0; i < 16; ++i) {
+        m.data[i] = c_sinf(seed * 1.7f + (f32)i * 0.9f) * 4.0f;
+    }
+    // keep it far from singular
+    for (u32 i = 0; i < 4; ++i) {
+        m.data[i * 5] += 10.0f;
+    }
+    return m;
+}
+
+// Test the matrix product against the scalar reference
+u8 test_cmath_mat4_multiply() {
+    for (u32 i = 0; i < 8; ++i) {
+        mat4 a = make_general((f32)i);
+        mat4 b = make_transform((f32)i * 0.5f);
+        mat4 expected;
+        mat4_multiply_reference(&a, &b, &expected);
+        mat4 actual = mat4_multiply(a, b);
+        expect_to_be_true(mat4_nearly_equal(&expected, &actual));
+    }
+
+    // the identity is neutral on both sides
+    mat4 a = make_general(2.0f);
+    mat4 left = mat4_multiply(mat4_identity(), a);
+    mat4 right = mat4_multiply(a, mat4_identity());
+    expect_to_be_true(mat4_nearly_equal(&a, &left));
+    expect_to_be_true(mat4_nearly_equal(&a, &right));
+    return true;
+}
+
+// Test the inverse against the scalar reference and the identity
+u8 test_cmath_mat4_inverse() {
+    mat4 identity = mat4_identity();
+    for (u32 i = 0; i < 8; ++i) {
+        mat4 matrices[2] = {make_general((f32)i), make_transform((f32)i * 0.5f)};
+        for (u32 j = 0; j < 2; ++j) {
+            mat4 expected;
+            mat4_inverse_reference(&matrices[j], &expected);
+            mat4 actual = mat4_inverse(matrices[j]);
+            expect_to_be_true(mat4_nearly_equal(&expected, &actual));
+
+            mat4 product = mat4_multiply(matrices[j], actual);
+            expect_to_be_true(mat4_nearly_equal(&identity, &product));
+        }
+    }
+    return true;
+}
+
+// Test the transposition against the scalar reference
+u8 test_cmath_mat4_transposed() {
+    mat4 a = make_general(3.0f);
+    mat4 expected;
+    mat4_transposed_reference(&a, &expected);
+    mat4 actual = mat4_transposed(a);
+    expect_to_be_true(mat4_nearly_equal(&expected, &actual));
+    expect_float_to_be(a.data[1], actual.data[4]);
+    expect_float_to_be(a.data[14], actual.data[11]);
+    return true;
+}
+
+// Test the quaternion functions against the scalar reference
+u8 test_cmath_quat() {
+    for (u32 i = 0; i < 8; ++i) {
+        quat a = quat_from_axis_angle((vec3){{1.0f, 0.5f * (f32)i, -0.25f}}, 0.4f * (f32)i, true);
+        quat b = vec4_create(0.3f, -1.2f + (f32)i, 0.8f, 2.0f);
+
+        quat expected;
+        quat_mul_reference(&a, &b, &expected);
+        quat actual = quat_mul(a, b);
+        expect_to_be_true(vec4_nearly_equal(&expected, &actual));
+
+        quat_normalize_reference(&b, &expected);
+        actual = quat_normalize(b);
+        expect_to_be_true(vec4_nearly_equal(&expected, &actual));
+        expect_float_to_be(1.0f, quat_normal(actual));
+
+        actual = quat_conjugate(b);
+        expect_float_to_be(-0.3f, actual.x);
+        expect_float_to_be(2.0f, actual.w);
+    }
+
+    // q * conjugate(q) is the identity for a unit quaternion
+    quat q = quat_from_axis_angle((vec3){{0.0f, 1.0f, 0.0f}}, 1.2f, true);
+    quat product = quat_mul(q, quat_conjugate(q));
+    quat identity = quat_identity();
+    expect_to_be_true(vec4_nearly_equal(&identity, &product));
+    return true;
+}
+
+// Test the component wise vec4 operations
+u8 test_cmath_vec4() {
+    vec4 a = vec4_create(1.0f, -2.0f, 3.0f, 4.0f);
+    vec4 b = vec4_create(0.5f, 4.0f, -1.0f, 2.0f);
+
+    vec4 r = vec4_add(a, b);
+    expect_float_to_be(1.5f, r.x);
+    expect_float_to_be(6.0f, r.w);
+    r = vec4_subtract(a, b);
+    expect_float_to_be(-6.0f, r.y);
+    r = vec4_multiply(a, b);
+    expect_float_to_be(-3.0f, r.z);
+    r = vec4_divide(a, b);
+    expect_float_to_be(2.0f, r.x);
+    expect_float_to_be(-0.5f, r.y);
+    r = vec4_scale(a, 2.0f);
+    expect_float_to_be(8.0f, r.w);
+
+    expect_float_to_be(vec4_dot_reference(&a, &b), vec4_dot(a, b));
+    expect_float_to_be(30.0f, vec4_length_squared(a));
+
+    vec4 expected;
+    vec4_normalized_reference(&a, &expected);
+    r = vec4_normalized(a);
+    expect_to_be_true(vec4_nearly_equal(&expected, &r));
+    expect_float_to_be(1.0f, vec4_length(r));
+    return true;
+}
+
+// Test the rigid and affine inverses against the general one
+u8 test_cmath_mat4_inverse_fast() {
+    for (u32 i = 0; i < 8; ++i) {
+        f32 seed = (f32)i * 0.5f;
+        mat4 rigid = mat4_multiply(mat4_euler_xyz(0.3f * seed, -0.7f * seed, 1.1f * seed),
+                                   mat4_translation((vec3){{3.0f * seed, -2.0f, 5.0f - seed}}));
+        mat4 expected = mat4_inverse(rigid);
+        mat4 actual = mat4_inverse_rigid(rigid);
+        expect_to_be_true(mat4_nearly_equal(&expected, &actual));
+
+        // scaled, the rigid inverse no longer applies
+        mat4 affine = make_transform(seed);
+        expected = mat4_inverse(affine);
+        actual = mat4_inverse_affine(affine);
+        expect_to_be_true(mat4_nearly_equal(&expected, &actual));
+        actual = mat4_inverse_affine(rigid);
+        expected = mat4_inverse(rigid);
+        expect_to_be_true(mat4_nearly_equal(&expected, &actual));
+    }
+
+    // the camera of the renderer
+    mat4 view = mat4_translation((vec3){{0.0f, 0.0f, -30.0f}});
+    mat4 inverse = mat4_inverse_rigid(view);
+    expect_float_to_be(30.0f, inverse.data[14]);
+    expect_float_to_be(1.0f, inverse.data[15]);
+    return true;
+}
+
+// Test the 3x4 affine matrix against the equivalent mat4
+u8 test_cmath_mat3x4() {
+    mat4 a = make_transform(1.0f);
+    mat4 b = make_transform(-0.5f);
+    mat3x4 a_affine = mat3x4_from_mat4(a);
+    mat3x4 b_affine = mat3x4_from_mat4(b);
+    expect_should_be(48, sizeof(mat3x4));
+
+    // the translation is in the last column
+    expect_float_to_be(a.data[12], a_affine.data[3]);
+    expect_float_to_be(a.data[14], a_affine.data[11]);
+    mat4 round_trip = mat4_from_mat3x4(a_affine);
+    expect_to_be_true(mat4_nearly_equal(&a, &round_trip));
+    mat3x4 identity = mat3x4_identity();
+    round_trip = mat4_from_mat3x4(identity);
+    mat4 expected = mat4_identity();
+    expect_to_be_true(mat4_nearly_equal(&expected, &round_trip));
+
+    expected = mat4_multiply(a, b);
+    mat4 actual = mat4_from_mat3x4(mat3x4_multiply(a_affine, b_affine));
+    expect_to_be_true(mat4_nearly_equal(&expected, &actual));
+
+    expected = mat4_inverse(a);
+    actual = mat4_from_mat3x4(mat3x4_inverse(a_affine));
+    expect_to_be_true(mat4_nearly_equal(&expected, &actual));
+
+    // a point goes through like a row vector through the mat4
+    vec3 p = {{1.0f, -2.0f, 0.5f}};
+    vec3 moved = mat3x4_transform_point(a_affine, p);
+    for (u32 j = 0; j < 3; ++j) {
+        f32 expected_coordinate = p.x * a.data[j] + p.y * a.data[4 + j] + p.z * a.data[8 + j] + a.data[12 + j];
+        expect_to_be_true(nearly_equal(expected_coordinate, moved.elements[j]));
+    }
+    return true;
+}
+
+// Register all cmath tests
+void cmath_register_tests() {
+    test_manager_register_test(test_cmath_mat4_multiply, "Math mat4 multiply matches the reference");
+    test_manager_register_test(test_cmath_mat4_inverse, "Math mat4 inverse matches the reference");
+    test_manager_register_test(test_cmath_mat4_inverse_fast, "Math mat4 rigid and affine inverses match the general one");
+    test_manager_register_test(test_cmath_mat3x4, "Math mat3x4 matches the equivalent mat4");
+    test_manager_register_test(test_cmath_mat4_transposed, "Math mat4 transposed matches the reference");
+    test_manager_register_test(test_cmath_quat, "Math quaternion functions match the reference");
+    test_manager_register_test(test_cmath_vec4, "Math vec4 operations");
+}
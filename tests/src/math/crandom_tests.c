@@ -0,0 +1,183 @@
+#include "crandom_tests.h"
+
+#include <math/cmath.h>
+#include <math/crandom.h>
+#include <platform/platform.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+// Test the generator against known values of xoshiro256**
+u8 test_crandom_known_sequence() {
+    random_state state = {{1, 2, 3, 4}};
+    expect_should_be(0x2d00ull, random_next_u64(&state));
+    expect_should_be(0x0ull, random_next_u64(&state));
+    expect_should_be(0x5a007080ull, random_next_u64(&state));
+    expect_should_be(0x10e0000000009d80ull, random_next_u64(&state));
+    random_next_u64(&state);
+    random_next_u64(&state);
+    expect_should_be(0xe071c3c2e143f089ull, random_next_u64(&state));
+    return true;
+}
+
+// Test that seeding is deterministic and jumping gives another sequence
+u8 test_crandom_seeding() {
+    random_state a, b;
+    random_seed(&a, 1234);
+    random_seed(&b, 1234);
+    for (u32 i = 0; i < 100; ++i) {
+        expect_should_be(random_next_u64(&a), random_next_u64(&b));
+    }
+
+    random_seed(&b, 1235);
+    u32 equal_count = 0;
+    for (u32 i = 0; i < 100; ++i) {
+        equal_count += random_next_u64(&a) == random_next_u64(&b);
+    }
+    expect_should_be(0, equal_count);
+
+    random_seed(&a, 0);
+    b = a;
+    random_jump(&b);
+    expect_to_be_true(random_next_u64(&a) != random_next_u64(&b));
+    return true;
+}
+
+// Test the bounds and the distribution of the ranged functions
+u8 test_crandom_ranges() {
+    random_state state;
+    random_seed(&state, 99);
+
+    u32 histogram[6] = {0};
+    f64 sum = 0.0;
+    const u32 count = 60000;
+    for (u32 i = 0; i < count; ++i) {
+        i32 value = random_range_i32(&state, -2, 3);
+        expect_to_be_true(value >= -2 && value <= 3);
+        histogram[value + 2]++;
+
+        f32 f = random_next_f32(&state);
+        expect_to_be_true(f >= 0.0f && f < 1.0f);
+        sum += f;
+
+        f32 ranged = random_range_f32(&state, 10.0f, 20.0f);
+        expect_to_be_true(ranged >= 10.0f && ranged < 20.0f);
+
+        expect_to_be_true(random_next_bounded(&state, 7) < 7);
+    }
+    // 10000 expected per bucket, far more than 5 standard deviations away would be a bug
+    for (u32 i = 0; i < 6; ++i) {
+        expect_to_be_true(histogram[i] > 9500 && histogram[i] < 10500);
+    }
+    expect_to_be_true(sum / count > 0.49 && sum / count < 0.51);
+
+    // the whole i32 range doesn't overflow
+    random_range_i32(&state, -2147483647 - 1, 2147483647);
+    expect_should_be(0, random_next_bounded(&state, 0));
+    return true;
+}
+
+// Test the bulk fills, scalar and SIMD sized
+u8 test_crandom_fill() {
+    static f32 values[1027];
+    static f32 again[1027];
+    random_state state;
+    random_state copy;
+    random_seed(&state, 7);
+    copy = state;
+
+    random_fill_f32(&state, values, 1027, -1.0f, 1.0f);
+    random_fill_f32(&copy, again, 1027, -1.0f, 1.0f);
+    f64 sum = 0.0;
+    for (u32 i = 0; i < 1027; ++i) {
+        expect_to_be_true(values[i] >= -1.0f && values[i] < 1.0f);
+        expect_should_be(values[i], again[i]);
+        sum += values[i];
+    }
+    expect_to_be_true(sum / 1027 > -0.1 && sum / 1027 < 0.1);
+    // the state moved on
+    expect_should_be(random_next_u64(&copy), random_next_u64(&state));
+    random_fill_f32(&state, again, 1027, -1.0f, 1.0f);
+    b8 changed = values[0] != again[0] || values[1] != again[1];
+    expect_to_be_true(changed);
+
+    u32 integers[5];
+    random_seed(&state, 7);
+    random_fill_u32(&state, integers, 5);
+    random_seed(&copy, 7);
+    u64 first = random_next_u64(&copy);
+    expect_should_be((u32)(first >> 32), integers[0]);
+    expect_should_be((u32)first, integers[1]);
+    return true;
+}
+
+static u32 thread_first_value;
+
+static u32 crandom_test_thread(void* params) {
+    thread_first_value = random_next_u32(random_thread_state());
+    return 0;
+}
+
+// Test that the per thread generators are deterministic and distinct
+u8 test_crandom_threads() {
+    random_seed_threads(42);
+    u32 first = random_next_u32(random_thread_state());
+    i32 second = crandom();
+    f32 third = fcrandom();
+    random_seed_threads(42);
+    expect_should_be(first, random_next_u32(random_thread_state()));
+    expect_should_be(second, crandom());
+    expect_should_be(third, fcrandom());
+    expect_to_be_true(third >= 0.0f && third < 1.0f);
+
+    platform_thread thread;
+    expect_to_be_true(platform_thread_create(crandom_test_thread, 0, &thread));
+    platform_thread_join(&thread);
+    random_seed_threads(42);
+    expect_to_be_true(thread_first_value != random_next_u32(random_thread_state()));
+
+    i32 value = crandom_in_range(5, 8);
+    expect_to_be_true(value >= 5 && value <= 8);
+    return true;
+}
+
+static f32 next_thread_values[256];
+
+static u32 crandom_test_next_thread(void* params) {
+    random_state* state = random_thread_state();
+    for (u32 i = 0; i < 256; ++i) {
+        next_thread_values[i] = random_next_f32(state);
+    }
+    return 0;
+}
+
+// Test that the bulk fill of a thread doesn't draw the numbers of the next thread
+u8 test_crandom_thread_fill_overlap() {
+    static f32 values[1024];
+    random_seed_threads(11);
+    random_state state = *random_thread_state();
+    random_fill_f32(&state, values, 1024, 0.0f, 1.0f);
+
+    platform_thread thread;
+    expect_to_be_true(platform_thread_create(crandom_test_next_thread, 0, &thread));
+    platform_thread_join(&thread);
+
+    // the last value of every 4 comes from the high half of the second generator, the one
+    // random_next_f32 uses
+    u32 equal_count = 0;
+    for (u32 i = 0; i < 256; ++i) {
+        equal_count += next_thread_values[i] == values[i * 4 + 3];
+        equal_count += next_thread_values[i] == values[i * 4 + 2];
+    }
+    expect_should_be(0, equal_count);
+    return true;
+}
+
+// Register all random generator tests
+void crandom_register_tests() {
+    test_manager_register_test(test_crandom_known_sequence, "Random xoshiro256** known sequence");
+    test_manager_register_test(test_crandom_seeding, "Random deterministic seeding and jump");
+    test_manager_register_test(test_crandom_ranges, "Random ranges and distribution");
+    test_manager_register_test(test_crandom_fill, "Random bulk fills");
+    test_manager_register_test(test_crandom_threads, "Random per thread generators");
+    test_manager_register_test(test_crandom_thread_fill_overlap, "Random fill doesn't overlap the next thread");
+}
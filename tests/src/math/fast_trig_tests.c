@@ -0,0 +1,94 @@
+#include "fast_trig_tests.h"
+
+#include <math/fast_trig.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <math.h>
+
+#define FAST_TRIG_TEST_SAMPLES 200000
+
+/**
+ * Largest error of the sin and cos of a tier over [-range, range]
+ * @return the largest absolute error against the double precision libm functions
+ */
+static f64 sincos_max_error(f64 range, b8 precise) {
+    f64 max_error = 0.0;
+    for (u32 i = 0; i <= FAST_TRIG_TEST_SAMPLES; ++i) {
+        f32 x = (f32)(-range + 2.0 * range * i / FAST_TRIG_TEST_SAMPLES);
+        f32 s, c;
+        c_sincosf_tier(x, precise, &s, &c);
+        f64 sin_error = fabs(s - sin((f64)x));
+        f64 cos_error = fabs(c - cos((f64)x));
+        if (sin_error > max_error) max_error = sin_error;
+        if (cos_error > max_error) max_error = cos_error;
+    }
+    return max_error;
+}
+
+// Test the documented error bounds of the sin / cos tiers
+u8 test_fast_trig_sincos_error() {
+    expect_to_be_true(sincos_max_error(8192.0, true) < 1.5e-7);
+    expect_to_be_true(sincos_max_error(PI, false) < 1.5e-6);
+    expect_to_be_true(sincos_max_error(512.0, false) < 5e-5);
+
+    // exact at the quadrant boundaries
+    expect_float_to_be(0.0f, c_sinf_precise(0.0f));
+    expect_float_to_be(1.0f, c_cosf_precise(0.0f));
+    expect_float_to_be(1.0f, c_sinf_precise(HALF_PI));
+    expect_float_to_be(-1.0f, c_cosf_fast(PI));
+    expect_float_to_be(-1.0f, c_sinf_fast(-HALF_PI));
+    expect_float_to_be(1.0f, c_tanf_precise(QUARTER_PI));
+    expect_float_to_be(-1.0f, c_tanf_fast(-QUARTER_PI));
+    return true;
+}
+
+// Test the documented error bounds of acos
+u8 test_fast_trig_acos_error() {
+    f64 precise_error = 0.0;
+    f64 fast_error = 0.0;
+    for (u32 i = 0; i <= FAST_TRIG_TEST_SAMPLES; ++i) {
+        f32 x = (f32)(-1.0 + 2.0 * i / FAST_TRIG_TEST_SAMPLES);
+        f64 expected = acos((f64)x);
+        f64 error = fabs(c_acosf_precise(x) - expected);
+        if (error > precise_error) precise_error = error;
+        error = fabs(c_acosf_fast(x) - expected);
+        if (error > fast_error) fast_error = error;
+    }
+    expect_to_be_true(precise_error < 4e-7);
+    expect_to_be_true(fast_error < 7e-5);
+    return true;
+}
+
+// Test that the array version, wide or not, gives the scalar results
+u8 test_fast_trig_array() {
+    // not a multiple of 8 or 4, to go through every path
+    f32 angles[37];
+    f32 sines[37];
+    f32 cosines[37];
+    for (u32 i = 0; i < 37; ++i) {
+        angles[i] = -50.0f + 2.77f * (f32)i;
+    }
+    for (u32 tier = 0; tier < 2; ++tier) {
+        b8 precise = tier == 1;
+        c_sincosf_array(angles, 37, precise, sines, cosines);
+        for (u32 i = 0; i < 37; ++i) {
+            f32 s, c;
+            c_sincosf_tier(angles[i], precise, &s, &c);
+            expect_to_be_true(c_absf(s - sines[i]) < 1e-6f);
+            expect_to_be_true(c_absf(c - cosines[i]) < 1e-6f);
+        }
+    }
+
+    // either output can be left out
+    c_sincosf_array(angles, 37, true, 0, cosines);
+    expect_to_be_true(c_absf(cosines[36] - c_cosf_precise(angles[36])) < 1e-6f);
+    return true;
+}
+
+// Register all fast trigonometry tests
+void fast_trig_register_tests() {
+    test_manager_register_test(test_fast_trig_sincos_error, "Fast trigonometry sin / cos error bounds");
+    test_manager_register_test(test_fast_trig_acos_error, "Fast trigonometry acos error bounds");
+    test_manager_register_test(test_fast_trig_array, "Fast trigonometry wide versions match the scalar ones");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void fast_trig_register_tests();
@@ -0,0 +1,133 @@
+#include "frustum_tests.h"
+
+#include <math/cmath.h>
+#include <math/crandom.h>
+#include <math/frustum.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+#define FRUSTUM_TEST_OBJECT_COUNT 1003
+
+// 90 degrees, square, from the origin looking down -z
+static frustum test_frustum() {
+    mat4 projection = mat4_perspective(deg_to_rad(90.0f), 1.0f, 0.1f, 100.0f);
+    return frustum_from_matrix(mat4_multiply(mat4_identity(), projection));
+}
+
+// Test the planes extracted from a perspective projection
+u8 test_frustum_from_matrix() {
+    frustum f = test_frustum();
+    plane_3d near = f.sides[FRUSTUM_SIDE_NEAR];
+    plane_3d left = f.sides[FRUSTUM_SIDE_LEFT];
+    expect_float_to_be(-1.0f, near.normal.z);
+    expect_float_to_be(-0.1f, near.distance);
+    expect_float_to_be(100.0f, f.sides[FRUSTUM_SIDE_FAR].distance);
+    expect_float_to_be(0.70710678f, left.normal.x);
+    expect_float_to_be(-0.70710678f, left.normal.z);
+    expect_float_to_be(0.0f, left.distance);
+
+    expect_to_be_true(frustum_intersects_sphere(&f, (vec3){{0.0f, 0.0f, -10.0f}}, 0.0f));
+    expect_to_be_false(frustum_intersects_sphere(&f, (vec3){{0.0f, 0.0f, 10.0f}}, 1.0f));
+    expect_to_be_false(frustum_intersects_sphere(&f, (vec3){{0.0f, 0.0f, -200.0f}}, 1.0f));
+    expect_to_be_false(frustum_intersects_sphere(&f, (vec3){{20.0f, 0.0f, -10.0f}}, 1.0f));
+    expect_to_be_false(frustum_intersects_sphere(&f, (vec3){{0.0f, -20.0f, -10.0f}}, 1.0f));
+    // straddling the right plane
+    expect_to_be_true(frustum_intersects_sphere(&f, (vec3){{11.0f, 0.0f, -10.0f}}, 1.0f));
+
+    // moving the camera moves the frustum
+    mat4 view = mat4_inverse_rigid(mat4_translation((vec3){{0.0f, 0.0f, 50.0f}}));
+    mat4 projection = mat4_perspective(deg_to_rad(90.0f), 1.0f, 0.1f, 100.0f);
+    frustum moved = frustum_from_matrix(mat4_multiply(view, projection));
+    expect_to_be_true(frustum_intersects_sphere(&moved, (vec3){{0.0f, 0.0f, 10.0f}}, 1.0f));
+    expect_to_be_false(frustum_intersects_sphere(&moved, (vec3){{0.0f, 0.0f, -60.0f}}, 1.0f));
+    return true;
+}
+
+// Test boxes against a frustum
+u8 test_frustum_intersects_aabb() {
+    frustum f = test_frustum();
+    extents_3d inside = {{{-1.0f, -1.0f, -11.0f}}, {{1.0f, 1.0f, -9.0f}}};
+    extents_3d behind = {{{-1.0f, -1.0f, 1.0f}}, {{1.0f, 1.0f, 3.0f}}};
+    extents_3d around_camera = {{{-1.0f, -1.0f, -1.0f}}, {{1.0f, 1.0f, 1.0f}}};
+    extents_3d right = {{{20.0f, -1.0f, -11.0f}}, {{22.0f, 1.0f, -9.0f}}};
+    extents_3d crossing_right = {{{9.0f, -1.0f, -11.0f}}, {{12.0f, 1.0f, -9.0f}}};
+    expect_to_be_true(frustum_intersects_aabb(&f, inside));
+    expect_to_be_false(frustum_intersects_aabb(&f, behind));
+    expect_to_be_true(frustum_intersects_aabb(&f, around_camera));
+    expect_to_be_false(frustum_intersects_aabb(&f, right));
+    expect_to_be_true(frustum_intersects_aabb(&f, crossing_right));
+    return true;
+}
+
+static f32 center_x[FRUSTUM_TEST_OBJECT_COUNT];
+static f32 center_y[FRUSTUM_TEST_OBJECT_COUNT];
+static f32 center_z[FRUSTUM_TEST_OBJECT_COUNT];
+static f32 size_x[FRUSTUM_TEST_OBJECT_COUNT];
+static f32 size_y[FRUSTUM_TEST_OBJECT_COUNT];
+static f32 size_z[FRUSTUM_TEST_OBJECT_COUNT];
+static u32 visible[FRUSTUM_TEST_OBJECT_COUNT];
+
+static void fill_objects() {
+    random_state state;
+    random_seed(&state, 48);
+    random_fill_f32(&state, center_x, FRUSTUM_TEST_OBJECT_COUNT, -60.0f, 60.0f);
+    random_fill_f32(&state, center_y, FRUSTUM_TEST_OBJECT_COUNT, -60.0f, 60.0f);
+    random_fill_f32(&state, center_z, FRUSTUM_TEST_OBJECT_COUNT, -120.0f, 20.0f);
+    random_fill_f32(&state, size_x, FRUSTUM_TEST_OBJECT_COUNT, 0.0f, 5.0f);
+    random_fill_f32(&state, size_y, FRUSTUM_TEST_OBJECT_COUNT, 0.0f, 5.0f);
+    random_fill_f32(&state, size_z, FRUSTUM_TEST_OBJECT_COUNT, 0.0f, 5.0f);
+}
+
+// Test that the batched sphere test keeps the same spheres as the single one, in order
+u8 test_frustum_cull_spheres() {
+    frustum f = test_frustum();
+    fill_objects();
+    frustum_cull_spheres spheres = {center_x, center_y, center_z, size_x};
+    // counts that end on each kind of tail
+    u32 counts[] = {0, 3, 8, 13, FRUSTUM_TEST_OBJECT_COUNT};
+    for (u32 c = 0; c < 5; ++c) {
+        u32 visible_count = frustum_cull_spheres_batch(&f, &spheres, counts[c], visible);
+        u32 expected_count = 0;
+        for (u32 i = 0; i < counts[c]; ++i) {
+            vec3 center = {{center_x[i], center_y[i], center_z[i]}};
+            if (frustum_intersects_sphere(&f, center, size_x[i])) {
+                expect_should_be(i, visible[expected_count]);
+                expected_count++;
+            }
+        }
+        expect_should_be(expected_count, visible_count);
+    }
+    // some of each
+    u32 visible_count = frustum_cull_spheres_batch(&f, &spheres, FRUSTUM_TEST_OBJECT_COUNT, visible);
+    expect_to_be_true(visible_count > 50 && visible_count < FRUSTUM_TEST_OBJECT_COUNT - 50);
+    return true;
+}
+
+// Test that the batched box test keeps the same boxes as the single one, in order
+u8 test_frustum_cull_boxes() {
+    frustum f = test_frustum();
+    fill_objects();
+    frustum_cull_boxes boxes = {center_x, center_y, center_z, size_x, size_y, size_z};
+    u32 visible_count = frustum_cull_boxes_batch(&f, &boxes, FRUSTUM_TEST_OBJECT_COUNT, visible);
+    u32 expected_count = 0;
+    for (u32 i = 0; i < FRUSTUM_TEST_OBJECT_COUNT; ++i) {
+        vec3 center = {{center_x[i], center_y[i], center_z[i]}};
+        vec3 half_extent = {{size_x[i], size_y[i], size_z[i]}};
+        extents_3d box = {vec3_subtract(center, half_extent), vec3_add(center, half_extent)};
+        if (frustum_intersects_aabb(&f, box)) {
+            expect_should_be(i, visible[expected_count]);
+            expected_count++;
+        }
+    }
+    expect_should_be(expected_count, visible_count);
+    expect_to_be_true(visible_count > 50 && visible_count < FRUSTUM_TEST_OBJECT_COUNT - 50);
+    return true;
+}
+
+// Register all frustum tests
+void frustum_register_tests() {
+    test_manager_register_test(test_frustum_from_matrix, "Frustum planes and sphere test");
+    test_manager_register_test(test_frustum_intersects_aabb, "Frustum box test");
+    test_manager_register_test(test_frustum_cull_spheres, "Frustum batched spheres");
+    test_manager_register_test(test_frustum_cull_boxes, "Frustum batched boxes");
+}
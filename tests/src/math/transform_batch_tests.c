@@ -0,0 +1,131 @@
+#include "transform_batch_tests.h"
+
+#include <math/cmath.h>
+#include <math/transform_batch.h>
+#include <core/cmemory.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+static vec3 test_position(u32 i) {
+    return (vec3){{(f32)i * 0.5f, -3.0f + (f32)(i % 7), 100.0f - (f32)i}};
+}
+
+// not normalized, the batch normalizes like quat_to_mat4
+static quat test_rotation(u32 i) {
+    return vec4_create(c_sinf((f32)i), 0.5f, c_cosf((f32)i * 0.3f), 1.0f + (f32)(i % 3));
+}
+
+static vec3 test_scale(u32 i) {
+    return (vec3){{1.0f + (f32)(i % 5), 0.5f, 2.0f}};
+}
+
+// The matrix built one transform at a time
+static mat4 expected_model(u32 i) {
+    vec3 s = test_scale(i);
+    mat4 scale = mat4_identity();
+    scale.data[0] = s.x;
+    scale.data[5] = s.y;
+    scale.data[10] = s.z;
+    return mat4_multiply(mat4_multiply(scale, quat_to_mat4(test_rotation(i))), mat4_translation(test_position(i)));
+}
+
+static b8 check_models(const mat4* models, u32 first, u32 count) {
+    for (u32 i = 0; i < count; ++i) {
+        mat4 expected = expected_model(first + i);
+        for (u32 j = 0; j < 16; ++j) {
+            if (c_absf(expected.data[j] - models[i].data[j]) > 0.0005f) {
+                LOG_ERROR("Transform %u element %u: expected %f, got %f", first + i, j, expected.data[j], models[i].data[j]);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void fill(transform_batch* batch, u32 count) {
+    for (u32 i = 0; i < count; ++i) {
+        transform_batch_add(batch, test_position(i), test_rotation(i), test_scale(i));
+    }
+}
+
+// Test the batch against the one by one composition, with a partial group of 4 at the end
+u8 test_transform_batch_compute() {
+    transform_batch batch;
+    expect_to_be_true(transform_batch_create(13, 0, &batch));
+    expect_should_be(16, batch.capacity);
+    fill(&batch, 13);
+    expect_should_be(13, batch.count);
+
+    mat4 models[13];
+    transform_batch_compute(&batch, models);
+    expect_to_be_true(check_models(models, 0, 13));
+
+    // a range that doesn't start on a group of 4
+    mat4 range[6];
+    transform_batch_compute_range(&batch, 3, 6, range);
+    expect_to_be_true(check_models(range, 3, 6));
+
+    // the extra capacity can be used, but not more
+    expect_should_be(13, transform_batch_add(&batch, test_position(13), test_rotation(13), test_scale(13)));
+    fill(&batch, 2);
+    expect_should_be(16, batch.count);
+    expect_should_be(INVALID_ID, transform_batch_add(&batch, test_position(0), test_rotation(0), test_scale(0)));
+
+    transform_batch_destroy(&batch);
+    return true;
+}
+
+// Test that removing a transform moves the last one in its place
+u8 test_transform_batch_remove() {
+    transform_batch batch;
+    expect_to_be_true(transform_batch_create(8, 0, &batch));
+    fill(&batch, 6);
+
+    expect_should_be(5, transform_batch_remove(&batch, 1));
+    expect_should_be(5, batch.count);
+    expect_should_be(INVALID_ID, transform_batch_remove(&batch, 4));
+    expect_should_be(4, batch.count);
+
+    mat4 models[4];
+    transform_batch_compute(&batch, models);
+    expect_to_be_true(check_models(&models[1], 5, 1));
+    expect_to_be_true(check_models(&models[2], 2, 2));
+
+    transform_batch_set_position(&batch, 0, test_position(7));
+    transform_batch_set_rotation(&batch, 0, test_rotation(7));
+    transform_batch_set_scale(&batch, 0, test_scale(7));
+    transform_batch_compute(&batch, models);
+    expect_to_be_true(check_models(&models[0], 7, 1));
+
+    transform_batch_destroy(&batch);
+    return true;
+}
+
+// Test that the work split across the workers covers every transform
+u8 test_transform_batch_workers() {
+    const u32 count = 20001;
+    transform_batch batch;
+    expect_to_be_true(transform_batch_create(count, 3, &batch));
+    expect_should_be(3, batch.worker_count);
+    fill(&batch, count);
+
+    mat4* models = callocate(sizeof(mat4) * count, MEMORY_TAG_ARRAY);
+    // twice, the workers are reused
+    for (u32 run = 0; run < 2; ++run) {
+        czero_memory(models, sizeof(mat4) * count);
+        transform_batch_compute(&batch, models);
+        expect_to_be_true(check_models(models, 0, count));
+    }
+    cfree(models, sizeof(mat4) * count, MEMORY_TAG_ARRAY);
+
+    transform_batch_destroy(&batch);
+    expect_should_be(0, batch.worker_count);
+    return true;
+}
+
+// Register all transform batch tests
+void transform_batch_register_tests() {
+    test_manager_register_test(test_transform_batch_compute, "Transform batch matches the per object matrices");
+    test_manager_register_test(test_transform_batch_remove, "Transform batch remove and setters");
+    test_manager_register_test(test_transform_batch_workers, "Transform batch split across workers");
+}
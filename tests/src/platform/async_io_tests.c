@@ -0,0 +1,133 @@
+#include "async_io_tests.h"
+
+#include <platform/async_io.h>
+#include <platform/filesystem.h>
+#include <core/cmemory.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <stdio.h>
+
+#define TEST_FILE_PATH "async_io_test.bin"
+#define TEST_FILE_SIZE (256 * 1024)
+#define TEST_READ_COUNT 8
+
+typedef struct read_result {
+    u32 id;
+    u32 completed;
+    b8 success;
+    u64 bytes_read;
+} read_result;
+
+static void on_read_complete(u32 request_id, b8 success, u64 bytes_read, void* user_data) {
+    read_result* result = user_data;
+    result->id = request_id;
+    result->completed++;
+    result->success = success;
+    result->bytes_read = bytes_read;
+}
+
+static u8 test_byte(u64 position) {
+    return (u8)((position * 31) ^ (position >> 8));
+}
+
+static b8 write_test_file() {
+    u8* content = callocate(TEST_FILE_SIZE, MEMORY_TAG_ARRAY);
+    for (u64 i = 0; i < TEST_FILE_SIZE; ++i) {
+        content[i] = test_byte(i);
+    }
+    file_handle file;
+    b8 result = filesystem_open(TEST_FILE_PATH, FILE_MODE_WRITE, true, &file);
+    u64 written = 0;
+    if (result) {
+        result = filesystem_write(&file, TEST_FILE_SIZE, content, &written);
+        filesystem_close(&file);
+    }
+    cfree(content, TEST_FILE_SIZE, MEMORY_TAG_ARRAY);
+    return result;
+}
+
+static u8 run_async_reads(async_io_backend backend) {
+    async_io_config config = {backend, 4, 2};
+    u64 state_size;
+    initialize_async_io(&state_size, 0, config);
+    void* state = callocate(state_size, MEMORY_TAG_APPLICATION);
+    if (!initialize_async_io(&state_size, state, config)) {
+        cfree(state, state_size, MEMORY_TAG_APPLICATION);
+        // io_uring can be disabled by the kernel or a sandbox
+        return BYPASS;
+    }
+    expect_should_be(backend, async_io_get_backend());
+    expect_to_be_true(write_test_file());
+
+    // more reads than can be in flight, submitted again as slots are released
+    u64 chunk = TEST_FILE_SIZE / TEST_READ_COUNT;
+    u8* dest = callocate(TEST_FILE_SIZE, MEMORY_TAG_ARRAY);
+    read_result results[TEST_READ_COUNT] = {0};
+    u32 ids[TEST_READ_COUNT];
+    u32 submitted = 0;
+    f64 timeout = 0;
+    while (submitted < TEST_READ_COUNT && timeout < 1000) {
+        u32 id = filesystem_read_async(TEST_FILE_PATH, submitted * chunk, chunk, dest + submitted * chunk,
+                                       on_read_complete, &results[submitted]);
+        if (id == INVALID_ID) {
+            expect_should_be(4, async_io_pending_count());
+            expect_to_be_true(async_io_wait_all(1000));
+            timeout++;
+            continue;
+        }
+        ids[submitted++] = id;
+    }
+    expect_to_be_true(async_io_wait_all(1000));
+    expect_should_be(0, async_io_pending_count());
+
+    for (u32 i = 0; i < TEST_READ_COUNT; ++i) {
+        expect_should_be(1, results[i].completed);
+        expect_should_be(ids[i], results[i].id);
+        expect_to_be_true(results[i].success);
+        expect_should_be(chunk, results[i].bytes_read);
+    }
+    for (u64 i = 0; i < TEST_FILE_SIZE; ++i) {
+        if (dest[i] != test_byte(i)) {
+            expect_should_be(test_byte(i), dest[i]);
+        }
+    }
+
+    // reading past the end of the file stops at the end
+    read_result tail = {0};
+    expect_to_be_true(filesystem_read_async(TEST_FILE_PATH, TEST_FILE_SIZE - 100, 1000, dest, on_read_complete, &tail) != INVALID_ID);
+    expect_to_be_true(async_io_wait_all(1000));
+    expect_should_be(1, tail.completed);
+    expect_to_be_false(tail.success);
+    expect_should_be(100, tail.bytes_read);
+
+    expect_should_be(INVALID_ID, filesystem_read_async("async_io_missing.bin", 0, 16, dest, on_read_complete, &tail));
+
+    // the shutdown lets the reads in flight finish before the destination is released
+    read_result dropped = {0};
+    filesystem_read_async(TEST_FILE_PATH, 0, TEST_FILE_SIZE, dest, on_read_complete, &dropped);
+    shutdown_async_io();
+    expect_should_be(0, dropped.completed);
+    expect_should_be(test_byte(TEST_FILE_SIZE - 1), dest[TEST_FILE_SIZE - 1]);
+
+    cfree(dest, TEST_FILE_SIZE, MEMORY_TAG_ARRAY);
+    cfree(state, state_size, MEMORY_TAG_APPLICATION);
+    remove(TEST_FILE_PATH);
+    return true;
+}
+
+// Test async reads through the worker threads
+u8 test_async_io_thread_pool() {
+    return run_async_reads(ASYNC_IO_BACKEND_THREAD_POOL);
+}
+
+// Test async reads through io_uring
+u8 test_async_io_uring() {
+    return run_async_reads(ASYNC_IO_BACKEND_IO_URING);
+}
+
+// Register all async I/O tests
+void async_io_register_tests() {
+    test_manager_register_test(test_async_io_thread_pool, "Async I/O reads files with the thread pool");
+    test_manager_register_test(test_async_io_uring, "Async I/O reads files with io_uring");
+}
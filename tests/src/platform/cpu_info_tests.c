@@ -0,0 +1,47 @@
+#include "cpu_info_tests.h"
+
+#include <platform/cpu_info.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+// Test that the cpu information is consistent with itself and with the compiler target
+u8 test_cpu_info_query() {
+    const platform_cpu_info* info = platform_get_cpu_info();
+    expect_to_be_true(info != 0);
+    // cached after the first query
+    expect_to_be_true(info == platform_get_cpu_info());
+
+    expect_to_be_true(info->logical_core_count >= 1);
+    expect_to_be_true(info->physical_core_count >= 1);
+    expect_to_be_true(info->physical_core_count <= info->logical_core_count);
+    expect_to_be_true(info->package_count >= 1);
+    expect_to_be_true(info->numa_node_count >= 1);
+    expect_to_be_true(info->cache_line_size >= 16);
+    if (info->l2_cache_size && info->l1_data_cache_size) {
+        expect_to_be_true(info->l2_cache_size >= info->l1_data_cache_size);
+    }
+
+#if defined(__SSE2__)
+    // the engine itself was compiled for these
+    expect_to_be_true(platform_cpu_has(CPU_FEATURE_SSE2));
+#endif
+#if defined(__AVX2__)
+    expect_to_be_true(platform_cpu_has(CPU_FEATURE_AVX | CPU_FEATURE_AVX2));
+#endif
+    // wider extensions imply the narrower ones
+    if (platform_cpu_has(CPU_FEATURE_AVX2)) {
+        expect_to_be_true(platform_cpu_has(CPU_FEATURE_AVX));
+    }
+    if (platform_cpu_has(CPU_FEATURE_AVX512F)) {
+        expect_to_be_true(platform_cpu_has(CPU_FEATURE_AVX));
+    }
+    expect_to_be_true(platform_cpu_has(0));
+
+    platform_cpu_info_log();
+    return true;
+}
+
+// Register all cpu information tests
+void cpu_info_register_tests() {
+    test_manager_register_test(test_cpu_info_query, "CPU features and topology query");
+}
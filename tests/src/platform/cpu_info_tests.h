@@ -0,0 +1,3 @@
+#pragma once
+
+void cpu_info_register_tests();
@@ -0,0 +1,111 @@
+#include "filesystem_tests.h"
+
+#include <platform/filesystem.h>
+#include <core/cmemory.h>
+#include <core/cstring.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+static b8 write_test_file(const char* path, const void* data, u64 size) {
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, true, &file)) {
+        return false;
+    }
+    u64 written = 0;
+    b8 result = size == 0 || filesystem_write(&file, size, data, &written);
+    filesystem_close(&file);
+    return result;
+}
+
+// Test that a mapped file exposes the same bytes as the file
+u8 test_filesystem_map() {
+    const char* path = "filesystem_map_test.bin";
+    u8 content[300];
+    for (u32 i = 0; i < sizeof(content); ++i) {
+        content[i] = (u8)(i * 7);
+    }
+    expect_to_be_true(write_test_file(path, content, sizeof(content)));
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(path, FILE_MAP_HINT_SEQUENTIAL, FILE_MAP_FLAG_POPULATE, &mapping));
+    expect_to_be_true(mapping.is_valid);
+    expect_should_be(sizeof(content), mapping.size);
+    const u8* data = mapping.data;
+    for (u32 i = 0; i < sizeof(content); ++i) {
+        expect_should_be(content[i], data[i]);
+    }
+
+    expect_to_be_true(filesystem_map_advise(&mapping, FILE_MAP_HINT_DONTNEED));
+    // dropped pages are read again from the file
+    expect_should_be(content[299], data[299]);
+
+    filesystem_unmap(&mapping);
+    expect_to_be_false(mapping.is_valid);
+    expect_should_be(0, mapping.data);
+
+    remove(path);
+    return true;
+}
+
+// Test that null terminated mappings end with a zero byte, even when the size is a multiple of the page size
+u8 test_filesystem_map_null_terminate() {
+    const char* path = "filesystem_map_test.txt";
+    u64 page_size = sysconf(_SC_PAGESIZE);
+    char* text = callocate(page_size, MEMORY_TAG_STRING);
+    for (u64 i = 0; i < page_size; ++i) {
+        text[i] = 'a' + (i % 26);
+    }
+    expect_to_be_true(write_test_file(path, text, page_size));
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(path, FILE_MAP_HINT_NORMAL, FILE_MAP_FLAG_NULL_TERMINATE, &mapping));
+    expect_should_be(page_size, mapping.size);
+    expect_should_be(page_size, string_length(mapping.data));
+    expect_should_be(0, ((const char*)mapping.data)[page_size]);
+    filesystem_unmap(&mapping);
+
+    // a short file ends in the middle of its page
+    expect_to_be_true(write_test_file(path, "hello", 5));
+    expect_to_be_true(filesystem_map(path, FILE_MAP_HINT_NORMAL, FILE_MAP_FLAG_NULL_TERMINATE, &mapping));
+    expect_to_be_true(string_equals(mapping.data, "hello"));
+    filesystem_unmap(&mapping);
+
+    cfree(text, page_size, MEMORY_TAG_STRING);
+    remove(path);
+    return true;
+}
+
+// Test mapping empty and missing files
+u8 test_filesystem_map_edge_cases() {
+    const char* path = "filesystem_map_empty.txt";
+    expect_to_be_true(write_test_file(path, 0, 0));
+
+    file_mapping mapping;
+    expect_to_be_true(filesystem_map(path, FILE_MAP_HINT_NORMAL, FILE_MAP_FLAG_NONE, &mapping));
+    expect_should_be(0, mapping.size);
+    expect_should_be(0, mapping.data);
+    filesystem_unmap(&mapping);
+
+    // an empty null terminated mapping is still an empty C string
+    expect_to_be_true(filesystem_map(path, FILE_MAP_HINT_NORMAL, FILE_MAP_FLAG_NULL_TERMINATE, &mapping));
+    expect_should_be(0, mapping.size);
+    expect_should_be(0, string_length(mapping.data));
+    filesystem_unmap(&mapping);
+    remove(path);
+
+    expect_to_be_false(filesystem_map("filesystem_map_missing.txt", FILE_MAP_HINT_NORMAL, FILE_MAP_FLAG_NONE, &mapping));
+    expect_to_be_false(mapping.is_valid);
+    // directories can't be mapped
+    expect_to_be_false(filesystem_map(".", FILE_MAP_HINT_NORMAL, FILE_MAP_FLAG_NONE, &mapping));
+    return true;
+}
+
+// Register all filesystem tests
+void filesystem_register_tests() {
+    test_manager_register_test(test_filesystem_map, "Filesystem maps a file read-only");
+    test_manager_register_test(test_filesystem_map_null_terminate, "Filesystem null terminates mapped text");
+    test_manager_register_test(test_filesystem_map_edge_cases, "Filesystem maps empty files and rejects missing ones");
+}
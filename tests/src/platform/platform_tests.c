@@ -0,0 +1,69 @@
+#include "platform_tests.h"
+
+#include <platform/platform.h>
+#include <core/event.h>
+#include <core/cmemory.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+static u16 resized_width;
+static u16 resized_height;
+static u32 resize_count;
+
+static b8 on_resized(u16 code, void* sender, void* listener_inst, event_context context) {
+    resized_width = context.data.u16[0];
+    resized_height = context.data.u16[1];
+    resize_count++;
+    return false;
+}
+
+// Test that the headless platform runs without an X server and fires synthetic resizes
+u8 test_platform_headless() {
+    u64 event_state_size;
+    initialize_event(&event_state_size, 0);
+    void* event_state = callocate(event_state_size, MEMORY_TAG_APPLICATION);
+    initialize_event(&event_state_size, event_state);
+    event_register(EVENT_CODE_WINDOW_RESIZE, 0, on_resized);
+    resize_count = 0;
+
+    platform_system_config config = {PLATFORM_BACKEND_HEADLESS};
+    u64 platform_state_size;
+    initialize_platform(&platform_state_size, 0, config);
+    void* platform_memory = callocate(platform_state_size, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(initialize_platform(&platform_state_size, platform_memory, config));
+    expect_to_be_true(platform_is_headless());
+
+    platform_state state = {0};
+    state.window_title = "headless";
+    state.width = 320;
+    state.height = 200;
+    expect_to_be_true(create_window(&state));
+
+    // the initial size arrives like the first configure notify of a window
+    expect_to_be_true(platform_pump_messages(&state));
+    expect_should_be(1, resize_count);
+    expect_should_be(320, resized_width);
+    expect_should_be(200, resized_height);
+
+    // nothing else happens until a resize is requested
+    expect_to_be_true(platform_pump_messages(&state));
+    expect_should_be(1, resize_count);
+    platform_headless_resize(640, 480);
+    expect_to_be_true(platform_pump_messages(&state));
+    expect_should_be(2, resize_count);
+    expect_should_be(640, resized_width);
+
+    shutdown_platform();
+    cfree(platform_memory, platform_state_size, MEMORY_TAG_APPLICATION);
+    // nothing reads the freed state after the shutdown
+    expect_to_be_false(platform_is_headless());
+    event_unregister(EVENT_CODE_WINDOW_RESIZE, 0, on_resized);
+    event_shutdown();
+    cfree(event_state, event_state_size, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+// Register all platform tests
+void platform_register_tests() {
+    test_manager_register_test(test_platform_headless, "Headless platform pumps synthetic resizes");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void platform_register_tests();
@@ -0,0 +1,96 @@
+#include "loader_tests.h"
+
+#include <systems/resource_system.h>
+#include <platform/filesystem.h>
+#include <core/cmemory.h>
+#include <core/cstring.h>
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+// Test that the text and binary loaders return views into mapped files
+u8 test_loader_mapped_views() {
+    mkdir("loader_test_assets", 0755);
+    mkdir("loader_test_assets/text", 0755);
+    file_handle file;
+    expect_to_be_true(filesystem_open("loader_test_assets/text/sample.txt", FILE_MODE_WRITE, false, &file));
+    expect_to_be_true(filesystem_write_line(&file, "mapped text"));
+    filesystem_close(&file);
+
+    resource_system_config config = {32, "loader_test_assets"};
+    u64 state_size;
+    resource_system_initialize(&state_size, 0, config);
+    void* state = callocate(state_size, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(resource_system_initialize(&state_size, state, config));
+
+    resource text;
+    expect_to_be_true(resource_system_load("sample", RESOURCE_TYPE_TEXT, &text));
+    expect_to_be_true(text.mapping.is_valid);
+    expect_should_be(text.mapping.data, text.data);
+    expect_should_be(12, text.data_size);
+    expect_to_be_true(string_equals(text.data, "mapped text\n"));
+    resource_system_unload(&text);
+    expect_to_be_false(text.mapping.is_valid);
+    expect_should_be(0, text.data);
+
+    resource binary;
+    expect_to_be_true(resource_system_load("text/sample.txt", RESOURCE_TYPE_BINARY, &binary));
+    expect_to_be_true(binary.mapping.is_valid);
+    expect_should_be(12, binary.data_size);
+    expect_should_be('m', ((const u8*)binary.data)[0]);
+    resource_system_unload(&binary);
+    expect_to_be_false(binary.mapping.is_valid);
+
+    resource_system_shutdown(state);
+    cfree(state, state_size, MEMORY_TAG_APPLICATION);
+    remove("loader_test_assets/text/sample.txt");
+    remove("loader_test_assets/text");
+    remove("loader_test_assets");
+    return true;
+}
+
+// Test that the material loader parses a configuration through the text reader
+u8 test_loader_material() {
+    mkdir("loader_test_assets", 0755);
+    mkdir("loader_test_assets/materials", 0755);
+    file_handle file;
+    expect_to_be_true(filesystem_open("loader_test_assets/materials/sample.cmat", FILE_MODE_WRITE, false, &file));
+    expect_to_be_true(filesystem_write_line(&file, "# comment"));
+    expect_to_be_true(filesystem_write_line(&file, "version = 0.1"));
+    expect_to_be_true(filesystem_write_line(&file, ""));
+    expect_to_be_true(filesystem_write_line(&file, "  name = sample_material  "));
+    expect_to_be_true(filesystem_write_line(&file, "this line is invalid"));
+    expect_to_be_true(filesystem_write_line(&file, "diffuse_map_name=paving\r"));
+    expect_to_be_true(filesystem_write_line(&file, "diffuse_color = 1.0 0.5 0.25 1.0"));
+    filesystem_close(&file);
+
+    resource_system_config config = {32, "loader_test_assets"};
+    u64 state_size;
+    resource_system_initialize(&state_size, 0, config);
+    void* state = callocate(state_size, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(resource_system_initialize(&state_size, state, config));
+
+    resource material;
+    expect_to_be_true(resource_system_load("sample", RESOURCE_TYPE_MATERIAL, &material));
+    material_config* material_data = material.data;
+    expect_to_be_true(string_equals(material_data->name, "sample_material"));
+    expect_to_be_true(string_equals(material_data->diffuse_map_name, "paving"));
+    expect_float_to_be(0.5f, material_data->diffuse_color.y);
+    expect_float_to_be(0.25f, material_data->diffuse_color.z);
+    resource_system_unload(&material);
+
+    resource_system_shutdown(state);
+    cfree(state, state_size, MEMORY_TAG_APPLICATION);
+    remove("loader_test_assets/materials/sample.cmat");
+    remove("loader_test_assets/materials");
+    remove("loader_test_assets");
+    return true;
+}
+
+// Register all resource loader tests
+void loader_register_tests() {
+    test_manager_register_test(test_loader_mapped_views, "Text and binary loaders return mapped views");
+    test_manager_register_test(test_loader_material, "Material loader parses a configuration file");
+}
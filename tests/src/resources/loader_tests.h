@@ -0,0 +1,3 @@
+#pragma once
+
+void loader_register_tests();
@@ -0,0 +1,56 @@
+#include <stdio.h>
+
+#include <core/cmemory.h>
+#include <core/logger_binary.h>
+#include <platform/filesystem.h>
+
+static const char* level_strings[6] = {"[FATAL]", "[ERROR]", "[WARN]", "[INFO]", "[DEBUG]", "[TRACE]"};
+
+static void on_line(log_level level, f64 time, const char* text, u64 length, void* user_data) {
+    FILE* out = user_data;
+    const char* level_string = level <= LOG_LEVEL_TRACE ? level_strings[level] : "[?]";
+    fprintf(out, "%12.6f %s %s\n", time, level_string, text);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <binary log> [output text file]\n", argv[0]);
+        return 1;
+    }
+
+    file_handle input;
+    if (!filesystem_open(argv[1], FILE_MODE_READ, true, &input)) {
+        fprintf(stderr, "Failed to open '%s'\n", argv[1]);
+        return 1;
+    }
+    u64 size = 0;
+    filesystem_size(&input, &size);
+    u8* data = callocate(size ? size : 1, MEMORY_TAG_ARRAY);
+    u64 read = 0;
+    if (size && !filesystem_read_all_bytes(&input, data, &read)) {
+        fprintf(stderr, "Failed to read '%s'\n", argv[1]);
+        filesystem_close(&input);
+        return 1;
+    }
+    filesystem_close(&input);
+
+    FILE* out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            fprintf(stderr, "Failed to open '%s' for writing\n", argv[2]);
+            return 1;
+        }
+    }
+
+    b8 result = log_binary_decode(data, size, on_line, out);
+    if (!result) {
+        fprintf(stderr, "'%s' is not a valid binary log or is truncated\n", argv[1]);
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    cfree(data, size ? size : 1, MEMORY_TAG_ARRAY);
+    return result ? 0 : 1;
+}